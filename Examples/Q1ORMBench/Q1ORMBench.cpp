@@ -0,0 +1,291 @@
+#include "Q1ORMBench.h"
+
+#include <typeinfo>
+#include <QDate>
+#include <QDateTime>
+#include <QBuffer>
+#include <QJsonDocument>
+#include <QtTest/QtTest>
+
+#include <Q1Core/Q1Migration/Q1MigrationQuery.h>
+#include <Q1Core/Q1Query/Q1Query.h>
+
+Q1ORMBench::Q1ORMBench()
+    : cities(nullptr),
+    countries(nullptr)
+{
+}
+
+void Q1ORMBench::initTestCase()
+{
+    CityMap::ConfigureEntity(cities);
+    CityMap::CreateRelations(cities);
+    CountryMap::ConfigureEntity(countries);
+    CountryMap::CreateRelations(countries);
+}
+
+// ================= SQL GENERATION =================
+
+void Q1ORMBench::bench_addTableSql_data()
+{
+    QTest::addColumn<int>("dialect");
+
+    QTest::newRow("PostgreSQL") << static_cast<int>(DatabaseType::PostgreSQL);
+    QTest::newRow("SQLServer") << static_cast<int>(DatabaseType::SQLServer);
+}
+
+void Q1ORMBench::bench_addTableSql()
+{
+    QFETCH(int, dialect);
+
+    Q1MigrationQuery query(static_cast<DatabaseType>(dialect));
+    Q1Table table = cities.GetTable();
+
+    QString sql;
+    QBENCHMARK
+    {
+        sql = query.AddTableSQL(table);
+    }
+
+    QVERIFY(sql.contains("cities"));
+}
+
+void Q1ORMBench::bench_selectSql()
+{
+    QString sql;
+    QBENCHMARK
+    {
+        sql = cities.Select({"id", "name"})
+                  .InnerJoin("countries", "cities.country_id = countries.id")
+                  .Where("countries.name = 'Canada'")
+                  .OrderBy("name")
+                  .Limit(50)
+                  .ToSql();
+    }
+
+    QVERIFY(sql.startsWith("SELECT"));
+}
+
+void Q1ORMBench::bench_getVariableType()
+{
+    const QList<QString> types = {
+        typeid(int).name(), typeid(qint64).name(), typeid(double).name(), typeid(bool).name(),
+        typeid(QString).name(), typeid(QDate).name(), typeid(QDateTime).name()
+    };
+
+    int checksum = 0;
+    QBENCHMARK
+    {
+        for (const QString& type : types)
+        {
+            checksum += Q1Column::GetVariableType(type);
+        }
+    }
+
+    QVERIFY(checksum > 0);
+}
+
+// ================= HYDRATION AND JSON =================
+
+void Q1ORMBench::bench_jsonToEntity_data()
+{
+    QTest::addColumn<int>("rows");
+
+    QTest::newRow("100") << 100;
+    QTest::newRow("10000") << 10000;
+}
+
+void Q1ORMBench::bench_jsonToEntity()
+{
+    QFETCH(int, rows);
+
+    const QJsonArray json = CityRows(rows, 10);
+
+    QList<City> result;
+    QBENCHMARK
+    {
+        result.clear();
+        result.reserve(json.size());
+        for (const QJsonValue& row : json)
+        {
+            result.append(cities.JsonToEntity(row.toObject()));
+        }
+    }
+
+    QCOMPARE(result.size(), rows);
+}
+
+void Q1ORMBench::bench_entityToJson_data()
+{
+    bench_jsonToEntity_data();
+}
+
+void Q1ORMBench::bench_entityToJson()
+{
+    QFETCH(int, rows);
+
+    QList<City> entities;
+    for (const QJsonValue& row : CityRows(rows, 10))
+    {
+        entities.append(cities.JsonToEntity(row.toObject()));
+    }
+
+    QByteArray json;
+    QBENCHMARK
+    {
+        QJsonArray array;
+        for (const City& city : entities)
+        {
+            array.append(cities.EntityToJson(city));
+        }
+        json = QJsonDocument(array).toJson(QJsonDocument::Compact);
+    }
+
+    QVERIFY(!json.isEmpty());
+}
+
+void Q1ORMBench::bench_stitchRelation_data()
+{
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("related");
+
+    QTest::newRow("100x10") << 100 << 10;
+    QTest::newRow("10000x1000") << 10000 << 1000;
+}
+
+void Q1ORMBench::bench_stitchRelation()
+{
+    QFETCH(int, rows);
+    QFETCH(int, related);
+
+    const QJsonArray cityRows = CityRows(rows, related);
+    const QList<QJsonObject> countryRows = CountryRows(related);
+
+    QJsonArray result;
+    QBENCHMARK
+    {
+        result = Q1Query<City>::StitchRelation(cityRows, "countries", "country_id", "id", countryRows);
+    }
+
+    QCOMPARE(result.size(), rows);
+    QCOMPARE(result[0].toObject().value("countries").toArray().size(), 1);
+}
+
+// ================= MOCK DRIVER =================
+
+void Q1ORMBench::bench_selectHydration_data()
+{
+    bench_jsonToEntity_data();
+}
+
+void Q1ORMBench::bench_selectHydration()
+{
+    QFETCH(int, rows);
+
+    auto server = QSharedPointer<Q1MockServer>::create();
+    server->SetLogLimit(0);
+    server->When("^SELECT", GeneratedCities(rows));
+
+    Q1Connection connection(POSTGRE_SQL, Q1MockDriver::Factory(server));
+    Q1Entity<City> mockCities(&connection);
+    CityMap::ConfigureEntity(mockCities);
+
+    QList<City> result;
+    QBENCHMARK
+    {
+        result = mockCities.Select().ToList();
+    }
+
+    QCOMPARE(result.size(), rows);
+}
+
+void Q1ORMBench::bench_writeJson_data()
+{
+    bench_jsonToEntity_data();
+}
+
+void Q1ORMBench::bench_writeJson()
+{
+    QFETCH(int, rows);
+
+    auto server = QSharedPointer<Q1MockServer>::create();
+    server->SetLogLimit(0);
+    server->When("^SELECT", GeneratedCities(rows));
+
+    Q1Connection connection(POSTGRE_SQL, Q1MockDriver::Factory(server));
+    Q1Entity<City> mockCities(&connection);
+    CityMap::ConfigureEntity(mockCities);
+
+    QByteArray json;
+    QBENCHMARK
+    {
+        QBuffer buffer(&json);
+        buffer.open(QIODevice::WriteOnly | QIODevice::Truncate);
+        mockCities.Select().WriteJson(&buffer);
+    }
+
+    QVERIFY(json.startsWith("[{"));
+}
+
+void Q1ORMBench::bench_insert()
+{
+    auto server = QSharedPointer<Q1MockServer>::create();
+    server->SetLogLimit(0);
+    server->When("^INSERT", Q1MockResultSet::Rows({"id"}, {{1}}));
+
+    Q1Connection connection(POSTGRE_SQL, Q1MockDriver::Factory(server));
+    Q1Entity<City> mockCities(&connection);
+    CityMap::ConfigureEntity(mockCities);
+
+    City city;
+    city.name = "Bench City";
+    city.country_id = 1;
+
+    QBENCHMARK
+    {
+        mockCities.Insert(city);
+    }
+
+    QCOMPARE(city.id, 1);
+}
+
+// ================= DATA =================
+
+QJsonArray Q1ORMBench::CityRows(int count, int countries)
+{
+    QJsonArray rows;
+    for (int i = 0; i < count; ++i)
+    {
+        QJsonObject row;
+        row.insert("id", i + 1);
+        row.insert("name", QString("City %1").arg(i + 1));
+        row.insert("country_id", i % countries + 1);
+        rows.append(row);
+    }
+    return rows;
+}
+
+QList<QJsonObject> Q1ORMBench::CountryRows(int count)
+{
+    QList<QJsonObject> rows;
+    for (int i = 0; i < count; ++i)
+    {
+        QJsonObject row;
+        row.insert("id", i + 1);
+        row.insert("name", QString("Country %1").arg(i + 1));
+        rows.append(row);
+    }
+    return rows;
+}
+
+Q1MockResultSet Q1ORMBench::GeneratedCities(int count)
+{
+    return Q1MockResultSet::Generated({"id", "name", "country_id"}, count, [](int row, int column) -> QVariant {
+        switch (column)
+        {
+        case 0: return row + 1;
+        case 1: return QString("City %1").arg(row + 1);
+        default: return row % 10 + 1;
+        }
+    });
+}
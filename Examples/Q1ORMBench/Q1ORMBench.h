@@ -0,0 +1,55 @@
+#ifndef Q1ORMBENCH_H
+#define Q1ORMBENCH_H
+
+#include <QObject>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QList>
+
+#include "SoloExample/Mapping/CityMap.h"
+#include "SoloExample/Mapping/CountryMap.h"
+
+#include <Q1Core/Q1Mock/Q1MockDriver.h>
+
+// Hot paths of the ORM layer, measured with QBENCHMARK and no database server.
+class Q1ORMBench : public QObject
+{
+    Q_OBJECT
+
+public:
+    Q1ORMBench();
+
+private slots:
+    void initTestCase();
+
+    // SQL generation
+    void bench_addTableSql_data();
+    void bench_addTableSql();
+    void bench_selectSql();
+    void bench_getVariableType();
+
+    // Hydration and JSON
+    void bench_jsonToEntity_data();
+    void bench_jsonToEntity();
+    void bench_entityToJson_data();
+    void bench_entityToJson();
+    void bench_stitchRelation_data();
+    void bench_stitchRelation();
+
+    // Through Q1MockDriver
+    void bench_selectHydration_data();
+    void bench_selectHydration();
+    void bench_writeJson_data();
+    void bench_writeJson();
+    void bench_insert();
+
+private:
+    static QJsonArray CityRows(int count, int countries);
+    static QList<QJsonObject> CountryRows(int count);
+    static Q1MockResultSet GeneratedCities(int count);
+
+    Q1Entity<City> cities;
+    Q1Entity<Country> countries;
+};
+
+#endif // Q1ORMBENCH_H
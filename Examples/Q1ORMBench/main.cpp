@@ -0,0 +1,16 @@
+#include <QCoreApplication>
+#include <QLoggingCategory>
+#include <QtTest/QtTest>
+
+#include "Q1ORMBench.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    // The ORM logs every statement with qDebug; keep that out of the measurements
+    QLoggingCategory::setFilterRules("default.debug=false");
+
+    Q1ORMBench bench;
+    return QTest::qExec(&bench, argc, argv);
+}
@@ -30,10 +30,12 @@ public:
 
     T SelectById(int id) override
     {
-        Q1Query<T> query(&entity);
-        QList<T> list = query.Where(QString("id=%1").arg(id)).ToList();
-        if (!list.isEmpty()) return list.first();
-        return T{};
+        return entity.FindById(id);
+    }
+
+    QList<T> SelectByIds(const QList<int>& ids, QList<int>* missing = nullptr)
+    {
+        return entity.FindMany(ids, missing);
     }
 
     QList<T> SelectAll() override
@@ -22,6 +22,9 @@ int ReadEnvInt(const char* name, int fallback)
 Q1Driver ReadDriver()
 {
     const QString driver = ReadEnv("Q1ORM_DB_DRIVER", "postgres").toLower();
+    if (driver.contains("sqlite"))
+        return Q1Driver::SQLITE;
+
     return driver.contains("sqlserver") || driver.contains("mssql") || driver.contains("odbc")
                ? Q1Driver::SQLSERVER
                : Q1Driver::POSTGRE_SQL;
@@ -29,6 +32,9 @@ Q1Driver ReadDriver()
 
 int DefaultPort(Q1Driver driver)
 {
+    if (driver == Q1Driver::SQLITE)
+        return 0;
+
     return driver == Q1Driver::SQLSERVER ? 1433 : 5432;
 }
 }
@@ -0,0 +1,656 @@
+#include "MockDriverTests.h"
+
+#include <QTemporaryDir>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtTest/QtTest>
+
+#include <Q1Core/Q1Context/Q1ViewRefresher.h>
+#include <Q1Core/Q1Diagnostics/Q1Metrics.h>
+#include <Q1Core/Q1Diagnostics/Q1QueryCounter.h>
+#include <Q1Core/Q1Migration/Q1Migration.h>
+#include <Q1Core/Q1Mock/Q1MockDriver.h>
+#include <Q1Core/Q1Query/Q1Batch.h>
+#include "SoloExample/Mapping/CityMap.h"
+#include "SoloExample/Mapping/CountryMap.h"
+
+namespace
+{
+QList<QVariantList> CityRows()
+{
+    return {
+        {1, "New York", 1},
+        {2, "Los Angeles", 1},
+        {3, "Toronto", 2}
+    };
+}
+}
+
+void MockDriverTests::test_selectHydratesMockRows()
+{
+    auto server = QSharedPointer<Q1MockServer>::create();
+    server->When("^SELECT .* FROM \"cities\"", Q1MockResultSet::Rows({"id", "name", "country_id"}, CityRows()));
+
+    Q1Connection connection(POSTGRE_SQL, Q1MockDriver::Factory(server));
+    Q1Entity<City> cities(&connection);
+    CityMap::ConfigureEntity(cities);
+
+    QList<City> result = cities.Select().Where("country_id = 1").ToList();
+
+    QCOMPARE(result.size(), 3);
+    QCOMPARE(result[1].id, 2);
+    QCOMPARE(result[1].name, QString("Los Angeles"));
+    QCOMPARE(result[2].country_id, 2);
+
+    QCOMPARE(server->ExecutedSql(), QStringList({"SELECT * FROM \"cities\" WHERE country_id = 1"}));
+}
+
+void MockDriverTests::test_generatedResultSet()
+{
+    auto server = QSharedPointer<Q1MockServer>::create();
+    server->When("^SELECT", Q1MockResultSet::Generated({"id", "name", "country_id"}, 10000, [](int row, int column) -> QVariant {
+        switch (column)
+        {
+        case 0: return row + 1;
+        case 1: return QString("City %1").arg(row + 1);
+        default: return row % 10 + 1;
+        }
+    }));
+
+    Q1Connection connection(POSTGRE_SQL, Q1MockDriver::Factory(server));
+    Q1Entity<City> cities(&connection);
+    CityMap::ConfigureEntity(cities);
+
+    QList<City> result = cities.Select().ToList();
+
+    QCOMPARE(result.size(), 10000);
+    QCOMPARE(result.last().id, 10000);
+    QCOMPARE(result.last().name, QString("City 10000"));
+}
+
+void MockDriverTests::test_insertRecordsSqlAndBinds()
+{
+    auto server = QSharedPointer<Q1MockServer>::create();
+    server->When("^INSERT INTO \"cities\"", Q1MockResultSet::Rows({"id"}, {{42}}));
+
+    Q1Connection connection(POSTGRE_SQL, Q1MockDriver::Factory(server));
+    connection.SetSlowQueryThreshold(0);
+    Q1Entity<City> cities(&connection);
+    CityMap::ConfigureEntity(cities);
+
+    City city;
+    city.name = "Vancouver";
+    city.country_id = 2;
+
+    QVERIFY(cities.Insert(city));
+    QCOMPARE(city.id, 42);
+
+    const QList<Q1MockStatement> executed = server->Executed();
+    QCOMPARE(executed.size(), 1);
+    QVERIFY(executed[0].sql.endsWith("RETURNING \"id\""));
+    QCOMPARE(executed[0].binds, QVariantList({QString("Vancouver"), 2}));
+
+    // The statement's metrics carry the same binds, as Update() and raw statements do
+    QCOMPARE(connection.GetSlowQueryLog()->Last().metrics.binds, executed[0].binds);
+}
+
+void MockDriverTests::test_upsertRangeStaysBelowBindLimit()
+{
+    auto server = QSharedPointer<Q1MockServer>::create();
+    Q1Connection connection(SQLITE, Q1MockDriver::Factory(server));
+    Q1Entity<City> cities(&connection);
+    CityMap::ConfigureEntity(cities);
+
+    QList<City> rows;
+    for (int i = 0; i < 1000; ++i)
+    {
+        City city;
+        city.name = QString("City %1").arg(i);
+        city.country_id = i % 10 + 1;
+        rows.append(city);
+    }
+
+    QVERIFY(cities.UpsertRange(rows, {"name"}));
+
+    // SQLite builds without SQLITE_MAX_VARIABLE_NUMBER raised accept 999 bind values
+    int statements = 0;
+    int bound = 0;
+    for (const Q1MockStatement& statement : server->Executed())
+    {
+        if (!statement.sql.startsWith("INSERT"))
+            continue;
+
+        ++statements;
+        bound += statement.binds.size();
+        QVERIFY(statement.binds.size() <= 999);
+    }
+    QCOMPARE(statements, 3);
+    QCOMPARE(bound, 2000);
+}
+
+void MockDriverTests::test_setBasedDeleteMatchesWholeKey()
+{
+    auto server = QSharedPointer<Q1MockServer>::create();
+    Q1Connection connection(POSTGRE_SQL, Q1MockDriver::Factory(server));
+    Q1Entity<City> cities(&connection);
+    CityMap::ConfigureEntity(cities);
+
+    cities.Select().Where("name = 'x'").InnerJoin("\"countries\"", "\"countries\".id = \"cities\".country_id").ExecuteDelete();
+    QCOMPARE(server->ExecutedSql().last(),
+             QString("DELETE FROM \"cities\" WHERE \"id\" IN (SELECT \"cities\".\"id\" FROM \"cities\" "
+                     "INNER JOIN \"countries\" ON \"countries\".id = \"cities\".country_id WHERE name = 'x')"));
+
+    // Every key column takes part, and the subquery is ordered only with a limit
+    Q1Entity<City> keyed(&connection);
+    keyed.ToTableName("cities");
+    keyed.Property(keyed.id, "id", false, true);
+    keyed.Property(keyed.country_id, "country_id", false, true);
+    keyed.Select().Where("name = 'x'").OrderBy("name").Limit(10).ExecuteDelete();
+    const QString sql = server->ExecutedSql().last();
+    QVERIFY(sql.startsWith("DELETE FROM \"cities\" WHERE EXISTS (SELECT 1 FROM (SELECT \"cities\".\"id\", \"cities\".\"country_id\" FROM"));
+    QVERIFY(sql.contains("ORDER BY name LIMIT 10) AS q1_target"));
+    QVERIFY(sql.endsWith("q1_target.\"id\" = \"cities\".\"id\" AND q1_target.\"country_id\" = \"cities\".\"country_id\")"));
+}
+
+void MockDriverTests::test_sqlServerDialect()
+{
+    auto server = QSharedPointer<Q1MockServer>::create();
+
+    Q1Connection connection(SQLSERVER, Q1MockDriver::Factory(server));
+    Q1Entity<City> cities(&connection);
+    CityMap::ConfigureEntity(cities);
+
+    cities.Select().OrderBy("name").Limit(5).ToList();
+
+    QCOMPARE(server->ExecutedSql(), QStringList({"SELECT TOP 5 * FROM [cities] ORDER BY name"}));
+}
+
+void MockDriverTests::test_statementError()
+{
+    auto server = QSharedPointer<Q1MockServer>::create();
+    server->When("^DELETE", Q1MockResultSet::Error("permission denied"));
+
+    Q1Connection connection(POSTGRE_SQL, Q1MockDriver::Factory(server));
+    Q1Entity<City> cities(&connection);
+    CityMap::ConfigureEntity(cities);
+
+    QVERIFY(!cities.Delete("id = 1"));
+    QVERIFY(cities.GetLastError().contains("permission denied"));
+
+    // A failed async insert resolves to no entity rather than one with id 0
+    server->When("^INSERT", Q1MockResultSet::Error("permission denied"));
+    City city;
+    city.name = "Vancouver";
+    QVERIFY(!cities.InsertAsync(city).result().has_value());
+
+    // The pool thread's error comes back with the value instead of an empty list
+    server->When("^SELECT", Q1MockResultSet::Error("permission denied"));
+    const Q1AsyncResult<QList<City>> rows = cities.Select().ToListAsync().result();
+    QVERIFY(rows.value.isEmpty());
+    QVERIFY(rows.error.contains("permission denied"));
+    QVERIFY(cities.Select().CountAsync().result().error.contains("permission denied"));
+}
+
+void MockDriverTests::test_connectionReleasesItsName()
+{
+    auto server = QSharedPointer<Q1MockServer>::create();
+    QString name;
+    {
+        Q1Connection connection(POSTGRE_SQL, Q1MockDriver::Factory(server));
+        name = connection.GetConnectionName();
+        {
+            // Q1Migration keeps a copy like this one
+            Q1Connection copy = connection;
+        }
+        QVERIFY(QSqlDatabase::contains(name));
+    }
+
+    // Pool-thread clones and replicas are connections too; none may stay registered
+    QVERIFY(!QSqlDatabase::contains(name));
+    QVERIFY(!QSqlDatabase::contains("root-" + name));
+
+    // Replicas built on the first read go with their primary
+    const int registered = QSqlDatabase::connectionNames().size();
+    {
+        Q1Connection connection(POSTGRE_SQL, Q1MockDriver::Factory(server));
+        connection.AddReplica(Q1MockDriver::Factory(server));
+        Q1Entity<City> cities(&connection);
+        CityMap::ConfigureEntity(cities);
+        cities.Select().ToList();
+    }
+    QCOMPARE(QSqlDatabase::connectionNames().size(), registered);
+}
+
+void MockDriverTests::test_instrumentationAggregatesStatements()
+{
+    auto server = QSharedPointer<Q1MockServer>::create();
+    server->When("^SELECT", Q1MockResultSet::Rows({"id", "name", "country_id"}, CityRows()));
+    server->When("^DELETE", Q1MockResultSet::Error("permission denied"));
+
+    Q1Metrics metrics;
+    Q1Connection connection(POSTGRE_SQL, Q1MockDriver::Factory(server));
+    connection.AddInstrumentation(&metrics);
+    Q1Entity<City> cities(&connection);
+    CityMap::ConfigureEntity(cities);
+
+    cities.Select().ToList();
+    cities.Delete("id = 1");
+
+    QCOMPARE(metrics.Statements(), qint64(2));
+    QCOMPARE(metrics.Failures(), qint64(1));
+    QCOMPARE(metrics.Rows().Sum(), qint64(3));
+    QCOMPARE(metrics.Total().Count(), qint64(2));
+    QCOMPARE(metrics.SqlBytes(), qint64(QByteArray("SELECT * FROM \"cities\"").size() +
+                                        QByteArray("DELETE FROM \"cities\" WHERE id = 1").size()));
+    QVERIFY(metrics.Total().Percentile(100) >= metrics.Total().Percentile(50));
+
+    connection.RemoveInstrumentation(&metrics);
+    cities.Select().ToList();
+    QCOMPARE(metrics.Statements(), qint64(2));
+}
+
+void MockDriverTests::test_slowQueryLogCapturesPlan()
+{
+    auto server = QSharedPointer<Q1MockServer>::create();
+    server->When("^SELECT", Q1MockResultSet::Rows({"id", "name", "country_id"}, CityRows()));
+    server->When("^EXPLAIN \\(FORMAT JSON\\)", Q1MockResultSet::Rows({"QUERY PLAN"}, {{"[{\"Plan\": {\"Node Type\": \"Seq Scan\"}}]"}}));
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("slow.jsonl");
+
+    Q1Connection connection(POSTGRE_SQL, Q1MockDriver::Factory(server));
+    connection.SetSlowQueryThreshold(0);
+    connection.SetExplainSlowQueries(true);
+    connection.GetSlowQueryLog()->SetFile(path);
+
+    Q1Entity<City> cities(&connection);
+    CityMap::ConfigureEntity(cities);
+    cities.Select().Where("country_id = 1").ToList();
+
+    const QString sql = "SELECT * FROM \"cities\" WHERE country_id = 1";
+    QCOMPARE(server->ExecutedSql(), QStringList({sql, "EXPLAIN (FORMAT JSON) " + sql}));
+    QCOMPARE(connection.GetSlowQueryLog()->Count(), qint64(1));
+    QCOMPARE(connection.GetSlowQueryLog()->Last().metrics.sql, sql);
+    QVERIFY(connection.GetSlowQueryLog()->Last().plan.contains("Seq Scan"));
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QJsonObject entry = QJsonDocument::fromJson(file.readLine()).object();
+    QCOMPARE(entry.value("sql").toString(), sql);
+    QCOMPARE(entry.value("rows").toInt(), 3);
+    QVERIFY(entry.value("plan").isArray());
+}
+
+void MockDriverTests::test_queryCounterDetectsRepeatedShapes()
+{
+    QCOMPARE(Q1QueryCounter::Fingerprint("SELECT * FROM \"cities\" WHERE id=12 AND name = N'O''Hare'"),
+             QString("SELECT * FROM \"cities\" WHERE id=? AND name = ?"));
+    QCOMPARE(Q1QueryCounter::Fingerprint("SELECT  *\nFROM t WHERE id IN (1, 2,3) AND v::int > $1"),
+             QString("SELECT * FROM t WHERE id IN (...) AND v::int > ?"));
+
+    auto server = QSharedPointer<Q1MockServer>::create();
+    server->When("^SELECT", Q1MockResultSet::Rows({"id", "name", "country_id"}, CityRows()));
+
+    Q1QueryCounter counter(3);
+    Q1Connection connection(POSTGRE_SQL, Q1MockDriver::Factory(server));
+    connection.AddInstrumentation(&counter);
+    Q1Entity<City> cities(&connection);
+    CityMap::ConfigureEntity(cities);
+
+    // Outside a scope nothing is counted
+    for (int id = 1; id <= 5; ++id)
+        cities.Select().Where(QString("id=%1").arg(id)).ToList();
+    QVERIFY(counter.Violations().isEmpty());
+
+    {
+        Q1QueryScope scope(&counter, "load cities");
+        for (int id = 1; id <= 6; ++id)
+            cities.Select().Where(QString("id=%1").arg(id)).ToList();
+        cities.Select().ToList();
+        QCOMPARE(counter.ScopeStatements(), 7);
+    }
+
+    QCOMPARE(counter.ScopeStatements(), 0);
+    QCOMPARE(counter.Violations().size(), 1);
+
+    const Q1RepeatedQuery repeated = counter.Violations().first();
+    QCOMPARE(repeated.scope, QString("load cities"));
+    QCOMPARE(repeated.operation, QString("select"));
+    QCOMPARE(repeated.count, 4);
+    QCOMPARE(repeated.fingerprint, QString("SELECT * FROM \"cities\" WHERE id=?"));
+    QVERIFY(repeated.suggestion.contains("id IN (...)"));
+}
+
+void MockDriverTests::test_queryCounterFollowsAsyncCalls()
+{
+    auto server = QSharedPointer<Q1MockServer>::create();
+    server->When("^SELECT", Q1MockResultSet::Rows({"id", "name", "country_id"}, CityRows()));
+
+    Q1QueryCounter* counter = new Q1QueryCounter(3);
+    Q1Connection connection(POSTGRE_SQL, Q1MockDriver::Factory(server));
+    connection.AddInstrumentation(counter);
+    Q1Entity<City> cities(&connection);
+    CityMap::ConfigureEntity(cities);
+
+    // Pool-thread statements count in the scope of the thread that started them
+    {
+        Q1QueryScope scope(counter, "load cities async");
+        for (int id = 1; id <= 5; ++id)
+            cities.Select().Where(QString("id=%1").arg(id)).ToListAsync().waitForFinished();
+        QCOMPARE(counter->ScopeStatements(), 5);
+    }
+    QCOMPARE(counter->Violations().size(), 1);
+    QCOMPARE(counter->Violations().first().scope, QString("load cities async"));
+
+    // The pool thread's clone shares the observer list, so a removed counter can be deleted
+    connection.RemoveInstrumentation(counter);
+    delete counter;
+    QVERIFY(cities.Select().ToListAsync().result().Ok());
+}
+
+void MockDriverTests::test_findManyPreservesKeyOrder()
+{
+    auto server = QSharedPointer<Q1MockServer>::create();
+    server->When("^SELECT", Q1MockResultSet::Rows({"id", "name", "country_id"}, CityRows()));
+
+    Q1Connection connection(POSTGRE_SQL, Q1MockDriver::Factory(server));
+    Q1Entity<City> cities(&connection);
+    CityMap::ConfigureEntity(cities);
+
+    QList<int> missing;
+    const QList<City> result = cities.FindMany(QList<int>{3, 9, 1, 3}, &missing);
+
+    QCOMPARE(result.size(), 3);
+    QCOMPARE(result[0].id, 3);
+    QCOMPARE(result[1].id, 1);
+    QCOMPARE(result[2].name, QString("Toronto"));
+    QCOMPARE(missing, QList<int>({9}));
+
+    QCOMPARE(server->ExecutedCount(), 1);
+    const Q1MockStatement statement = server->Executed().first();
+    QCOMPARE(statement.sql, QString("SELECT * FROM \"cities\" WHERE \"id\" IN (?, ?, ?)"));
+    QCOMPARE(statement.binds, QVariantList({3, 9, 1}));
+
+    bool found = true;
+    cities.FindById(42, &found);
+    QVERIFY(!found);
+    QCOMPARE(server->Executed().last().sql, QString("SELECT * FROM \"cities\" WHERE \"id\" = ?"));
+}
+
+void MockDriverTests::test_serverJsonKeepsOrder()
+{
+    auto server = QSharedPointer<Q1MockServer>::create();
+    server->When("json_agg", Q1MockResultSet::Rows({"json"}, {{"[]"}}));
+
+    Q1Connection postgres(POSTGRE_SQL, Q1MockDriver::Factory(server));
+    Q1Entity<Country> countries(&postgres);
+    CountryMap::ConfigureEntity(countries);
+    CountryMap::CreateRelations(countries);
+
+    countries.Select().OrderBy("\"countries\".name DESC").Include("cities").ServerJson().ToJson();
+
+    // The aggregate sorts its rows; the subquery's ORDER BY alone does not survive json_agg
+    const QString sql = server->ExecutedSql().last();
+    QVERIFY(sql.startsWith("SELECT COALESCE(json_agg(\"countries\".* ORDER BY \"countries\".name DESC), '[]'::json)"));
+    QVERIFY(sql.endsWith(") AS \"countries\") AS \"countries\""));
+
+    // Joined tables stay out of the derived table, so json_agg sees each key once
+    server->ClearLog();
+    countries.Select().InnerJoin("\"cities\"", "\"cities\".country_id = \"countries\".id").ServerJson().ToJson();
+    QVERIFY(server->ExecutedSql().last().contains("FROM (SELECT \"countries\".* FROM \"countries\" INNER JOIN \"cities\""));
+
+    // SQL Server reads only the queried table's columns, so a join adds no duplicate names
+    server->ClearLog();
+    Q1Connection sqlServer(SQLSERVER, Q1MockDriver::Factory(server));
+    Q1Entity<City> cities(&sqlServer);
+    CityMap::ConfigureEntity(cities);
+
+    cities.Select().InnerJoin("[countries]", "[countries].[id] = [cities].[country_id]").ServerJson().ToJson();
+    QVERIFY(server->ExecutedSql().last().contains("FROM (SELECT [cities].* FROM [cities] INNER JOIN [countries]"));
+}
+
+void MockDriverTests::test_stitchRelationGroupsRelatedRows()
+{
+    const QJsonArray cities{
+        QJsonObject{{"id", 1}, {"name", "New York"}, {"country_id", 1}},
+        QJsonObject{{"id", 2}, {"name", "Toronto"}, {"country_id", 2}},
+        QJsonObject{{"id", 3}, {"name", "Atlantis"}, {"country_id", 9}}
+    };
+    const QList<QJsonObject> countries{
+        QJsonObject{{"id", 2}, {"name", "Canada"}},
+        QJsonObject{{"id", 1}, {"name", "USA"}},
+        QJsonObject{{"id", 1}, {"name", "USA (duplicate)"}}
+    };
+
+    const QJsonArray result = Q1Query<City>::StitchRelation(cities, "countries", "country_id", "id", countries);
+
+    QCOMPARE(result.size(), 3);
+    QCOMPARE(result[0].toObject().value("name").toString(), QString("New York"));
+
+    // Every match, in the related rows' order
+    const QJsonArray usa = result[0].toObject().value("countries").toArray();
+    QCOMPARE(usa.size(), 2);
+    QCOMPARE(usa[0].toObject().value("name").toString(), QString("USA"));
+    QCOMPARE(usa[1].toObject().value("name").toString(), QString("USA (duplicate)"));
+
+    QCOMPARE(result[1].toObject().value("countries").toArray().size(), 1);
+
+    // Rows without a match still get an empty array
+    QVERIFY(result[2].toObject().value("countries").isArray());
+    QVERIFY(result[2].toObject().value("countries").toArray().isEmpty());
+}
+
+void MockDriverTests::test_schemaSnapshotReadsCatalogOnce()
+{
+    auto server = QSharedPointer<Q1MockServer>::create();
+    server->When("FROM pg_catalog\\.pg_class c", Q1MockResultSet::Rows(
+        {"table_name", "column_name", "data_type", "character_maximum_length",
+         "is_nullable", "column_default", "is_identity", "ordinal_position"},
+        {
+            {"cities", "id", "integer", QVariant(), "NO", QVariant(), 1, 1},
+            {"cities", "name", "character varying", 120, "NO", QVariant(), 0, 2},
+            {"countries", "id", "integer", QVariant(), "NO", "nextval('countries_id_seq'::regclass)", 0, 1}
+        }));
+    server->When("FROM pg_catalog\\.pg_constraint", Q1MockResultSet::Rows(
+        {"constraint_name", "table_name", "definition", "kind"},
+        {
+            {"cities_pkey", "cities", QVariant(), "constraint"},
+            {"FK_cities_countries", "cities", QVariant(), "constraint"},
+            {"IX_cities_country_id", "cities", QVariant(), "index"}
+        }));
+
+    Q1Connection connection(POSTGRE_SQL, Q1MockDriver::Factory(server));
+    Q1Migration migration(connection);
+    Q1SchemaSnapshot snapshot;
+
+    QVERIFY(migration.LoadSchemaSnapshot(snapshot));
+    QCOMPARE(server->ExecutedCount(), 2);
+
+    QVERIFY(snapshot.IsLoaded());
+    QCOMPARE(snapshot.Tables(), QStringList({"cities", "countries"}));
+    QVERIFY(snapshot.HasTable("Cities"));
+    QVERIFY(!snapshot.HasTable("regions"));
+
+    const QList<Q1Column> cities = snapshot.Columns("cities");
+    QCOMPARE(cities.size(), 2);
+    QVERIFY(cities[0].is_identity);
+    QCOMPARE(cities[1].type, VARCHAR);
+    QCOMPARE(cities[1].size, 120);
+    QVERIFY(!cities[1].nullable);
+    QCOMPARE(snapshot.Columns("countries").first().default_value, QString("GENERATED ALWAYS AS IDENTITY"));
+
+    QVERIFY(snapshot.HasConstraint("fk_cities_countries"));
+    QVERIFY(!snapshot.HasConstraint("fk_cities_regions"));
+    snapshot.AddConstraint("FK_cities_regions");
+    QVERIFY(snapshot.HasConstraint("fk_cities_regions"));
+
+    QVERIFY(snapshot.HasIndex("ix_cities_country_id"));
+    QVERIFY(!snapshot.HasConstraint("IX_cities_country_id"));
+    QCOMPARE(snapshot.Indexes("Cities"), QStringList({"IX_cities_country_id"}));
+}
+
+void MockDriverTests::test_migrationPlanRunsInOneTransaction()
+{
+    auto server = QSharedPointer<Q1MockServer>::create();
+    Q1Connection connection(POSTGRE_SQL, Q1MockDriver::Factory(server));
+    Q1Migration migration(connection);
+
+    Q1MigrationPlan plan = migration.CreatePlan();
+    plan.AddColumn("cities", Q1Column("population", INTEGER, 0, true));
+    plan.DropColumn("cities", "legacy_code");
+    plan.SetColumnNullable("cities", "name");
+    QCOMPARE(plan.Size(), 3);
+    QVERIFY(plan.Skipped().isEmpty());
+
+    const QString sql = plan.ToSql();
+    QVERIFY(sql.contains("-- cities: add column population"));
+    QVERIFY(sql.contains("ALTER TABLE \"cities\" DROP COLUMN"));
+
+    QVERIFY(migration.ExecutePlan(plan));
+    QStringList executed = server->ExecutedSql();
+    QCOMPARE(executed.size(), 5);
+    QCOMPARE(executed.first(), QString("BEGIN"));
+    QCOMPARE(executed.last(), QString("COMMIT"));
+
+    // A failing step rolls back everything before it
+    server->ClearLog();
+    server->When("DROP COLUMN", Q1MockResultSet::Error("column \"legacy_code\" does not exist"));
+    QVERIFY(!migration.ExecutePlan(plan));
+    executed = server->ExecutedSql();
+    QCOMPARE(executed.size(), 4);
+    QCOMPARE(executed.last(), QString("ROLLBACK"));
+    QVERIFY(migration.ErrorMessage().contains("drop column legacy_code"));
+}
+
+void MockDriverTests::test_readsGoToReplicaUntilWrite()
+{
+    auto primary = QSharedPointer<Q1MockServer>::create();
+    auto replica = QSharedPointer<Q1MockServer>::create();
+    primary->When("^INSERT INTO \"cities\"", Q1MockResultSet::Rows({"id"}, {{42}}));
+    replica->When("^SELECT .* FROM \"cities\"", Q1MockResultSet::Rows({"id", "name", "country_id"}, CityRows()));
+
+    Q1Connection connection(POSTGRE_SQL, Q1MockDriver::Factory(primary));
+    connection.AddReplica(Q1MockDriver::Factory(replica));
+    connection.SetReadYourWrites(true, 60000);
+    Q1Entity<City> cities(&connection);
+    CityMap::ConfigureEntity(cities);
+
+    QCOMPARE(cities.Select().ToList().size(), 3);
+    QCOMPARE(replica->ExecutedCount(), 1);
+    QCOMPARE(primary->ExecutedCount(), 0);
+
+    // Raw statements that write never reach the replica
+    cities.ExecuteQuery("UPDATE \"cities\" SET name = 'x' WHERE id = 1");
+    QCOMPARE(primary->ExecutedCount(), 1);
+    QVERIFY(connection.IsPinnedToPrimary());
+
+    City city;
+    city.name = "Vancouver";
+    city.country_id = 2;
+    QVERIFY(cities.Insert(city));
+
+    // The session reads its own write from the primary
+    cities.Select().ToList();
+    QCOMPARE(replica->ExecutedCount(), 1);
+    QCOMPARE(primary->ExecutedCount(), 3);
+
+    connection.SetReadYourWrites(false);
+    cities.Select().ToList();
+    QCOMPARE(replica->ExecutedCount(), 2);
+
+    // A batch of reads is sent to the replica as well
+    Q1Batch batch(&connection);
+    batch.Count(cities.Select());
+    QVERIFY(batch.Execute());
+    QCOMPARE(replica->ExecutedCount(), 3);
+    QCOMPARE(primary->ExecutedCount(), 3);
+
+    // Replica statements reach the primary's observers, marked as replica reads
+    Q1Metrics metrics;
+    connection.AddInstrumentation(&metrics);
+    connection.SetSlowQueryThreshold(0);
+    cities.Select().ToList();
+    QCOMPARE(metrics.Statements(), qint64(1));
+    QVERIFY(connection.GetSlowQueryLog()->Last().metrics.replica);
+
+    // Caller-written SQL stays on the primary unless raw reads are allowed
+    connection.SetSlowQueryThreshold(-1);
+    cities.ExecuteQuery("SELECT * FROM \"cities\"");
+    QCOMPARE(primary->ExecutedCount(), 4);
+    connection.SetRawReadsOnReplicas(true);
+    cities.ExecuteQuery("SELECT * FROM \"cities\"");
+    QCOMPARE(replica->ExecutedCount(), 5);
+    cities.ExecuteQuery("SELECT nextval('cities_id_seq')");
+    cities.ExecuteQuery("SELECT * FROM \"cities\" WHERE id = 1 FOR UPDATE");
+    QCOMPARE(primary->ExecutedCount(), 6);
+    QCOMPARE(replica->ExecutedCount(), 5);
+
+    // A write on a pool thread pins only that thread's reads
+    connection.SetReadYourWrites(true, 60000);
+    QtConcurrent::run(Q1Executor::Pool(), [&connection]() {
+        Q1Executor::ThreadConnection(&connection)->MarkWrite();
+    }).waitForFinished();
+    QVERIFY(!connection.IsPinnedToPrimary());
+}
+
+void MockDriverTests::test_batchReportsFailedItems()
+{
+    auto server = QSharedPointer<Q1MockServer>::create();
+    server->When("FROM \"cities\"", Q1MockResultSet::Rows({"id", "name", "country_id"}, CityRows()));
+    server->When("FROM \"countries\"", Q1MockResultSet::Error("relation \"countries\" does not exist"));
+
+    Q1Connection sqlite(SQLITE, Q1MockDriver::Factory(server));
+    Q1Entity<City> cities(&sqlite);
+    Q1Entity<Country> countries(&sqlite);
+    CityMap::ConfigureEntity(cities);
+    CountryMap::ConfigureEntity(countries);
+
+    // One failed statement does not keep the others from running
+    Q1Batch batch(&sqlite);
+    auto failed = batch.Count(countries.Select());
+    auto rows = batch.Add(cities.Select());
+    QVERIFY(!batch.Execute());
+    QVERIFY(failed.Failed());
+    QVERIFY(!failed.IsReady());
+    QVERIFY(rows.IsReady());
+    QCOMPARE(rows.Value().size(), 3);
+    QVERIFY(batch.GetLastError().contains("does not exist"));
+
+    // PostgreSQL orders inside the aggregate, which does not keep its input order
+    server->ClearLog();
+    Q1Connection postgres(POSTGRE_SQL, Q1MockDriver::Factory(server));
+    Q1Entity<City> pgCities(&postgres);
+    CityMap::ConfigureEntity(pgCities);
+
+    Q1Batch pgBatch(&postgres);
+    pgBatch.Add(pgCities.Select().OrderBy("name"));
+    pgBatch.Execute();
+    QVERIFY(server->ExecutedSql().last().contains(
+        "(SELECT COALESCE(jsonb_agg(to_jsonb(\"cities\".*) ORDER BY name), '[]'::jsonb) FROM (SELECT \"cities\".* FROM \"cities\" ORDER BY name) AS \"cities\")"));
+}
+
+void MockDriverTests::test_viewRefresherRunsWithoutEventLoop()
+{
+    auto server = QSharedPointer<Q1MockServer>::create();
+    Q1Connection connection(POSTGRE_SQL, Q1MockDriver::Factory(server));
+
+    Q1Table stats("country_stats");
+    stats.view = Q1View("SELECT country_id, COUNT(*) AS cities FROM cities GROUP BY country_id").RefreshEvery(20);
+
+    Q1ViewRefresher refresher(&connection);
+    refresher.Add(stats);
+
+    // Only sleeps, never processes events: the refresher schedules on its own thread
+    for (int i = 0; i < 200 && !refresher.LastRefreshed("country_stats").isValid(); ++i)
+        QThread::msleep(10);
+    QVERIFY(refresher.LastRefreshed("country_stats").isValid());
+    QVERIFY(server->ExecutedSql().contains("REFRESH MATERIALIZED VIEW \"country_stats\""));
+
+    // Stop() may come from any thread and ends the schedule
+    QtConcurrent::run([&refresher]() { refresher.Stop(); }).waitForFinished();
+    QThread::msleep(50);
+    const int executed = server->ExecutedCount();
+    QThread::msleep(100);
+    QCOMPARE(server->ExecutedCount(), executed);
+}
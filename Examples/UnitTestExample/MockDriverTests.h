@@ -0,0 +1,34 @@
+#ifndef MOCKDRIVERTESTS_H
+#define MOCKDRIVERTESTS_H
+
+#include <QObject>
+
+// Network-free tests that run the ORM against Q1MockDriver
+class MockDriverTests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void test_selectHydratesMockRows();
+    void test_generatedResultSet();
+    void test_insertRecordsSqlAndBinds();
+    void test_upsertRangeStaysBelowBindLimit();
+    void test_setBasedDeleteMatchesWholeKey();
+    void test_sqlServerDialect();
+    void test_statementError();
+    void test_connectionReleasesItsName();
+    void test_instrumentationAggregatesStatements();
+    void test_slowQueryLogCapturesPlan();
+    void test_queryCounterDetectsRepeatedShapes();
+    void test_queryCounterFollowsAsyncCalls();
+    void test_findManyPreservesKeyOrder();
+    void test_serverJsonKeepsOrder();
+    void test_stitchRelationGroupsRelatedRows();
+    void test_schemaSnapshotReadsCatalogOnce();
+    void test_migrationPlanRunsInOneTransaction();
+    void test_readsGoToReplicaUntilWrite();
+    void test_batchReportsFailedItems();
+    void test_viewRefresherRunsWithoutEventLoop();
+};
+
+#endif // MOCKDRIVERTESTS_H
@@ -1,9 +1,41 @@
 #include "Q1ORMTests.h"
 #include <QtSql/QSqlDatabase>
+#include <QBuffer>
 
 int usaId = 0;
 int canadaId = 0;
 
+namespace
+{
+Q1Task<int> InsertCountryThenCount(ApplicationDbContext* ctx, QString name)
+{
+    Country country;
+    country.name = name;
+
+    std::optional<Country> inserted = co_await ctx->countries.InsertAsync(country);
+    if (!inserted)
+        co_return -1;
+
+    int matches = co_await ctx->countries.Select()
+                      .Where(QString("id = %1").arg(inserted->id))
+                      .CountAsync();
+
+    co_return matches;
+}
+
+struct CityName
+{
+    int id = 0;
+    QString name;
+
+    static void ConfigureProjection(Q1Projection<CityName>& projection)
+    {
+        projection.Property(&CityName::id, "id");
+        projection.Property(&CityName::name, "name");
+    }
+};
+}
+
 void Q1ORMTests::initTestCase()
 {
     qDebug() << "\n=== Initializing Q1ORM Test Suite ===\n";
@@ -377,6 +409,24 @@ void Q1ORMTests::test_include_withWhere()
     QCOMPARE(cities.size(),3);
 }
 
+void Q1ORMTests::test_include_serverJson()
+{
+    QByteArray json = ctx->countries.Select()
+                          .OrderBy("name")
+                          .Include("cities")
+                          .ServerJson()
+                          .ToJson();
+
+    QJsonDocument doc = QJsonDocument::fromJson(json);
+    QVERIFY(doc.isArray());
+    QCOMPARE(doc.array().size(), 2);
+
+    const QJsonObject canada = doc.array()[0].toObject();
+    QCOMPARE(canada.value("name").toString(), QString("Canada"));
+    QCOMPARE(canada.value("cities").toArray().size(), 1);
+    QCOMPARE(doc.array()[1].toObject().value("cities").toArray().size(), 2);
+}
+
 void Q1ORMTests::test_include_reverseCollection()
 {
     QList<Country> countries = ctx->countries.Select()
@@ -419,6 +469,18 @@ void Q1ORMTests::test_toJson()
     QCOMPARE(doc.array().size(),2);
 }
 
+void Q1ORMTests::test_writeJson()
+{
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QVERIFY(ctx->cities.Select().OrderBy("id").WriteJson(&buffer));
+
+    QByteArray expected = ctx->cities.Select().OrderBy("id").ToJson();
+
+    QVERIFY(!buffer.data().contains('\n'));
+    QCOMPARE(QJsonDocument::fromJson(buffer.data()), QJsonDocument::fromJson(expected));
+}
+
 void Q1ORMTests::test_showJson()
 {
     ctx->cities.Select().Limit(2).ShowJson();
@@ -498,3 +560,135 @@ void Q1ORMTests::test_reinitialize_is_clean()
     QList<City> cities = ctx->cities.Select().ToList();
     QCOMPARE(cities.size(), 3);
 }
+
+// ================= ASYNC =================
+
+void Q1ORMTests::test_toListAsync()
+{
+    QFuture<Q1AsyncResult<QList<City>>> future = ctx->cities.Select()
+    .Where(QString("country_id = %1").arg(usaId))
+        .ToListAsync();
+
+    future.waitForFinished();
+    QVERIFY(future.result().Ok());
+    QCOMPARE(future.result().value.size(), 2);
+}
+
+void Q1ORMTests::test_countAsync()
+{
+    QFuture<Q1AsyncResult<int>> cities = ctx->cities.Select().CountAsync();
+    QFuture<Q1AsyncResult<int>> countries = ctx->countries.Select().CountAsync();
+
+    cities.waitForFinished();
+    countries.waitForFinished();
+
+    QCOMPARE(cities.result().value, 3);
+    QCOMPARE(countries.result().value, 2);
+}
+
+void Q1ORMTests::test_coroutineInsertThenQuery()
+{
+    Q1Task<int> task = InsertCountryThenCount(ctx, "Mexico");
+
+    QTRY_VERIFY(task.IsFinished());
+    QCOMPARE(task.Result(), 1);
+
+    QVERIFY(ctx->countries.Delete("name = 'Mexico'"));
+}
+
+void Q1ORMTests::test_batch()
+{
+    Q1Batch batch(conn);
+    auto cities = batch.Add(ctx->cities.Select()
+                                .Where(QString("country_id = %1").arg(usaId))
+                                .OrderBy("name"));
+    auto cityCount = batch.Count(ctx->cities.Select());
+    auto countryCount = batch.Count(ctx->countries.Select());
+
+    QCOMPARE(batch.Size(), 3);
+    QVERIFY(batch.Execute());
+    QCOMPARE(batch.Size(), 0);
+
+    QVERIFY(cities.IsReady());
+    QCOMPARE(cities.Value().size(), 2);
+    QCOMPARE(cities.Value().first().name, QString("Los Angeles"));
+    QCOMPARE(cityCount.Value(), 3);
+    QCOMPARE(countryCount.Value(), 2);
+}
+
+void Q1ORMTests::test_upsertRange()
+{
+    QList<City> cities = ctx->cities.Select()
+                             .Where(QString("country_id = %1").arg(usaId))
+                             .ToList();
+    QCOMPARE(cities.size(), 2);
+
+    for (City& city : cities)
+    {
+        city.name += " (US)";
+    }
+
+    QVERIFY(ctx->cities.UpsertRange(cities, {"id"}));
+    QCOMPARE(ctx->cities.Select().Count(), 3);
+    QCOMPARE(ctx->cities.Select().Where("name LIKE '% (US)'").Count(), 2);
+
+    for (City& city : cities)
+    {
+        city.name.chop(5);
+    }
+
+    QVERIFY(ctx->cities.UpsertRange(cities, {"id"}));
+    QCOMPARE(ctx->cities.Select().Where("name LIKE '% (US)'").Count(), 0);
+}
+
+void Q1ORMTests::test_executeUpdate()
+{
+    int updated = ctx->cities.Select()
+                      .Where(QString("country_id = %1").arg(canadaId))
+                      .ExecuteUpdate({{"name", "Toronto ON"}});
+    QCOMPARE(updated, 1);
+    QCOMPARE(ctx->cities.Select().Where("name = 'Toronto ON'").Count(), 1);
+
+    updated = ctx->cities.Select()
+                  .InnerJoin("countries", "cities.country_id = countries.id")
+                  .Where("countries.name = 'Canada'")
+                  .ExecuteUpdate({{"name", "Toronto"}});
+    QCOMPARE(updated, 1);
+    QCOMPARE(ctx->cities.Select().Where("name = 'Toronto'").Count(), 1);
+}
+
+void Q1ORMTests::test_executeDelete()
+{
+    City temp;
+    temp.name = "Temp City";
+    temp.country_id = usaId;
+    QVERIFY(ctx->cities.Insert(temp));
+
+    QCOMPARE(ctx->cities.Select().ExecuteDelete(), -1);
+    QCOMPARE(ctx->cities.Select().Where("name = 'Temp City'").ExecuteDelete(), 1);
+    QCOMPARE(ctx->cities.Select().Count(), 3);
+}
+
+void Q1ORMTests::test_projectTuple()
+{
+    QList<std::tuple<int, QString>> rows = ctx->cities.Select()
+                                                .Where(QString("country_id = %1").arg(usaId))
+                                                .OrderBy("name")
+                                                .Project<std::tuple<int, QString>>(&City::id, &City::name);
+
+    QCOMPARE(rows.size(), 2);
+    QVERIFY(std::get<0>(rows[0]) > 0);
+    QCOMPARE(std::get<1>(rows[0]), QString("Los Angeles"));
+    QCOMPARE(std::get<1>(rows[1]), QString("New York"));
+}
+
+void Q1ORMTests::test_projectDto()
+{
+    QList<CityName> rows = ctx->cities.Select()
+                               .InnerJoin("countries", "cities.country_id = countries.id")
+                               .Where("countries.name = 'Canada'")
+                               .Project<CityName>();
+
+    QCOMPARE(rows.size(), 1);
+    QCOMPARE(rows[0].name, QString("Toronto"));
+}
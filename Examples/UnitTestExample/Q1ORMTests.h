@@ -85,6 +85,7 @@ private slots:
     void test_include_showJson();
     void test_include_withWhere();
     void test_include_reverseCollection();
+    void test_include_serverJson();
 
     // Test 12: Combined Operations
     void test_whereOrderByLimit();
@@ -93,6 +94,7 @@ private slots:
     // Test 13: JSON Output
     void test_toJson();
     void test_showJson();
+    void test_writeJson();
 
     // Test 14: ToList
     void test_toList();
@@ -102,6 +104,25 @@ private slots:
     void test_emptyResult();
     void test_nullValues();
     void test_reinitialize_is_clean();
+
+    // Test 16: Async Queries
+    void test_toListAsync();
+    void test_countAsync();
+    void test_coroutineInsertThenQuery();
+
+    // Test 17: Batches
+    void test_batch();
+
+    // Test 18: Upsert
+    void test_upsertRange();
+
+    // Test 19: Set-based Update / Delete
+    void test_executeUpdate();
+    void test_executeDelete();
+
+    // Test 20: Projections
+    void test_projectTuple();
+    void test_projectDto();
 };
 
 #endif // Q1ORMTESTS_H
@@ -2,6 +2,7 @@
 
 #include <QtTest/QtTest>
 
+#include <Q1Core/Q1Migration/Q1Migration.h>
 #include <Q1Core/Q1Migration/Q1MigrationQuery.h>
 
 void SqlGenerationTests::test_postgresqlTranslatorStillUsesPostgresDialect()
@@ -54,3 +55,289 @@ void SqlGenerationTests::test_sqlServerTranslatorUsesMetadataForNullabilityChang
     QVERIFY(setNullable.contains("NULL"));
     QVERIFY(setNotNull.contains("NOT NULL"));
 }
+
+void SqlGenerationTests::test_sqliteTranslatorBuildsRowidTableWithInlineForeignKeys()
+{
+    Q1MigrationQuery query(DatabaseType::SQLite);
+
+    Q1Table table;
+    table.SetName("cities");
+    table.columns.append(Q1Column("id", INTEGER, 0, false, true, "GENERATED ALWAYS AS IDENTITY", true));
+    table.columns.append(Q1Column("country_id", INTEGER, 0, false, false));
+    table.relations.append(Q1Relation("cities", "countries", MANY_TO_ONE, "country_id", "id"));
+
+    const QString sql = query.AddTableSQL(table);
+
+    QVERIFY(sql.startsWith("CREATE TABLE IF NOT EXISTS \"cities\""));
+    QVERIFY(sql.contains("\"id\" INTEGER PRIMARY KEY AUTOINCREMENT"));
+    QVERIFY(sql.contains("CONSTRAINT \"FK_cities_countries_country_id\" FOREIGN KEY (\"country_id\") REFERENCES \"countries\"(\"id\")"));
+    QVERIFY(!query.DropTableSQL("cities").contains("CASCADE"));
+    QVERIFY(query.GetColumnsSQL("cities").contains("pragma_table_info('cities')"));
+}
+
+void SqlGenerationTests::test_sqliteTranslatorRejectsInPlaceColumnChanges()
+{
+    Q1MigrationQuery query(DatabaseType::SQLite);
+
+    QVERIFY(query.SetColumnNullableSQL("cities", "name").isEmpty());
+    QVERIFY(query.UpdateColumnSizeSQL("cities", "name", 80).isEmpty());
+    QVERIFY(query.lastError().contains("cities.name"));
+    QVERIFY(query.AddRelationSQL(Q1Relation("cities", "countries", MANY_TO_ONE, "country_id", "id")).isEmpty());
+    QCOMPARE(query.DropColumnSQL("cities", "name"), QString("ALTER TABLE \"cities\" DROP COLUMN \"name\""));
+}
+
+void SqlGenerationTests::test_modelFingerprintTracksDeclaredSchema()
+{
+    Q1Table cities;
+    cities.SetName("cities");
+    cities.columns.append(Q1Column("id", INTEGER, 0, false, true, "GENERATED ALWAYS AS IDENTITY", true));
+    cities.columns.append(Q1Column("name", VARCHAR, 120, false, false));
+
+    Q1Table countries;
+    countries.SetName("countries");
+    countries.columns.append(Q1Column("id", INTEGER, 0, false, true, "GENERATED ALWAYS AS IDENTITY", true));
+
+    const QList<Q1Relation> relations{Q1Relation("cities", "countries", MANY_TO_ONE, "country_id")};
+    const QString fingerprint = Q1Migration::ModelFingerprint({&cities, &countries}, relations);
+
+    QCOMPARE(fingerprint.size(), 64);
+    QCOMPARE(Q1Migration::ModelFingerprint({&countries, &cities}, relations), fingerprint);
+    QVERIFY(Q1Migration::ModelFingerprint({&cities, &countries}, {}) != fingerprint);
+
+    cities.columns[1].size = 200;
+    QVERIFY(Q1Migration::ModelFingerprint({&cities, &countries}, relations) != fingerprint);
+
+    QVERIFY(Q1MigrationQuery(DatabaseType::PostgreSQL).SetModelFingerprintSQL().contains("ON CONFLICT (\"id\")"));
+    QVERIFY(Q1MigrationQuery(DatabaseType::SQLServer).SetModelFingerprintSQL().startsWith("MERGE [__q1orm_model]"));
+}
+
+void SqlGenerationTests::test_sqliteMigrationPlanSkipsInPlaceColumnChanges()
+{
+    Q1MigrationPlan plan(DatabaseType::SQLite);
+    plan.AddColumn("cities", Q1Column("population", INTEGER, 0, true));
+    plan.UpdateColumnSize("cities", "name", 200);
+
+    QCOMPARE(plan.Size(), 1);
+    QCOMPARE(plan.Skipped().size(), 1);
+    QVERIFY(plan.Skipped().first().startsWith("cities: resize name to 200"));
+    QVERIFY(plan.ToSql().contains("-- skipped: cities: resize name to 200"));
+}
+
+void SqlGenerationTests::test_migrationPlanSplitsByTable()
+{
+    Q1MigrationPlan plan(DatabaseType::SQLServer);
+    plan.AddColumn("cities", Q1Column("population", INTEGER, 0, true));
+    plan.DropColumn("countries", "legacy_code");
+    plan.SetColumnNullable("cities", "name");
+
+    const QList<Q1MigrationPlan> plans = plan.SplitByTable();
+
+    QCOMPARE(plans.size(), 2);
+    QCOMPARE(plans[0].Size(), 2);
+    QCOMPARE(plans[0].Steps()[1].description, QString("make name nullable"));
+    QCOMPARE(plans[1].Steps().first().table, QString("countries"));
+    QCOMPARE(plans[1].GetDatabaseType(), DatabaseType::SQLServer);
+}
+
+void SqlGenerationTests::test_migrationPlanListsWholeObjects()
+{
+    Q1Table events("events");
+    events.AddColumn(Q1Column("id", INTEGER, 0, false, true));
+    events.AddColumn(Q1Column("country_id", INTEGER, 0, true));
+    events.AddColumn(Q1Column("created_at", TIMESTAMP, 0, false));
+    events.partition = Q1Partition(RANGE, "created_at").Every(MONTHLY);
+
+    // What a dry run of Initialize() collects instead of executing
+    Q1MigrationPlan plan(DatabaseType::PostgreSQL);
+    plan.CreateTable(events);
+    plan.CreatePartitions(events, QDate(2026, 10, 19));
+    plan.AddRelation(Q1Relation("events", "countries", MANY_TO_ONE, "country_id"));
+    plan.CreateIndex(Q1Index("events", {"country_id"}));
+
+    QVERIFY(plan.Skipped().isEmpty());
+    QCOMPARE(plan.Steps().first().description, QString("create table"));
+    QVERIFY(plan.Steps().first().sql.startsWith("CREATE TABLE"));
+    QVERIFY(plan.ToSql().contains("PARTITION OF \"events\" FOR VALUES FROM ('2026-10-01')"));
+    QVERIFY(plan.ToSql().contains("FOREIGN KEY"));
+    QCOMPARE(plan.Steps().last().description, QString("create index IX_events_country_id"));
+
+    Q1MigrationPlan columns(DatabaseType::PostgreSQL);
+    columns.DropColumn("events", "legacy");
+    plan.Append(columns);
+    QCOMPARE(plan.Steps().last().description, QString("drop column legacy"));
+}
+
+void SqlGenerationTests::test_onlineMigrationPlanAvoidsLongLocks()
+{
+    Q1MigrationPlan plan(DatabaseType::PostgreSQL);
+    plan.SetOnline(true, 2000, 500);
+    plan.AddColumn("orders", Q1Column("token", TEXT, 0, false, false, "gen_random_uuid()"));
+
+    QCOMPARE(plan.LockTimeoutSQL(), QString("SET LOCAL lock_timeout = '2000ms'"));
+    QCOMPARE(plan.Size(), 7);
+
+    const QList<Q1MigrationStep> &steps = plan.Steps();
+    QVERIFY(!steps[0].sql.contains("NOT NULL"));
+    QVERIFY(!steps[0].sql.contains("DEFAULT"));
+    QCOMPARE(steps[1].description, QString("set default of token"));
+    QVERIFY(steps[2].repeat);
+    QVERIFY(steps[2].sql.contains("WHERE \"token\" IS NULL LIMIT 500"));
+    QVERIFY(steps[3].sql.endsWith("CHECK (\"token\" IS NOT NULL) NOT VALID"));
+    QVERIFY(steps[4].sql.contains("VALIDATE CONSTRAINT"));
+    QVERIFY(steps[5].sql.endsWith("SET NOT NULL"));
+    QVERIFY(steps[6].sql.contains("DROP CONSTRAINT"));
+
+    // Stable functions are stored once as metadata, only volatile ones are backfilled
+    Q1MigrationQuery postgres(DatabaseType::PostgreSQL);
+    postgres.SetOnline(true);
+    QVERIFY(!postgres.NeedsBackfill(Q1Column("created_at", TIMESTAMP, 0, false, false, "now()")));
+    QVERIFY(!postgres.NeedsBackfill(Q1Column("code", VARCHAR, 8, false, false, "upper('x')")));
+    QVERIFY(postgres.NeedsBackfill(Q1Column("seed", REAL, 0, true, false, "random()")));
+    QVERIFY(postgres.NeedsBackfill(Q1Column("stamp", TIMESTAMP, 0, true, false, "clock_timestamp()")));
+
+    Q1MigrationQuery sqlServerQuery(DatabaseType::SQLServer);
+    sqlServerQuery.SetOnline(true);
+    QVERIFY(!sqlServerQuery.NeedsBackfill(Q1Column("created_at", TIMESTAMP, 0, false, false, "GETDATE()")));
+    QVERIFY(sqlServerQuery.NeedsBackfill(Q1Column("token", CHAR, 36, false, false, "NEWID()")));
+
+    Q1MigrationPlan server(DatabaseType::SQLServer);
+    server.SetOnline(true);
+    server.UpdateColumnSize("orders", "note", 400);
+    QVERIFY(server.Steps().first().sql.contains("ONLINE = ON"));
+    QCOMPARE(server.SplitByTable().first().IsOnline(), true);
+}
+
+void SqlGenerationTests::test_indexesAreBuiltWithoutBlockingWrites()
+{
+    Q1MigrationQuery postgres(DatabaseType::PostgreSQL);
+    const Q1Index index("cities", {"country_id", "name"}, false, {"population"}, "\"deleted_at\" IS NULL");
+
+    // include columns and predicate are part of the name, so changing them rebuilds the index
+    QCOMPARE(Q1Index("cities", {"country_id", "name"}).GetName(), QString("IX_cities_country_id_name"));
+    QVERIFY(index.GetName().startsWith("IX_cities_country_id_name_"));
+    QVERIFY(index.GetName() != Q1Index("cities", {"country_id", "name"}, false, {"population"}).GetName());
+    QVERIFY(index.GetName() != Q1Index("cities", {"country_id", "name"}, false, {}, "\"deleted_at\" IS NULL").GetName());
+    QCOMPARE(postgres.CreateIndexSQL(index),
+             QString("CREATE INDEX CONCURRENTLY IF NOT EXISTS \"%1\" ON \"cities\" "
+                     "(\"country_id\", \"name\") INCLUDE (\"population\") WHERE \"deleted_at\" IS NULL").arg(index.GetName()));
+    QVERIFY(postgres.DropIndexSQL("cities", index.GetName()).startsWith("DROP INDEX CONCURRENTLY"));
+
+    // ONE_TO_MANY keeps the key on the child (top) table
+    const Q1Index fk = postgres.ForeignKeyIndex(Q1Relation("countries", "cities", ONE_TO_MANY, "country_id"));
+    QVERIFY(fk.automatic);
+    QCOMPARE(fk.table, QString("cities"));
+    QCOMPARE(fk.columns, QStringList({"country_id"}));
+    QVERIFY(!postgres.ForeignKeyIndex(Q1Relation("users", "profiles", ONE_TO_ONE, "profile_id")).IsValid());
+
+    Q1MigrationQuery sqlite(DatabaseType::SQLite);
+    QVERIFY(!sqlite.CreateIndexSQL(index).contains("INCLUDE"));
+
+    Q1Table cities("cities");
+    cities.AddColumn(Q1Column("id", INTEGER, 0, false, true));
+    QVERIFY(cities.HasIndexOn("id"));
+    QVERIFY(!cities.HasIndexOn("country_id"));
+    cities.AddIndex(Q1Index("cities", {"country_id"}));
+    QVERIFY(cities.HasIndexOn("country_id"));
+
+    const QString fingerprint = Q1Migration::ModelFingerprint({&cities}, {});
+    cities.AddIndex(Q1Index("cities", {"name"}, true));
+    QVERIFY(Q1Migration::ModelFingerprint({&cities}, {}) != fingerprint);
+}
+
+void SqlGenerationTests::test_rangePartitionsArePremadeAndExpired()
+{
+    Q1Table events("events");
+    events.AddColumn(Q1Column("id", INTEGER, 0, false, true, "GENERATED ALWAYS AS IDENTITY", true));
+    events.AddColumn(Q1Column("created_at", TIMESTAMP, 0, false));
+    events.partition = Q1Partition(RANGE, "created_at").Every(MONTHLY).Premake(2).Retain(2);
+
+    Q1MigrationQuery postgres(DatabaseType::PostgreSQL);
+    const QString create = postgres.AddTableSQL(events);
+    QVERIFY(create.endsWith("PRIMARY KEY (\"id\", \"created_at\")) PARTITION BY RANGE (\"created_at\")"));
+    QVERIFY(!create.contains("SERIAL PRIMARY KEY"));
+
+    const QDate today(2026, 10, 19);
+    const QStringList partitions = postgres.CreatePartitionsSQL(events, today);
+    QCOMPARE(partitions.size(), 4);
+    QCOMPARE(partitions.first(),
+             QString("CREATE TABLE IF NOT EXISTS \"events_p20261001\" PARTITION OF \"events\" "
+                     "FOR VALUES FROM ('2026-10-01') TO ('2026-11-01')"));
+    QVERIFY(partitions[2].contains("FROM ('2026-12-01') TO ('2027-01-01')"));
+    QCOMPARE(partitions.last(), QString("CREATE TABLE IF NOT EXISTS \"events_default\" PARTITION OF \"events\" DEFAULT"));
+
+    const QStringList existing{"events_p20260701", "events_p20260801", "events_p20261001", "events_archive", "events_default"};
+    QCOMPARE(postgres.DropExpiredPartitionsSQL(events, existing, today),
+             QStringList({"DROP TABLE IF EXISTS \"events_p20260701\""}));
+
+    Q1MigrationQuery sqlServer(DatabaseType::SQLServer);
+    QVERIFY(sqlServer.AddTableSQL(events).contains("ON [ps_events]([created_at])"));
+    QVERIFY(sqlServer.CreatePartitionsSQL(events, today).first().contains("SPLIT RANGE ('2026-10-01')"));
+    QVERIFY(sqlServer.DropExpiredPartitionsSQL(events, {}, today).first().contains("MERGE RANGE"));
+
+    // RANGE boundaries are date literals, so a numeric column is rejected instead of failing on the server
+    events.partition = Q1Partition(RANGE, "id").Every(MONTHLY).Retain(2);
+    QVERIFY(sqlServer.AddTableSQL(events).isEmpty());
+    QVERIFY(sqlServer.lastError().contains("DATE or TIMESTAMP"));
+    QVERIFY(sqlServer.CreatePartitionsSQL(events, today).isEmpty());
+    QVERIFY(sqlServer.DropExpiredPartitionsSQL(events, {}, today).isEmpty());
+    QVERIFY(postgres.AddTableSQL(events).isEmpty());
+    QVERIFY(postgres.CreatePartitionsSQL(events, today).isEmpty());
+
+    events.partition = Q1Partition(HASH, "id").Modulus(8);
+    QCOMPARE(postgres.CreatePartitionsSQL(events, today).size(), 8);
+    QVERIFY(!sqlServer.SupportsPartition(events.partition));
+    QVERIFY(!Q1MigrationQuery(DatabaseType::SQLite).AddTableSQL(events).contains("PARTITION"));
+}
+
+void SqlGenerationTests::test_materializedViewsRefreshConcurrently()
+{
+    Q1Table stats("country_stats");
+    stats.view = Q1View("SELECT country_id, COUNT_BIG(*) AS cities FROM dbo.cities GROUP BY country_id", {"country_id"});
+    QVERIFY(stats.IsView());
+
+    Q1MigrationQuery postgres(DatabaseType::PostgreSQL);
+    const QStringList create = postgres.CreateViewSQL(stats);
+    QCOMPARE(create.size(), 3);
+    QVERIFY(create[0].startsWith("CREATE MATERIALIZED VIEW IF NOT EXISTS \"country_stats\" AS SELECT"));
+    QCOMPARE(create[1], QString("COMMENT ON MATERIALIZED VIEW \"country_stats\" IS '%1'").arg(stats.view.Marker()));
+    QVERIFY(create[2].startsWith("CREATE UNIQUE INDEX IF NOT EXISTS \"UX_country_stats_country_id\""));
+    QCOMPARE(postgres.RefreshViewSQL(stats), QString("REFRESH MATERIALIZED VIEW CONCURRENTLY \"country_stats\""));
+
+    Q1MigrationQuery sqlServer(DatabaseType::SQLServer);
+    const QStringList indexed = sqlServer.CreateViewSQL(stats);
+    QVERIFY(indexed[0].contains("WITH SCHEMABINDING AS /* " + stats.view.Marker() + " */"));
+    QVERIFY(indexed[1].startsWith("CREATE UNIQUE CLUSTERED INDEX"));
+    QVERIFY(sqlServer.RefreshViewSQL(stats).isEmpty());
+
+    // A changed declaration gets a new marker, so Initialize() rebuilds the view
+    const QString marker = stats.view.Marker();
+    stats.view.definition += " HAVING COUNT_BIG(*) > 1";
+    QVERIFY(stats.view.Marker() != marker);
+
+    stats.view.unique_columns.clear();
+    QCOMPARE(postgres.RefreshViewSQL(stats), QString("REFRESH MATERIALIZED VIEW \"country_stats\""));
+}
+
+void SqlGenerationTests::test_relationStatementsNameTheirTargets()
+{
+    Q1MigrationQuery postgres(DatabaseType::PostgreSQL);
+
+    const QList<Q1Statement> oneToOne = postgres.AddRelationStatements(Q1Relation("users", "profiles", ONE_TO_ONE, "profile_id"));
+    QCOMPARE(oneToOne.size(), 2);
+    QCOMPARE(oneToOne[0].kind, Q1Statement::ADD_CONSTRAINT);
+    QCOMPARE(oneToOne[0].target, QString("uq_users_profile_id"));
+    QCOMPARE(oneToOne[1].target, QString("FK_users_profiles_profile_id"));
+    QCOMPARE(oneToOne[1].table, QString("users"));
+    QVERIFY(oneToOne[1].sql.startsWith("ALTER TABLE \"users\" ADD CONSTRAINT \"FK_users_profiles_profile_id\" FOREIGN KEY"));
+    QCOMPARE(postgres.AddRelationSQL(Q1Relation("users", "profiles", ONE_TO_ONE, "profile_id")),
+             oneToOne[0].sql + "; " + oneToOne[1].sql);
+
+    const QList<Q1Statement> manyToMany = postgres.AddRelationStatements(Q1Relation("students", "courses", MANY_TO_MANY, "id"));
+    QCOMPARE(manyToMany.size(), 1);
+    QCOMPARE(manyToMany[0].kind, Q1Statement::CREATE_TABLE);
+    QCOMPARE(manyToMany[0].target, QString("students_courses"));
+
+    Q1MigrationQuery sqlite(DatabaseType::SQLite);
+    QVERIFY(sqlite.AddRelationStatements(Q1Relation("cities", "countries", MANY_TO_ONE, "country_id")).isEmpty());
+    QVERIFY(!sqlite.lastError().isEmpty());
+}
@@ -12,6 +12,17 @@ private slots:
     void test_sqlServerTranslatorBuildsIdentityTable();
     void test_sqlServerTranslatorBuildsDefaultConstraintStatements();
     void test_sqlServerTranslatorUsesMetadataForNullabilityChanges();
+    void test_sqliteTranslatorBuildsRowidTableWithInlineForeignKeys();
+    void test_sqliteTranslatorRejectsInPlaceColumnChanges();
+    void test_modelFingerprintTracksDeclaredSchema();
+    void test_sqliteMigrationPlanSkipsInPlaceColumnChanges();
+    void test_migrationPlanSplitsByTable();
+    void test_migrationPlanListsWholeObjects();
+    void test_onlineMigrationPlanAvoidsLongLocks();
+    void test_indexesAreBuiltWithoutBlockingWrites();
+    void test_rangePartitionsArePremadeAndExpired();
+    void test_materializedViewsRefreshConcurrently();
+    void test_relationStatementsNameTheirTargets();
 };
 
 #endif // SQLGENERATIONTESTS_H
@@ -1,6 +1,7 @@
 #include <QCoreApplication>
 #include <QtTest/QtTest>
 
+#include "MockDriverTests.h"
 #include "PostgreSqlTests.h"
 #include "SqlGenerationTests.h"
 #include "SqlServerTests.h"
@@ -16,6 +17,11 @@ int main(int argc, char *argv[])
         status |= QTest::qExec(&tests, argc, argv);
     }
 
+    {
+        MockDriverTests tests;
+        status |= QTest::qExec(&tests, argc, argv);
+    }
+
     {
         PostgreSqlTests tests;
         status |= QTest::qExec(&tests, argc, argv);
@@ -0,0 +1,26 @@
+#ifndef Q1ASYNCRESULT_H
+#define Q1ASYNCRESULT_H
+
+#include <QString>
+
+// Value of an async read together with the error of the pool thread's statement.
+// The pool works on copies of the entity set, so GetLastError() on the caller's
+// copy never sees it. Converts to T, so co_await and result() read the value.
+template<typename T>
+struct Q1AsyncResult
+{
+    T value = T();
+    QString error;      // empty on success
+
+    bool Ok() const
+    {
+        return error.isEmpty();
+    }
+
+    operator const T&() const
+    {
+        return value;
+    }
+};
+
+#endif // Q1ASYNCRESULT_H
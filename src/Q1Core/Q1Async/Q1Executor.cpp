@@ -0,0 +1,40 @@
+#include "Q1Executor.h"
+
+#include <QHash>
+#include <QSharedPointer>
+#include <QThread>
+#include <QThreadStorage>
+
+namespace
+{
+QThreadStorage<QHash<QString, QSharedPointer<Q1Connection>>*> thread_connections;
+}
+
+QThreadPool* Q1Executor::Pool()
+{
+    static QThreadPool pool;
+    return &pool;
+}
+
+void Q1Executor::SetMaxThreadCount(int count)
+{
+    if (count > 0)
+        Pool()->setMaxThreadCount(count);
+}
+
+Q1Connection* Q1Executor::ThreadConnection(Q1Connection* connection)
+{
+    if (!connection || connection->GetOwnerThread() == QThread::currentThread())
+        return connection;
+
+    if (!thread_connections.hasLocalData())
+        thread_connections.setLocalData(new QHash<QString, QSharedPointer<Q1Connection>>());
+
+    QHash<QString, QSharedPointer<Q1Connection>>* connections = thread_connections.localData();
+    QSharedPointer<Q1Connection>& clone = (*connections)[connection->GetConnectionName()];
+
+    if (!clone)
+        clone.reset(connection->Clone());
+
+    return clone.data();
+}
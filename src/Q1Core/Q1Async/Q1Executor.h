@@ -0,0 +1,24 @@
+#ifndef Q1EXECUTOR_H
+#define Q1EXECUTOR_H
+
+#include <QThreadPool>
+
+#include "../../Q1Core/Q1Context/Q1Connection.h"
+
+#include "../../Q1ORM_global.h"
+
+// Thread pool used by the async Q1Query / Q1Entity API.
+// Qt database connections may only be used from the thread that opened them, so
+// each pool thread works on its own clone of the caller's Q1Connection.
+class Q1ORM_EXPORT Q1Executor
+{
+public:
+    static QThreadPool* Pool();
+    static void SetMaxThreadCount(int count);
+
+    // Returns the connection itself on its owner thread, otherwise a clone that is
+    // created on first use and destroyed when the pool thread exits.
+    static Q1Connection* ThreadConnection(Q1Connection* connection);
+};
+
+#endif // Q1EXECUTOR_H
@@ -0,0 +1,292 @@
+#ifndef Q1TASK_H
+#define Q1TASK_H
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QObject>
+
+// Awaiter for the QFuture returned by the async Q1Query / Q1Entity API.
+// The coroutine is resumed by a QFutureWatcher living on the awaiting thread,
+// so it continues on that thread's event loop, never on a pool thread.
+// That thread must run an event loop (QCoreApplication::exec(), QEventLoop):
+// without one the watcher's signal is never delivered and co_await never returns.
+template<typename T>
+class Q1FutureAwaiter
+{
+public:
+    explicit Q1FutureAwaiter(QFuture<T> future)
+        : future(std::move(future)) {}
+
+    bool await_ready() const
+    {
+        return future.isFinished();
+    }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        QFutureWatcher<T>* watcher = new QFutureWatcher<T>();
+
+        QObject::connect(watcher, &QFutureWatcherBase::finished, watcher, [watcher, handle]() {
+            watcher->deleteLater();
+            handle.resume();
+        });
+
+        watcher->setFuture(future);
+    }
+
+    T await_resume()
+    {
+        if constexpr (!std::is_void_v<T>)
+        {
+            return future.result();
+        }
+    }
+
+private:
+    QFuture<T> future;
+};
+
+template<typename T>
+Q1FutureAwaiter<T> operator co_await(QFuture<T> future)
+{
+    return Q1FutureAwaiter<T>(std::move(future));
+}
+
+
+namespace Q1TaskDetail
+{
+struct PromiseBase
+{
+    std::coroutine_handle<> continuation;
+    std::exception_ptr exception;
+    bool detached = false;
+
+    std::suspend_never initial_suspend() const noexcept
+    {
+        return {};
+    }
+
+    void unhandled_exception()
+    {
+        exception = std::current_exception();
+    }
+};
+
+// Hands control back to whoever awaits the task. A task whose Q1Task object was
+// dropped before it finished cleans up its own frame here.
+template<typename Promise>
+struct FinalAwaiter
+{
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+    {
+        Promise& promise = handle.promise();
+
+        if (promise.continuation)
+            return promise.continuation;
+
+        if (promise.detached)
+            handle.destroy();
+
+        return std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept {}
+};
+}
+
+
+// Coroutine return type for chains of dependent queries:
+//
+//     Q1Task<int> CountCities(ApplicationDbContext& ctx)
+//     {
+//         std::optional<Country> country = co_await ctx.countries.InsertAsync(mexico);
+//         if (!country)
+//             co_return 0;
+//         co_return co_await ctx.cities.Select().Where(...).CountAsync();
+//     }
+//
+// The task starts eagerly and can itself be co_awaited. Dropping an unfinished
+// task lets it run to completion in the background.
+template<typename T = void>
+class Q1Task
+{
+public:
+    struct promise_type : Q1TaskDetail::PromiseBase
+    {
+        std::optional<T> value;
+
+        Q1Task get_return_object()
+        {
+            return Q1Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        Q1TaskDetail::FinalAwaiter<promise_type> final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void return_value(T result)
+        {
+            value = std::move(result);
+        }
+    };
+
+    Q1Task(Q1Task&& other) noexcept
+        : handle(std::exchange(other.handle, {})) {}
+
+    Q1Task(const Q1Task&) = delete;
+    Q1Task& operator=(const Q1Task&) = delete;
+
+    ~Q1Task()
+    {
+        Release();
+    }
+
+    bool IsFinished() const
+    {
+        return !handle || handle.done();
+    }
+
+    // Only valid once IsFinished() is true; a moved-from task returns T()
+    T Result()
+    {
+        Q_ASSERT_X(handle, "Q1Task::Result", "task was moved from");
+        if (handle && handle.promise().exception)
+            std::rethrow_exception(handle.promise().exception);
+
+        if constexpr (std::is_default_constructible_v<T>)
+        {
+            if (!handle || !handle.promise().value)
+                return T();
+        }
+
+        return std::move(*handle.promise().value);
+    }
+
+    bool await_ready() const noexcept
+    {
+        return IsFinished();
+    }
+
+    void await_suspend(std::coroutine_handle<> awaiting)
+    {
+        handle.promise().continuation = awaiting;
+    }
+
+    T await_resume()
+    {
+        return Result();
+    }
+
+private:
+    explicit Q1Task(std::coroutine_handle<promise_type> handle)
+        : handle(handle) {}
+
+    void Release()
+    {
+        if (!handle)
+            return;
+
+        if (handle.done())
+            handle.destroy();
+        else
+            handle.promise().detached = true;
+
+        handle = {};
+    }
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+template<>
+class Q1Task<void>
+{
+public:
+    struct promise_type : Q1TaskDetail::PromiseBase
+    {
+        Q1Task get_return_object()
+        {
+            return Q1Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        Q1TaskDetail::FinalAwaiter<promise_type> final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void return_void() {}
+    };
+
+    Q1Task(Q1Task&& other) noexcept
+        : handle(std::exchange(other.handle, {})) {}
+
+    Q1Task(const Q1Task&) = delete;
+    Q1Task& operator=(const Q1Task&) = delete;
+
+    ~Q1Task()
+    {
+        Release();
+    }
+
+    bool IsFinished() const
+    {
+        return !handle || handle.done();
+    }
+
+    void Result()
+    {
+        Q_ASSERT_X(handle, "Q1Task::Result", "task was moved from");
+        if (handle && handle.promise().exception)
+            std::rethrow_exception(handle.promise().exception);
+    }
+
+    bool await_ready() const noexcept
+    {
+        return IsFinished();
+    }
+
+    void await_suspend(std::coroutine_handle<> awaiting)
+    {
+        handle.promise().continuation = awaiting;
+    }
+
+    void await_resume()
+    {
+        Result();
+    }
+
+private:
+    explicit Q1Task(std::coroutine_handle<promise_type> handle)
+        : handle(handle) {}
+
+    void Release()
+    {
+        if (!handle)
+            return;
+
+        if (handle.done())
+            handle.destroy();
+        else
+            handle.promise().detached = true;
+
+        handle = {};
+    }
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+#endif // __cpp_impl_coroutine
+
+#endif // Q1TASK_H
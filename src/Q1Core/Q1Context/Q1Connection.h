@@ -1,21 +1,78 @@
 #ifndef Q1CONNECTION_H
 #define Q1CONNECTION_H
 
+#include <algorithm>
+#include <functional>
 #include <QString>
 #include <QStringList>
 #include <QDateTime>
 #include <QUuid>
 #include <QDebug>
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+#include <QReadWriteLock>
+#include <QRegularExpression>
 #include <QtGlobal>
+#include <QThread>
+#include <QSharedPointer>
 #include <QtSql/QSqlError>
 #include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlDriver>
+#include <QtSql/QSqlQuery>
 
+#include "../../Q1Core/Q1Diagnostics/Q1Instrumentation.h"
+#include "../../Q1Core/Q1Diagnostics/Q1SlowQueryLog.h"
 #include "../../Q1ORM_global.h"
 
 enum Q1Driver
 {
     POSTGRE_SQL,
-    SQLSERVER
+    SQLSERVER,
+    SQLITE
+};
+
+enum Q1ReadRouting
+{
+    ROUND_ROBIN,        // replicas in turn
+    LEAST_LATENCY       // replica with the lowest recent connect time
+};
+
+// Read replica added with Q1Connection::AddReplica()
+struct Q1ReplicaEndpoint
+{
+    QString host_name;
+    int port = 0;
+    std::function<QSqlDriver*()> driver_factory;
+};
+
+// ReadYourWrites session of one connection object, so of one thread: the owner
+// thread's connection and each pool thread's clone have their own
+struct Q1ReadSession
+{
+    QAtomicInteger<qint64> last_write_ms;
+    QAtomicInteger<quint32> next_replica;
+};
+
+// Observers of a connection, shared with its clones and replicas. Report() holds the
+// read lock while calling them, so once RemoveInstrumentation() returns no thread is
+// inside the removed observer and it may be deleted.
+struct Q1InstrumentationSet
+{
+    QReadWriteLock lock{QReadWriteLock::Recursive};
+    QList<Q1Instrumentation*> observers;
+};
+
+// Names a connection registered with QSqlDatabase; removes them when the last copy
+// of the connection lets go. Pool-thread clones and replicas would pile up otherwise.
+struct Q1DatabaseRegistration
+{
+    QString name;
+
+    ~Q1DatabaseRegistration()
+    {
+        QSqlDatabase::removeDatabase(name);
+        QSqlDatabase::removeDatabase("root-" + name);
+    }
 };
 
 class Q1ORM_EXPORT Q1Connection
@@ -38,14 +95,37 @@ public:
 
         database = QSqlDatabase::addDatabase(driver_name, name);
         root_database = QSqlDatabase::addDatabase(driver_name, "root-" + name);
+        registration.reset(new Q1DatabaseRegistration{name});
 
         ApplyConnectionSettings();
     }
 
+    // Connection served by a custom QSqlDriver (for example Q1MockDriver). driver only
+    // selects the SQL dialect; driver_factory creates one QSqlDriver per database handle.
+    Q1Connection(Q1Driver driver, std::function<QSqlDriver*()> driver_factory, QString database_name = QString())
+    {
+        this->driver = driver;
+        driver_name = drivers[driver];
+        port = 0;
+        this->database_name = database_name;
+        this->driver_factory = driver_factory;
+
+        database = QSqlDatabase::addDatabase(driver_factory(), name);
+        root_database = QSqlDatabase::addDatabase(driver_factory(), "root-" + name);
+        registration.reset(new Q1DatabaseRegistration{name});
+        database.setDatabaseName(database_name);
+    }
+
     ~Q1Connection()
     {
-        Disconnect();
+        Close();
         RootDisconnect();
+
+        // removeDatabase() needs every handle of the name gone first, ours included
+        replicas.clear();
+        database = QSqlDatabase();
+        root_database = QSqlDatabase();
+        registration.reset();
     }
 
 public: // Setter
@@ -87,6 +167,36 @@ public: // Setter
         ApplyConnectionSettings();
     }
 
+    // SQLite pragmas, applied every time the database is opened.
+    // journal_mode: DELETE, TRUNCATE, PERSIST, MEMORY, WAL or OFF (default WAL)
+    void SetJournalMode(QString journal_mode)
+    {
+        if (!SetPragma(this->journal_mode, journal_mode, {"DELETE", "TRUNCATE", "PERSIST", "MEMORY", "WAL", "OFF"}))
+            return;
+
+        if (is_open)
+            ApplyPragma("journal_mode", this->journal_mode);
+    }
+
+    // synchronous: OFF, NORMAL, FULL or EXTRA (default NORMAL, safe with WAL)
+    void SetSynchronous(QString synchronous)
+    {
+        if (!SetPragma(this->synchronous, synchronous, {"OFF", "NORMAL", "FULL", "EXTRA"}))
+            return;
+
+        if (is_open)
+            ApplyPragma("synchronous", this->synchronous);
+    }
+
+    // mmap_size in bytes; 0 keeps SQLite's default and disables memory-mapped I/O
+    void SetMmapSize(qint64 mmap_size)
+    {
+        this->mmap_size = qMax<qint64>(0, mmap_size);
+
+        if (is_open)
+            ApplyPragma("mmap_size", QString::number(this->mmap_size));
+    }
+
 public: // Getter
     Q1Driver GetDriver() const
     {
@@ -108,6 +218,11 @@ public: // Getter
         return driver == SQLSERVER;
     }
 
+    bool IsSqlite() const
+    {
+        return driver == SQLITE;
+    }
+
     QString GetHostName() const
     {
         return host_name;
@@ -128,6 +243,53 @@ public: // Getter
         return username;
     }
 
+    QString GetJournalMode() const
+    {
+        return journal_mode;
+    }
+
+    QString GetSynchronous() const
+    {
+        return synchronous;
+    }
+
+    qint64 GetMmapSize() const
+    {
+        return mmap_size;
+    }
+
+    QString GetConnectionName() const
+    {
+        return name;
+    }
+
+    QThread* GetOwnerThread() const
+    {
+        return owner_thread;
+    }
+
+    // New connection with the same settings, owned by the calling thread.
+    Q1Connection* Clone() const
+    {
+        if (driver_factory)
+        {
+            Q1Connection* clone = new Q1Connection(driver, driver_factory, database_name);
+            clone->CopyInstrumentation(*this);
+            clone->CopyReadRouting(*this);
+            return clone;
+        }
+
+        Q1Connection* clone = new Q1Connection(driver, host_name, database_name, username, password, port);
+        clone->memory_uri = memory_uri;
+        clone->ApplyConnectionSettings();
+        clone->journal_mode = journal_mode;
+        clone->synchronous = synchronous;
+        clone->mmap_size = mmap_size;
+        clone->CopyInstrumentation(*this);
+        clone->CopyReadRouting(*this);
+        return clone;
+    }
+
     QString QuoteIdentifier(const QString &identifier) const
     {
         if (IsSqlServer())
@@ -153,6 +315,273 @@ public: // Getter
         return QString("'%1'").arg(escaped);
     }
 
+public: // Read replicas
+    // Read-only copy of this database, reached with this connection's database name and
+    // credentials. Q1Entity sends selects, scalars and SELECT/WITH statements to the
+    // replicas; writes, transactions and migrations stay on this connection (the primary).
+    void AddReplica(QString host_name, int port = 0)
+    {
+        if (IsSqlite())
+        {
+            qWarning() << "Q1Connection: SQLite has no replicas, ignoring" << host_name;
+            return;
+        }
+
+        Q1ReplicaEndpoint endpoint;
+        endpoint.host_name = host_name;
+        endpoint.port = port != 0 ? port : ports[driver];
+        replica_endpoints.append(endpoint);
+    }
+
+    // Replica served by a custom QSqlDriver (for example Q1MockDriver)
+    void AddReplica(std::function<QSqlDriver*()> driver_factory)
+    {
+        Q1ReplicaEndpoint endpoint;
+        endpoint.driver_factory = driver_factory;
+        replica_endpoints.append(endpoint);
+    }
+
+    int GetReplicaCount() const
+    {
+        return replica_endpoints.size();
+    }
+
+    void SetReadRouting(Q1ReadRouting read_routing)
+    {
+        this->read_routing = read_routing;
+    }
+
+    Q1ReadRouting GetReadRouting() const
+    {
+        return read_routing;
+    }
+
+    // After a write, reads of this session go to the primary for window_ms so the
+    // caller sees its own changes despite replication lag. The session is this
+    // connection's thread: a write on one pool thread does not pin the others.
+    void SetReadYourWrites(bool enabled, int window_ms = 5000)
+    {
+        read_your_writes = enabled;
+        read_your_writes_ms = qMax(0, window_ms);
+    }
+
+    bool GetReadYourWrites() const
+    {
+        return read_your_writes;
+    }
+
+    // Called by Q1Entity before every write
+    void MarkWrite()
+    {
+        if (read_your_writes && !replica_endpoints.isEmpty())
+            read_session->last_write_ms.storeRelaxed(QDateTime::currentMSecsSinceEpoch());
+    }
+
+    bool IsPinnedToPrimary() const
+    {
+        if (!read_your_writes)
+            return false;
+
+        const qint64 last_write = read_session->last_write_ms.loadRelaxed();
+        return last_write > 0 && QDateTime::currentMSecsSinceEpoch() - last_write < read_your_writes_ms;
+    }
+
+    // Statements written by the caller (Q1Entity::ExecuteQuery and friends) may call
+    // functions with side effects that no SQL check can see, so they run on the
+    // primary unless this is enabled. Enabled, IsReadOnlyStatement() still applies.
+    void SetRawReadsOnReplicas(bool enabled)
+    {
+        raw_reads_on_replicas = enabled;
+    }
+
+    bool GetRawReadsOnReplicas() const
+    {
+        return raw_reads_on_replicas;
+    }
+
+    // Connection for a query Q1Query built: a connected replica, or this connection
+    // when there are none, all are down, the session is pinned or sql (if given) is
+    // not read-only. A replica that fails to connect is skipped for replica_retry_ms.
+    Q1Connection* ReadConnection(const QString &sql = QString())
+    {
+        if (replica_endpoints.isEmpty())
+            return this;
+
+        if (!sql.isEmpty() && !IsReadOnlyStatement(sql))
+        {
+            MarkWrite();
+            return this;
+        }
+
+        if (IsPinnedToPrimary())
+            return this;
+
+        const int count = replica_endpoints.size();
+        QList<int> order;
+        if (read_routing == LEAST_LATENCY)
+        {
+            for (int i = 0; i < count; ++i)
+                order.append(i);
+
+            // Unmeasured replicas (latency 0) come first so every replica gets measured
+            std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+                return Replica(a)->connect_latency_us < Replica(b)->connect_latency_us;
+            });
+        }
+        else
+        {
+            const int start = int(read_session->next_replica.fetchAndAddRelaxed(1) % quint32(count));
+            for (int i = 0; i < count; ++i)
+                order.append((start + i) % count);
+        }
+
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
+        for (int index : order)
+        {
+            Q1Connection* replica = Replica(index);
+            if (replica->down_until_ms > now)
+                continue;
+
+            if (replica->Connect())
+                return replica;
+
+            replica->down_until_ms = now + replica_retry_ms;
+            qWarning() << "Q1Connection: replica" << replica->host_name << "unavailable, reading from the primary";
+        }
+
+        return this;
+    }
+
+    // Connection for caller-written sql: this connection unless SetRawReadsOnReplicas()
+    Q1Connection* RawReadConnection(const QString &sql)
+    {
+        if (!raw_reads_on_replicas)
+        {
+            if (!IsReadOnlyStatement(sql))
+                MarkWrite();
+
+            return this;
+        }
+
+        return ReadConnection(sql);
+    }
+
+    bool IsReplica() const
+    {
+        return is_replica;
+    }
+
+    // Keyword heuristic: a SELECT or WITH that names none of
+    //   INSERT, UPDATE, DELETE, MERGE, INTO  data-modifying CTEs, SELECT INTO
+    //   FOR UPDATE / FOR SHARE               row locks (PostgreSQL, MySQL)
+    //   UPDLOCK, XLOCK, HOLDLOCK             row locks (SQL Server hints)
+    //   NEXTVAL, SETVAL, pg_advisory_*       sequence and advisory lock calls
+    // A keyword inside a literal or identifier also counts, which only costs a
+    // primary read. Side effects of other functions are not detected.
+    static bool IsReadOnlyStatement(const QString &sql)
+    {
+        const QString text = sql.trimmed();
+        if (!text.startsWith("SELECT", Qt::CaseInsensitive) && !text.startsWith("WITH", Qt::CaseInsensitive))
+            return false;
+
+        static const QRegularExpression writes("\\b(INSERT|UPDATE|DELETE|MERGE|INTO|SHARE|UPDLOCK|XLOCK|HOLDLOCK"
+                                               "|NEXTVAL|SETVAL|PG_ADVISORY_\\w+)\\b",
+                                               QRegularExpression::CaseInsensitiveOption);
+        return !writes.match(text).hasMatch();
+    }
+
+    // Moving average of the time database.open() took, in microseconds; 0 until measured
+    qint64 GetConnectLatencyUs() const
+    {
+        return connect_latency_us;
+    }
+
+public: // Instrumentation
+    // Observers are not owned. Clones and replicas share the list, so an observer added
+    // or removed here applies to pool threads too; after RemoveInstrumentation() returns
+    // it is no longer called from any thread and may be deleted.
+    void AddInstrumentation(Q1Instrumentation* instrumentation)
+    {
+        QWriteLocker locker(&instrumentations->lock);
+        if (instrumentation && !instrumentations->observers.contains(instrumentation))
+            instrumentations->observers.append(instrumentation);
+    }
+
+    void RemoveInstrumentation(Q1Instrumentation* instrumentation)
+    {
+        QWriteLocker locker(&instrumentations->lock);
+        instrumentations->observers.removeAll(instrumentation);
+    }
+
+    // True when statements need timing: observers are registered or the slow query log is on
+    bool HasInstrumentation() const
+    {
+        if (slow_query_threshold_ms >= 0)
+            return true;
+
+        QReadLocker locker(&instrumentations->lock);
+        return !instrumentations->observers.isEmpty();
+    }
+
+    // Statements taking at least threshold_ms (connect to hydrate) go to GetSlowQueryLog().
+    // A negative threshold turns the log off (the default).
+    void SetSlowQueryThreshold(int threshold_ms)
+    {
+        slow_query_threshold_ms = threshold_ms;
+
+        if (threshold_ms >= 0 && !slow_query_log)
+            slow_query_log = QSharedPointer<Q1SlowQueryLog>::create();
+
+        SyncReplicaInstrumentation();
+    }
+
+    int GetSlowQueryThreshold() const
+    {
+        return slow_query_threshold_ms;
+    }
+
+    // Re-runs slow SELECTs without bind values under EXPLAIN (FORMAT JSON) on PostgreSQL,
+    // SET SHOWPLAN_XML on SQL Server or EXPLAIN QUERY PLAN on SQLite and logs the plan
+    void SetExplainSlowQueries(bool explain)
+    {
+        explain_slow_queries = explain;
+        SyncReplicaInstrumentation();
+    }
+
+    bool GetExplainSlowQueries() const
+    {
+        return explain_slow_queries;
+    }
+
+    // Shared with clones; use SetFile() on it to write a rotating JSON-lines file
+    QSharedPointer<Q1SlowQueryLog> GetSlowQueryLog()
+    {
+        if (!slow_query_log)
+        {
+            slow_query_log = QSharedPointer<Q1SlowQueryLog>::create();
+            SyncReplicaInstrumentation();
+        }
+
+        return slow_query_log;
+    }
+
+    // Called by Q1StatementTimer while the statement's database handle is still open
+    void Report(const Q1StatementMetrics& metrics)
+    {
+        {
+            QReadLocker locker(&instrumentations->lock);
+            for (Q1Instrumentation* instrumentation : instrumentations->observers)
+                instrumentation->OnStatement(metrics);
+        }
+
+        if (slow_query_threshold_ms < 0 || !slow_query_log ||
+            metrics.TotalNs() < qint64(slow_query_threshold_ms) * 1000000)
+            return;
+
+        const QString plan = explain_slow_queries && metrics.success ? CapturePlan(metrics) : QString();
+        slow_query_log->Record(metrics, plan);
+    }
+
 public: // Error
     QString ErrorMessage() const
     {
@@ -210,6 +639,16 @@ public:
     {
         if(is_open) return true;
 
+        // Copies of a connection share the handle; reopening it would drop an in-memory database
+        if (IsSqlite() && database.isOpen())
+        {
+            is_open = true;
+            return true;
+        }
+
+        QElapsedTimer open_timer;
+        open_timer.start();
+
         if (!database.open())
         {
             error = database.lastError();
@@ -218,11 +657,27 @@ public:
             return false;
         }
 
+        const qint64 latency_us = qMax<qint64>(1, open_timer.nsecsElapsed() / 1000);
+        connect_latency_us = connect_latency_us == 0 ? latency_us : (3 * connect_latency_us + latency_us) / 4;
         is_open = true;
+
+        if (IsSqlite())
+            ApplyPragmas();
+
         return true;
     }
 
+    // SQLite is in-process: the handle stays open (and an in-memory database alive)
+    // until the connection is destroyed or Close() is called.
     void Disconnect()
+    {
+        if (IsSqlite())
+            return;
+
+        Close();
+    }
+
+    void Close()
     {
         if(is_open)
         {
@@ -241,8 +696,23 @@ public:
 private: // Connection Parameters
     void ApplyConnectionSettings()
     {
+        if (IsSqlite() && database_name == ":memory:")
+        {
+            // a plain :memory: database is private to its handle, so clones and the
+            // root handle would each see an empty one; a named shared-cache database
+            // lives as long as any of them keeps it open
+            if (memory_uri.isEmpty())
+                memory_uri = QString("file:%1?mode=memory&cache=shared").arg(name);
+
+            ConfigureDatabase(database, memory_uri);
+            ConfigureDatabase(root_database, memory_uri);
+            return;
+        }
+
         ConfigureDatabase(database, database_name);
-        ConfigureDatabase(root_database, default_databases[driver]);
+
+        // SQLite has no server: the root handle points at the database file itself
+        ConfigureDatabase(root_database, IsSqlite() ? database_name : default_databases[driver]);
     }
 
     void ConfigureDatabase(QSqlDatabase &db, const QString &target_database_name)
@@ -258,6 +728,15 @@ private: // Connection Parameters
             return;
         }
 
+        if (IsSqlite())
+        {
+            db.setHostName(QString());
+            db.setPort(0);
+            db.setConnectOptions(target_database_name.startsWith("file:") ? "QSQLITE_OPEN_URI" : QString());
+            db.setDatabaseName(target_database_name);
+            return;
+        }
+
         db.setHostName(host_name);
         db.setPort(port);
         db.setDatabaseName(target_database_name);
@@ -295,24 +774,167 @@ private: // Connection Parameters
             .arg(odbc_driver, server, target_database_name);
     }
 
+    Q1Connection* Replica(int index)
+    {
+        while (replicas.size() < replica_endpoints.size())
+            replicas.append(QSharedPointer<Q1Connection>());
+
+        if (!replicas[index])
+        {
+            // Created on first use, on the thread that reads through this connection
+            const Q1ReplicaEndpoint &endpoint = replica_endpoints[index];
+            replicas[index] = endpoint.driver_factory
+                                  ? QSharedPointer<Q1Connection>::create(driver, endpoint.driver_factory, database_name)
+                                  : QSharedPointer<Q1Connection>::create(driver, endpoint.host_name, database_name,
+                                                                         username, password, endpoint.port);
+            replicas[index]->is_replica = true;
+            replicas[index]->CopyInstrumentation(*this);
+        }
+
+        return replicas[index].data();
+    }
+
+    // Statements on a replica report to this connection's observers and slow query
+    // log; the replica captures their plans on its own handle
+    void CopyInstrumentation(const Q1Connection &other)
+    {
+        instrumentations = other.instrumentations;     // shared, not copied
+        slow_query_threshold_ms = other.slow_query_threshold_ms;
+        slow_query_log = other.slow_query_log;
+        explain_slow_queries = other.explain_slow_queries;
+    }
+
+    void SyncReplicaInstrumentation()
+    {
+        for (const QSharedPointer<Q1Connection> &replica : replicas)
+        {
+            if (replica)
+                replica->CopyInstrumentation(*this);
+        }
+    }
+
+    void CopyReadRouting(const Q1Connection &other)
+    {
+        replica_endpoints = other.replica_endpoints;
+        read_routing = other.read_routing;
+        read_your_writes = other.read_your_writes;
+        read_your_writes_ms = other.read_your_writes_ms;
+        raw_reads_on_replicas = other.raw_reads_on_replicas;
+    }
+
+    QString CapturePlan(const Q1StatementMetrics &metrics)
+    {
+        const QString sql = metrics.sql.trimmed();
+        if (!metrics.binds.isEmpty() || !database.isOpen() ||
+            !(sql.startsWith("SELECT", Qt::CaseInsensitive) || sql.startsWith("WITH", Qt::CaseInsensitive)))
+            return QString();
+
+        QSqlQuery sql_query(database);
+        QStringList plan;
+
+        if (IsSqlServer())
+        {
+            // SHOWPLAN must be alone in its batch; the statement then returns its plan instead of running
+            if (!sql_query.exec("SET SHOWPLAN_XML ON"))
+                return QString();
+
+            if (sql_query.exec(sql))
+            {
+                while (sql_query.next())
+                    plan << sql_query.value(0).toString();
+            }
+
+            QSqlQuery(database).exec("SET SHOWPLAN_XML OFF");
+            return plan.join("\n");
+        }
+
+        const QString explain = IsSqlite() ? "EXPLAIN QUERY PLAN " : "EXPLAIN (FORMAT JSON) ";
+        if (!sql_query.exec(explain + sql))
+        {
+            qWarning() << "Q1Connection: EXPLAIN failed:" << sql_query.lastError().text();
+            return QString();
+        }
+
+        while (sql_query.next())
+            plan << sql_query.value(IsSqlite() ? 3 : 0).toString();
+
+        return plan.join("\n");
+    }
+
+    bool SetPragma(QString &target, const QString &value, const QStringList &allowed)
+    {
+        const QString normalized = value.trimmed().toUpper();
+        if (!allowed.contains(normalized))
+        {
+            qWarning() << "Q1Connection: unsupported SQLite pragma value" << value;
+            return false;
+        }
+
+        target = normalized;
+        return true;
+    }
+
+    void ApplyPragmas()
+    {
+        // Foreign keys are off per connection by default; match the server dialects
+        ApplyPragma("foreign_keys", "ON");
+        ApplyPragma("journal_mode", journal_mode);
+        ApplyPragma("synchronous", synchronous);
+
+        if (mmap_size > 0)
+            ApplyPragma("mmap_size", QString::number(mmap_size));
+    }
+
+    void ApplyPragma(const QString &pragma, const QString &value)
+    {
+        QSqlQuery sql_query(database);
+        if (!sql_query.exec(QString("PRAGMA %1 = %2").arg(pragma, value)))
+            qWarning() << "Q1Connection: PRAGMA" << pragma << "failed:" << sql_query.lastError().text();
+    }
+
     Q1Driver driver;
     QString driver_name;
+    std::function<QSqlDriver*()> driver_factory;
 
     QString host_name;
     int port;
 
     QString name = "conn_" + QUuid::createUuid().toString().remove('{').remove('}').remove('-');
+    QSharedPointer<Q1DatabaseRegistration> registration;   // shared by copies (Q1Migration holds one)
+    QThread* owner_thread = QThread::currentThread();
     QString database_name;
+    QString memory_uri;     // SQLite :memory:, shared with clones
     QString username;
     QString password;
 
     bool is_open = false;
     bool root_is_open = false;
 
+    QSharedPointer<Q1InstrumentationSet> instrumentations = QSharedPointer<Q1InstrumentationSet>::create();
+    QSharedPointer<Q1SlowQueryLog> slow_query_log;
+    int slow_query_threshold_ms = -1;
+    bool explain_slow_queries = false;
+
+    QList<Q1ReplicaEndpoint> replica_endpoints;
+    QList<QSharedPointer<Q1Connection>> replicas;    // per endpoint, created by Replica()
+    Q1ReadRouting read_routing = ROUND_ROBIN;
+    bool read_your_writes = false;
+    int read_your_writes_ms = 5000;
+    bool raw_reads_on_replicas = false;
+    QSharedPointer<Q1ReadSession> read_session = QSharedPointer<Q1ReadSession>::create();
+    bool is_replica = false;
+    qint64 connect_latency_us = 0;
+    qint64 down_until_ms = 0;
+    int replica_retry_ms = 30000;
+
+    QString journal_mode = "WAL";
+    QString synchronous = "NORMAL";
+    qint64 mmap_size = 0;
+
 private: // Defaults
-    QStringList default_databases = {"postgres", "master"};
-    QStringList drivers = {"QPSQL", "QODBC"};
-    QList<int> ports = {5432, 1433};
+    QStringList default_databases = {"postgres", "master", ""};
+    QStringList drivers = {"QPSQL", "QODBC", "QSQLITE"};
+    QList<int> ports = {5432, 1433, 0};
 };
 
 #endif // Q1CONNECTION_H
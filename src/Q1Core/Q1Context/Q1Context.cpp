@@ -1,8 +1,46 @@
 #include "Q1Context.h"
 #include <algorithm>
+#include <functional>
+
+#include <QAtomicInt>
+#include <QFuture>
+#include <QVector>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include "Q1Core/Q1Async/Q1Executor.h"
+
+namespace
+{
+// Runs work(0 .. count-1) on up to parallelism pool threads. Each thread uses its
+// Q1Executor clone of connection through its own Q1Migration, so items never
+// share a database handle. Blocks until every item is done.
+void ForEachParallel(Q1Connection* connection, int parallelism, int count,
+                     const std::function<void(int, Q1Migration&)>& work)
+{
+    QAtomicInt next(0);
+    QList<QFuture<void>> workers;
+
+    for (int i = 0; i < qMin(parallelism, count); ++i)
+    {
+        workers.append(QtConcurrent::run(Q1Executor::Pool(), [connection, count, &next, &work]() {
+            Q1Migration migration(*Q1Executor::ThreadConnection(connection));
+            for (int item = next.fetchAndAddRelaxed(1); item < count; item = next.fetchAndAddRelaxed(1))
+                work(item, migration);
+        }));
+    }
+
+    for (QFuture<void>& worker : workers)
+        worker.waitForFinished();
+}
+}
 
 Q1Context::~Q1Context()
 {
+    DisableQueryCounter();
+
+    delete view_refresher;
+    view_refresher = nullptr;
+
     if (query)
     {
         delete query;
@@ -31,6 +69,15 @@ bool Q1Context::Initialize()
 
     database_name = connection->GetDatabaseName();
 
+#ifdef QT_DEBUG
+    if (!query_counter)
+        query_counter = new Q1QueryCounter();
+#endif
+
+    // EnableQueryCounter() may have run before OnConfiguration() set the connection
+    if (query_counter)
+        connection->AddInstrumentation(query_counter);
+
     if (query)
     {
         delete query;
@@ -38,6 +85,38 @@ bool Q1Context::Initialize()
     }
 
     query = new Q1Migration(*connection);
+    query->SetOnlineMigrations(online_migrations);
+    migration_plan = query->CreatePlan();
+    planned_tables.clear();
+
+    tables.clear();
+    views.clear();
+    for (Q1Table* table : OnTablesCreating())
+    {
+        if (table && table->IsView())
+            views.append(table);
+        else
+            tables.append(table);
+    }
+    QList<Q1Relation> allRelations = OnTableRelationCreating();
+
+    // Warm start: the database already has this exact model, so skip all introspection
+    const QString fingerprint = Q1Migration::ModelFingerprint(tables + views, allRelations, DeclaredIndexes(allRelations));
+    if (use_model_fingerprint && query->GetModelFingerprint() == fingerprint)
+    {
+        qDebug() << "Q1Context::Initialize - model unchanged, skipping schema checks";
+
+        if (!connection->Connect())
+        {
+            qCritical() << "Q1Context::Initialize - cannot connect:" << connection->ErrorMessage();
+            return false;
+        }
+
+        // Time moves on even when the model does not
+        MaintainPartitions();
+        StartViewRefresh();
+        return true;
+    }
 
     InitialDatabase();
 
@@ -47,17 +126,171 @@ bool Q1Context::Initialize()
         return false;
     }
 
-    tables = OnTablesCreating();
+    // One catalog read for the whole diff; without it every table and relation
+    // falls back to its own GetColumns()/ConstraintExists() round trip
+    if (!query->LoadSchemaSnapshot(schema))
+        qWarning() << "Q1Context::Initialize - schema snapshot failed, reading the catalog per table";
 
-    InitialTables();
-    InitialColumns();
+    schema_incomplete = false;
 
-    QList<Q1Relation> allRelations = OnTableRelationCreating();
+    InitialTables(allRelations);
+    if (!MaintainPartitions())
+        schema_incomplete = true;
+    DropStaleViews();
+    InitialColumns();
     InitialRelations(allRelations);
+    InitialIndexes(allRelations);
+    InitialViews();
+    StartViewRefresh();
+
+    if (dry_run_migrations && !migration_plan.IsEmpty())
+        qDebug().noquote() << "Q1Context::Initialize - dry run, not applied:\n" + migration_plan.ToSql();
+
+    // Only a model that was applied without errors may skip the checks next time
+    if (use_model_fingerprint && !schema_incomplete)
+        query->SetModelFingerprint(fingerprint);
 
     return true;
 }
 
+bool Q1Context::MaintainPartitions()
+{
+    if (!query)
+        return false;
+
+    bool success = true;
+    for (const Q1Table* table : tables)
+    {
+        if (!table || !table->IsPartitioned())
+            continue;
+
+        // Expired partitions are not listed: finding them needs the partition catalog
+        if (dry_run_migrations)
+        {
+            migration_plan.CreatePartitions(*table, QDate::currentDate());
+            schema_incomplete = true;
+            continue;
+        }
+
+        if (!query->MaintainPartitions(*table))
+        {
+            qWarning() << "MaintainPartitions - failed for" << table->GetName() << "-" << query->ErrorMessage();
+            success = false;
+        }
+    }
+
+    return success;
+}
+
+bool Q1Context::RefreshView(const QString &view_name)
+{
+    if (!view_refresher || !view_refresher->HasView(view_name))
+    {
+        qWarning() << "Q1Context::RefreshView - not a declared view:" << view_name;
+        return false;
+    }
+
+    return view_refresher->Refresh(view_name);
+}
+
+void Q1Context::DropStaleViews()
+{
+    if (!query)
+        return;
+
+    for (const Q1Table* view : views)
+    {
+        bool exists = false;
+        if (query->IsViewCurrent(*view, &exists) || !exists)
+            continue;
+
+        qDebug() << "DropStaleViews - declaration changed, dropping view:" << view->GetName();
+
+        if (dry_run_migrations)
+        {
+            schema_incomplete = true;
+            continue;
+        }
+
+        if (!query->DropView(*view))
+        {
+            qWarning() << "DropStaleViews - failed to drop view:" << view->GetName() << "-" << query->ErrorMessage();
+            schema_incomplete = true;
+        }
+    }
+}
+
+void Q1Context::InitialViews()
+{
+    if (!query)
+        return;
+
+    for (const Q1Table* view : views)
+    {
+        bool exists = false;
+        if (query->IsViewCurrent(*view, &exists))
+            continue;
+
+        // Still there: DropStaleViews() could not remove it
+        if (exists || dry_run_migrations)
+        {
+            schema_incomplete = true;
+            continue;
+        }
+
+        if (!query->CreateView(*view))
+        {
+            qWarning() << "InitialViews - failed to create view:" << view->GetName() << "-" << query->ErrorMessage();
+            schema_incomplete = true;
+        }
+        else
+        {
+            qDebug() << "InitialViews - view created:" << view->GetName();
+        }
+    }
+}
+
+void Q1Context::StartViewRefresh()
+{
+    delete view_refresher;
+    view_refresher = nullptr;
+
+    if (views.isEmpty())
+        return;
+
+    view_refresher = new Q1ViewRefresher(connection);
+    for (const Q1Table* view : views)
+        view_refresher->Add(*view);
+}
+
+void Q1Context::EnableQueryCounter(int threshold, Q1QueryCounterMode mode)
+{
+    if (!query_counter)
+        query_counter = new Q1QueryCounter(threshold, mode);
+    else
+    {
+        query_counter->SetThreshold(threshold);
+        query_counter->SetMode(mode);
+    }
+
+    if (connection)
+        connection->AddInstrumentation(query_counter);
+}
+
+void Q1Context::DisableQueryCounter()
+{
+    if (!query_counter)
+        return;
+
+    // Pool-thread clones share the connection's observer list, so none of them
+    // calls the counter once this returns
+    if (connection)
+        connection->RemoveInstrumentation(query_counter);
+
+    delete query_counter;
+    query_counter = nullptr;
+}
+
 void Q1Context::InitialDatabase()
 {
     if (!connection || !query) return;
@@ -97,12 +330,13 @@ void Q1Context::InitialDatabase()
     }
 }
 
-void Q1Context::InitialTables()
+void Q1Context::InitialTables(const QList<Q1Relation> &relations)
 {
     if (!query || !connection) return;
 
-    QStringList database_tables = query->GetTables();
+    QStringList database_tables = schema.IsLoaded() ? schema.Tables() : query->GetTables();
 
+    QList<Q1Table> missing_tables;
     for (Q1Table* table : tables)
     {
         if (!table) continue;
@@ -121,34 +355,113 @@ void Q1Context::InitialTables()
                 q1table.columns.append(column);
             }
 
-            if (!query->CreateTableWithColumns(q1table))
+            // Dialects without ALTER TABLE ... ADD CONSTRAINT (SQLite) declare the
+            // foreign keys that land on this table inside CREATE TABLE, wherever
+            // the relation was declared
+            q1table.relations = relations;
+            for (Q1Table* other : tables)
             {
-                qWarning() << "InitialTables - failed to create table:"
-                           << table_name << "-" << query->ErrorMessage();
+                if (other)
+                    q1table.relations.append(other->GetRelations());
             }
-            else
+
+            if (dry_run_migrations)
             {
-                qDebug() << "InitialTables - table created successfully:" << table_name;
+                migration_plan.CreateTable(q1table);
+                planned_tables << table_name.toLower();
+                schema_incomplete = true;
+                continue;
             }
+
+            missing_tables.append(q1table);
         }
         else
         {
             qDebug() << "InitialTables - table already exists:" << table_name;
         }
     }
+
+    // Foreign keys are added by InitialRelations afterwards, so the tables are independent.
+    // Workers write through raw pointers: each index belongs to exactly one of them.
+    QVector<QString> errors(missing_tables.size());
+    QVector<bool> results(missing_tables.size(), false);
+    Q1Table *pending = missing_tables.data();
+    QString *error_slots = errors.data();
+    bool *result_slots = results.data();
+
+    auto create = [pending, error_slots, result_slots](int i, Q1Migration &migration) {
+        result_slots[i] = migration.CreateTableWithColumns(pending[i]);
+        error_slots[i] = migration.ErrorMessage();
+    };
+
+    if (InitializeParallelism() > 1)
+    {
+        ForEachParallel(connection, InitializeParallelism(), missing_tables.size(), create);
+    }
+    else
+    {
+        for (int i = 0; i < missing_tables.size(); ++i)
+            create(i, *query);
+    }
+
+    bool created = false;
+    for (int i = 0; i < missing_tables.size(); ++i)
+    {
+        if (!results[i])
+        {
+            qWarning() << "InitialTables - failed to create table:"
+                       << missing_tables[i].GetName() << "-" << errors[i];
+            schema_incomplete = true;
+        }
+        else
+        {
+            qDebug() << "InitialTables - table created successfully:" << missing_tables[i].GetName();
+            created = true;
+        }
+    }
+
+    // New tables (and SQLite's inline foreign keys) enter the snapshot with one more read
+    if (created && schema.IsLoaded())
+        query->LoadSchemaSnapshot(schema);
 }
 
 void Q1Context::InitialColumns()
 {
     if (!query) return;
 
-    for (Q1Table* table : tables)
+    // Without a snapshot every table needs its own catalog query; fan them out
+    QVector<QList<Q1Column>> fetched(tables.size());
+    if (!schema.IsLoaded() && InitializeParallelism() > 1)
+    {
+        const QList<Q1Table*> declared = tables;
+        QList<Q1Column> *column_slots = fetched.data();
+        ForEachParallel(connection, InitializeParallelism(), declared.size(), [&declared, column_slots](int i, Q1Migration &migration) {
+            if (declared.at(i))
+                column_slots[i] = migration.GetColumns(declared.at(i)->GetName());
+        });
+    }
+
+    // Every column change of every table is planned first and applied as one batch
+    Q1MigrationPlan plan = query->CreatePlan();
+
+    for (int t = 0; t < tables.size(); ++t)
     {
+        Q1Table* table = tables[t];
         if (!table) continue;
 
+        // A dry run's CREATE TABLE already has the columns
         QString table_name = table->GetName();
+        if (planned_tables.contains(table_name.toLower()))
+            continue;
+
         QList<Q1Column> declaredColumns = table->GetColumns();
-        QList<Q1Column> existingColumns = query->GetColumns(table_name);
+        QList<Q1Column> existingColumns;
+        if (schema.IsLoaded())
+            existingColumns = schema.Columns(table_name);
+        else if (InitializeParallelism() > 1)
+            existingColumns = fetched.at(t);
+        else
+            existingColumns = query->GetColumns(table_name);
 
         // Drop columns not declared
         for (Q1Column &dbCol : existingColumns)
@@ -158,17 +471,14 @@ void Q1Context::InitialColumns()
             {
                 if (declCol == dbCol)
                 {
-                    CompareColumn(table_name, dbCol, declCol);
+                    CompareColumn(table_name, dbCol, declCol, plan);
                     found = true;
                     break;
                 }
             }
 
             if (!found)
-            {
-                qDebug() << "InitialColumns - dropping column" << dbCol.name << "from" << table_name;
-                query->DropColumn(table_name, dbCol.name);
-            }
+                plan.DropColumn(table_name, dbCol.name);
         }
 
         // Add missing columns
@@ -176,31 +486,89 @@ void Q1Context::InitialColumns()
         {
             int idx = Q1Column::IndexOf(existingColumns, declCol);
             if (idx == -1)
-            {
-                qDebug() << "InitialColumns - adding column" << declCol.name << "to" << table_name;
-                query->AddColumn(table_name, declCol);
-            }
+                plan.AddColumn(table_name, declCol);
         }
     }
+
+    migration_plan.Append(plan);
+
+    for (const QString &reason : plan.Skipped())
+    {
+        qWarning() << "InitialColumns - skipped:" << reason;
+        schema_incomplete = true;
+    }
+
+    if (plan.IsEmpty())
+        return;
+
+    qDebug().noquote() << "InitialColumns - migration plan:\n" + plan.ToSql();
+
+    if (dry_run_migrations)
+    {
+        schema_incomplete = true;
+        return;
+    }
+
+    if (InitializeParallelism() <= 1)
+    {
+        if (!query->ExecutePlan(plan))
+        {
+            qWarning() << "InitialColumns - migration plan failed:" << query->ErrorMessage();
+            schema_incomplete = true;
+        }
+        return;
+    }
+
+    // One transaction per table, tables in parallel: atomic per table, not per schema
+    const QList<Q1MigrationPlan> table_plans = plan.SplitByTable();
+    QVector<QString> errors(table_plans.size());
+    QString *error_slots = errors.data();
+    ForEachParallel(connection, InitializeParallelism(), table_plans.size(), [&table_plans, error_slots](int i, Q1Migration &migration) {
+        if (!migration.ExecutePlan(table_plans.at(i)))
+            error_slots[i] = migration.ErrorMessage();
+    });
+
+    for (const QString &error : errors)
+    {
+        if (error.isEmpty()) continue;
+
+        qWarning() << "InitialColumns - table migration failed:" << error;
+        schema_incomplete = true;
+    }
+}
+
+int Q1Context::InitializeParallelism() const
+{
+    // One SQLite file takes one writer at a time; clones would only wait on its lock
+    if (!connection || connection->IsSqlite())
+        return 1;
+
+    return qMax(1, initialize_parallelism);
 }
 
-void Q1Context::CompareColumn(const QString &table_name, Q1Column &dbColumn, Q1Column &declColumn)
+void Q1Context::CompareColumn(const QString &table_name, Q1Column &dbColumn, Q1Column &declColumn,
+                              Q1MigrationPlan &plan)
 {
     if (!query) return;
 
     if (dbColumn.size != declColumn.size)
-        query->UpdateColumnSize(table_name, declColumn.name, declColumn.size);
+        plan.UpdateColumnSize(table_name, declColumn.name, declColumn.size);
 
     if (dbColumn.nullable != declColumn.nullable)
     {
         if (declColumn.nullable)
         {
-            query->SetColumnNullable(table_name, dbColumn.name);
+            plan.SetColumnNullable(table_name, dbColumn.name);
+        }
+        else if (!query->HasNullData(table_name, dbColumn.name))
+        {
+            plan.DropColumnNullable(table_name, dbColumn.name);
         }
         else
         {
-            if (!query->HasNullData(table_name, dbColumn.name))
-                query->DropColumnNullable(table_name, dbColumn.name);
+            // Left nullable while NULLs exist, so the difference remains
+            qWarning() << "InitialColumns -" << table_name << dbColumn.name << "has NULLs, keeping it nullable";
+            schema_incomplete = true;
         }
     }
 
@@ -211,9 +579,9 @@ void Q1Context::CompareColumn(const QString &table_name, Q1Column &dbColumn, Q1C
         !Q1Column::DefaultsMatch(dbColumn.default_value, declColumn.default_value))
     {
         if (!declColumn.default_value.isEmpty())
-            query->setColumnDefault(table_name, declColumn.name, declColumn.default_value);
+            plan.SetColumnDefault(table_name, declColumn.name, declColumn.default_value);
         else if (!dbColumn.default_value.isEmpty())
-            query->DropColumnDefault(table_name, declColumn.name);
+            plan.DropColumnDefault(table_name, declColumn.name);
     }
 }
 
@@ -225,14 +593,20 @@ void Q1Context::InitialRelations(const QList<Q1Relation> &relations)
     if (!connection->Connect())
         return;
 
-    QStringList existingTables = connection->database.tables();
+    QStringList existingTables = schema.IsLoaded() ? schema.Tables() : connection->database.tables();
     for (QString &t : existingTables) t = t.toLower();
+    existingTables.append(planned_tables);
 
     for (const Q1Relation &rel : relations)
     {
         if (rel.base_table.isEmpty() || rel.top_table.isEmpty())
             continue;
 
+        // SQLite declares them inside the planned CREATE TABLE
+        if (connection->IsSqlite() && (planned_tables.contains(rel.base_table.toLower()) ||
+                                       planned_tables.contains(rel.top_table.toLower())))
+            continue;
+
         if (!existingTables.contains(rel.base_table.toLower()) ||
             !existingTables.contains(rel.top_table.toLower()))
         {
@@ -243,17 +617,189 @@ void Q1Context::InitialRelations(const QList<Q1Relation> &relations)
 
         const QString constraint_name = rel.GetConstraintName();
 
-        if (query->ConstraintExists(connection->database, constraint_name.toLower()))
+        const bool exists = schema.IsLoaded()
+                                ? schema.HasConstraint(constraint_name)
+                                : query->ConstraintExists(connection->database, constraint_name.toLower());
+        if (exists)
         {
             qDebug() << "[Info] Relation already exists, skipping:" << constraint_name;
             continue;
         }
 
-        if (!query->AddRelation(rel))
+        if (dry_run_migrations)
+        {
+            migration_plan.AddRelation(rel);
+            schema_incomplete = true;
+            continue;
+        }
+
+        if (!query->AddRelation(rel, &schema))
+        {
             qWarning() << "[Error] Failed to create relation:" << query->ErrorMessage();
+            schema_incomplete = true;
+        }
         else
+        {
             qDebug() << "[Info] Relation created successfully:" << constraint_name;
+            schema.AddConstraint(constraint_name);
+        }
     }
 
     connection->Disconnect();
 }
+
+QList<Q1Index> Q1Context::DeclaredIndexes(const QList<Q1Relation> &relations) const
+{
+    QList<Q1Index> indexes;
+    QStringList names;
+
+    auto add = [&indexes, &names](const Q1Index &index) {
+        if (!index.IsValid() || names.contains(index.GetName(), Qt::CaseInsensitive))
+            return;
+
+        names << index.GetName();
+        indexes << index;
+    };
+
+    for (const Q1Table* table : tables)
+    {
+        if (!table) continue;
+
+        // Index() may run before ToTableName(); the table decides
+        for (Q1Index index : table->GetIndexes())
+        {
+            index.table = table->GetName();
+            index.concurrently = !table->IsPartitioned();
+            add(index);
+        }
+    }
+
+    if (!index_foreign_keys || !query)
+        return indexes;
+
+    QList<Q1Relation> all_relations = relations;
+    for (const Q1Table* table : tables)
+    {
+        if (table)
+            all_relations.append(table->GetRelations());
+    }
+
+    for (const Q1Relation &relation : all_relations)
+    {
+        Q1Index index = query->ForeignKeyIndex(relation);
+        if (!index.IsValid())
+            continue;
+
+        const Q1Column* column = nullptr;
+        bool covered = false;
+        for (const Q1Table* table : tables)
+        {
+            if (table && table->GetName().compare(index.table, Qt::CaseInsensitive) == 0)
+            {
+                column = table->FindColumn(index.columns.first());
+                covered = table->HasIndexOn(index.columns.first());
+                index.concurrently = !table->IsPartitioned();
+                break;
+            }
+        }
+
+        // Junction tables are not declared; their column always exists
+        if (covered || (!column && relation.type != MANY_TO_MANY))
+            continue;
+
+        add(index);
+    }
+
+    return indexes;
+}
+
+void Q1Context::InitialIndexes(const QList<Q1Relation> &relations)
+{
+    if (!query || !connection)
+        return;
+
+    const QList<Q1Index> indexes = DeclaredIndexes(relations);
+
+    QStringList existingTables;
+    if (schema.IsLoaded())
+    {
+        existingTables = schema.Tables();
+    }
+    else if (connection->Connect())
+    {
+        existingTables = connection->database.tables();
+        connection->Disconnect();
+    }
+    for (QString &t : existingTables) t = t.toLower();
+    existingTables.append(planned_tables);
+
+    QStringList declared;
+    for (const Q1Index &index : indexes)
+    {
+        declared << index.GetName().toLower();
+
+        if (!existingTables.contains(index.table.toLower()))
+            continue;
+
+        const bool exists = schema.IsLoaded() ? schema.HasIndex(index.GetName())
+                                              : query->IndexExists(index.GetName());
+        if (exists)
+            continue;
+
+        qDebug() << "InitialIndexes - creating index:" << index.GetName()
+                 << (index.automatic ? "(foreign key)" : "");
+
+        if (dry_run_migrations)
+        {
+            migration_plan.CreateIndex(index);
+            schema_incomplete = true;
+            continue;
+        }
+
+        if (!query->CreateIndex(index))
+        {
+            qWarning() << "InitialIndexes - failed to create index:" << index.GetName() << "-" << query->ErrorMessage();
+            schema_incomplete = true;
+        }
+        else if (schema.IsLoaded())
+        {
+            schema.AddIndex(index.table, index.GetName());
+        }
+    }
+
+    // Indexes that left the model are dropped only on request, and only the ones named
+    // by Q1Index; without a snapshot there is no list to compare against
+    if (!drop_undeclared_indexes || !schema.IsLoaded())
+        return;
+
+    for (const Q1Table* table : tables)
+    {
+        if (!table) continue;
+
+        const QString table_name = table->GetName();
+        for (const QString &index_name : schema.Indexes(table_name))
+        {
+            if (declared.contains(index_name.toLower()) || !Q1Index::IsGeneratedName(table_name, index_name))
+                continue;
+
+            qDebug() << "InitialIndexes - dropping index no longer in the model:" << index_name;
+
+            if (dry_run_migrations)
+            {
+                migration_plan.DropIndex(table_name, index_name, !table->IsPartitioned());
+                schema_incomplete = true;
+                continue;
+            }
+
+            if (!query->DropIndex(table_name, index_name, !table->IsPartitioned()))
+            {
+                qWarning() << "InitialIndexes - failed to drop index:" << index_name << "-" << query->ErrorMessage();
+                schema_incomplete = true;
+            }
+            else
+            {
+                schema.RemoveIndex(table_name, index_name);
+            }
+        }
+    }
+}
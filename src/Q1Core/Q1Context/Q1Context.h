@@ -9,6 +9,8 @@
 #include "../Q1Entity/Q1Column.h"
 #include "../Q1Entity/Q1Relation.h"
 #include "Q1Connection.h"
+#include "Q1ViewRefresher.h"
+#include "Q1Core/Q1Diagnostics/Q1QueryCounter.h"
 #include "Q1Core/Q1Migration/Q1Migration.h"
 
 class Q1ORM_EXPORT Q1Context
@@ -33,6 +35,37 @@ public:
         return QString();
     }
 
+    // Counts statements per SQL shape inside Q1QueryScope blocks and reports shapes
+    // that repeat more than threshold times. Debug builds enable it in Initialize().
+    void EnableQueryCounter(int threshold = 10, Q1QueryCounterMode mode = Q1QueryCounterMode::Warn);
+    void DisableQueryCounter();
+
+    // Pre-creates upcoming partitions and drops expired ones for every partitioned
+    // table. Initialize() runs it; long-running processes should call it daily.
+    bool MaintainPartitions();
+
+    // Recomputes a materialized view now, on the calling thread. Views with a
+    // refresh interval are also refreshed in the background (see Q1ViewRefresher).
+    bool RefreshView(const QString &view_name);
+
+    Q1ViewRefresher* GetViewRefresher() const
+    {
+        return view_refresher;
+    }
+
+    // Column changes computed by the last Initialize(), and in a dry run every other
+    // schema change too; ToSql() shows them for review
+    const Q1MigrationPlan& GetMigrationPlan() const
+    {
+        return migration_plan;
+    }
+
+    // Null while the counter is disabled; Q1QueryScope accepts that
+    Q1QueryCounter* GetQueryCounter() const
+    {
+        return query_counter;
+    }
+
 protected:
     // Must override in derived class
     virtual void OnConfiguration() = 0;
@@ -46,19 +79,65 @@ protected:
     }
 
     void InitialDatabase();
-    void InitialTables();
+    // relations: OnTableRelationCreating(), inlined with the tables' own on SQLite
+    void InitialTables(const QList<Q1Relation> &relations);
     void InitialColumns();
-    void CompareColumn(const QString &table_name, Q1Column &dbColumn, Q1Column &declColumn);
+    void CompareColumn(const QString &table_name, Q1Column &dbColumn, Q1Column &declColumn,
+                       Q1MigrationPlan &plan);
     void InitialRelations(const QList<Q1Relation> &relations);
+    void InitialIndexes(const QList<Q1Relation> &relations);
+    // Views whose declaration changed are dropped before column changes (a view
+    // can pin the columns it reads) and created again, with missing ones, at the end
+    void DropStaleViews();
+    void InitialViews();
+    void StartViewRefresh();
+    // Indexes declared on the tables plus one per unindexed foreign key
+    QList<Q1Index> DeclaredIndexes(const QList<Q1Relation> &relations) const;
+    int InitializeParallelism() const;
 
 protected:
     Q1Connection *connection = nullptr;
     Q1Migration *query = nullptr;
+    Q1QueryCounter *query_counter = nullptr;
+    Q1SchemaSnapshot schema;    // loaded once per Initialize(); empty if the catalog read failed
 
     QString database_name;
     QList<Q1Table*> tables;
+    QList<Q1Table*> views;      // entities mapped with ToView(); not part of tables
+    Q1ViewRefresher *view_refresher = nullptr;
 
     bool check_columns = true;
+
+    // Store a hash of the model in __q1orm_model and skip all schema checks while it
+    // matches. Turn off in OnConfiguration() when the schema can change outside Q1ORM.
+    bool use_model_fingerprint = true;
+    bool schema_incomplete = false;   // a DDL step of the current Initialize() failed
+
+    // Plan and log every schema change (tables, partitions, columns, relations and
+    // indexes) in GetMigrationPlan() without applying it. Only a missing database is
+    // still created, since nothing can be read without it.
+    bool dry_run_migrations = false;
+    QStringList planned_tables;       // tables a dry run would create, lower case
+
+    // Drop IX_/UX_ indexes of mapped tables that the model no longer declares.
+    // Off by default: hand-made indexes may follow the same naming pattern.
+    bool drop_undeclared_indexes = false;
+
+    // Index every foreign key column that no declared index or primary key starts
+    // with, so Include() and joins on the relation do not scan the child table
+    bool index_foreign_keys = true;
+
+    // Lock-aware column changes for large, busy tables: short lock timeouts with
+    // retries, NOT NULL through a validated CHECK, batched default backfills and
+    // ONLINE = ON on SQL Server. Each step commits on its own.
+    bool online_migrations = false;
+
+    // Pool connections (Q1Executor clones) used by Initialize() for per-table work:
+    // catalog reads when there is no snapshot, CREATE TABLE, and one column-change
+    // transaction per table. Relations still run afterwards on the context's own
+    // connection, once all tables exist. 1 keeps everything sequential; SQLite ignores it.
+    int initialize_parallelism = 1;
+    Q1MigrationPlan migration_plan;
     bool owns_connection = false;
 };
 
@@ -0,0 +1,201 @@
+#include "Q1ViewRefresher.h"
+
+#include <QDebug>
+#include <QMutexLocker>
+#include <QStringList>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include "../../Q1Core/Q1Async/Q1Executor.h"
+#include "../../Q1Core/Q1Migration/Q1Migration.h"
+
+Q1ViewRefresher::Q1ViewRefresher(Q1Connection* connection)
+    : connection(connection)
+{
+    clock.start();
+}
+
+Q1ViewRefresher::~Q1ViewRefresher()
+{
+    Stop();
+
+    // Pool tasks use this object and the connection; let them finish first
+    QList<QFuture<bool>> running;
+    {
+        QMutexLocker locker(&mutex);
+        for (const QSharedPointer<Entry>& entry : entries)
+            running << entry->pending;
+    }
+
+    for (QFuture<bool>& future : running)
+        future.waitForFinished();
+}
+
+void Q1ViewRefresher::Add(const Q1Table& view)
+{
+    if (!view.IsView())
+        return;
+
+    QSharedPointer<Entry> entry = QSharedPointer<Entry>::create();
+    entry->view = view;
+
+    entry->interval_ms = view.view.refresh_interval_ms;
+
+    QMutexLocker locker(&mutex);
+    entry->due_ms = clock.elapsed() + entry->interval_ms;
+    entries.insert(view.GetName().toLower(), entry);
+
+    if (entry->interval_ms <= 0)
+        return;
+
+    if (!scheduler)
+    {
+        stopping = false;
+        scheduler = QThread::create([this]() { Schedule(); });
+        scheduler->setObjectName("Q1ViewRefresher");
+        scheduler->start();
+    }
+    wake.wakeAll();
+}
+
+void Q1ViewRefresher::Stop()
+{
+    QThread* thread = nullptr;
+    {
+        QMutexLocker locker(&mutex);
+        for (const QSharedPointer<Entry>& entry : entries)
+            entry->interval_ms = 0;
+
+        stopping = true;
+        thread = scheduler;
+        scheduler = nullptr;
+        wake.wakeAll();
+    }
+
+    if (thread)
+    {
+        thread->wait();
+        delete thread;
+    }
+}
+
+bool Q1ViewRefresher::HasView(const QString& view_name) const
+{
+    return !Find(view_name).isNull();
+}
+
+bool Q1ViewRefresher::Refresh(const QString& view_name)
+{
+    const QSharedPointer<Entry> entry = Find(view_name);
+    if (!entry)
+    {
+        qWarning() << "Q1ViewRefresher - unknown view:" << view_name;
+        return false;
+    }
+
+    return Run(entry, Q1Executor::ThreadConnection(connection));
+}
+
+QFuture<bool> Q1ViewRefresher::RefreshAsync(const QString& view_name)
+{
+    const QSharedPointer<Entry> entry = Find(view_name);
+    if (!entry)
+    {
+        qWarning() << "Q1ViewRefresher - unknown view:" << view_name;
+        return QtConcurrent::run(Q1Executor::Pool(), []() { return false; });
+    }
+
+    QMutexLocker locker(&mutex);
+    if (entry->pending.isRunning())
+        return entry->pending;
+
+    entry->pending = QtConcurrent::run(Q1Executor::Pool(), [this, entry]() {
+        return Run(entry, Q1Executor::ThreadConnection(connection));
+    });
+    return entry->pending;
+}
+
+QDateTime Q1ViewRefresher::LastRefreshed(const QString& view_name) const
+{
+    const QSharedPointer<Entry> entry = Find(view_name);
+    QMutexLocker locker(&mutex);
+    return entry ? entry->last_refreshed : QDateTime();
+}
+
+QString Q1ViewRefresher::LastError(const QString& view_name) const
+{
+    const QSharedPointer<Entry> entry = Find(view_name);
+    QMutexLocker locker(&mutex);
+    return entry ? entry->last_error : QString();
+}
+
+QSharedPointer<Q1ViewRefresher::Entry> Q1ViewRefresher::Find(const QString& view_name) const
+{
+    QMutexLocker locker(&mutex);
+    return entries.value(view_name.toLower());
+}
+
+void Q1ViewRefresher::Schedule()
+{
+    QMutexLocker locker(&mutex);
+    while (!stopping)
+    {
+        const qint64 now = clock.elapsed();
+        qint64 next = -1;
+        QStringList due;
+
+        for (const QSharedPointer<Entry>& entry : entries)
+        {
+            if (entry->interval_ms <= 0)
+                continue;
+
+            if (entry->due_ms <= now)
+            {
+                due << entry->view.GetName();
+                entry->due_ms = now + entry->interval_ms;
+            }
+            next = next < 0 ? entry->due_ms : qMin(next, entry->due_ms);
+        }
+
+        if (!due.isEmpty())
+        {
+            // RefreshAsync() takes the mutex itself and only queues the work
+            locker.unlock();
+            for (const QString& name : due)
+                RefreshAsync(name);
+            locker.relock();
+            continue;
+        }
+
+        if (next < 0)
+            wake.wait(&mutex);
+        else
+            wake.wait(&mutex, static_cast<unsigned long>(next - now));
+    }
+}
+
+bool Q1ViewRefresher::Run(const QSharedPointer<Entry>& entry, Q1Connection* connection)
+{
+    // A synchronous Refresh() may overlap a timed one; the second one is skipped
+    if (!entry->running.testAndSetOrdered(0, 1))
+        return false;
+
+    Q1Migration migration(*connection);
+    const bool success = migration.RefreshView(entry->view);
+
+    {
+        QMutexLocker locker(&mutex);
+        if (success)
+        {
+            entry->last_refreshed = QDateTime::currentDateTimeUtc();
+            entry->last_error.clear();
+        }
+        else
+        {
+            entry->last_error = migration.ErrorMessage();
+        }
+    }
+
+    entry->running.storeRelease(0);
+    return success;
+}
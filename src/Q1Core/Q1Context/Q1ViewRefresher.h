@@ -0,0 +1,75 @@
+#ifndef Q1VIEWREFRESHER_H
+#define Q1VIEWREFRESHER_H
+
+#include <QAtomicInt>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QHash>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QString>
+#include <QWaitCondition>
+
+#include "../../Q1Core/Q1Context/Q1Connection.h"
+#include "../../Q1Core/Q1Entity/Q1Table.h"
+
+#include "../../Q1ORM_global.h"
+
+class QThread;
+
+// Refreshes materialized views on demand or on a schedule. A scheduler thread owned
+// by the refresher starts timed refreshes on a Q1Executor pool thread with its own
+// connection, so no event loop is needed on the caller's thread; a view that is
+// still refreshing is not refreshed again at the same time.
+class Q1ORM_EXPORT Q1ViewRefresher
+{
+public:
+    explicit Q1ViewRefresher(Q1Connection* connection);
+    ~Q1ViewRefresher();
+
+    Q1ViewRefresher(const Q1ViewRefresher&) = delete;
+    Q1ViewRefresher& operator=(const Q1ViewRefresher&) = delete;
+
+    // Registers view and schedules it when view.view.refresh_interval_ms > 0
+    void Add(const Q1Table& view);
+    // Stops the schedule; refreshes already running finish. Any thread may call it.
+    void Stop();
+
+    bool HasView(const QString& view_name) const;
+
+    // Refreshes on the calling thread's connection and waits for it
+    bool Refresh(const QString& view_name);
+    // Refreshes on a pool thread; returns the running refresh if there is one
+    QFuture<bool> RefreshAsync(const QString& view_name);
+
+    QDateTime LastRefreshed(const QString& view_name) const;
+    QString LastError(const QString& view_name) const;
+
+private:
+    struct Entry
+    {
+        Q1Table view;
+        int interval_ms = 0;
+        qint64 due_ms = 0;          // on clock
+        QAtomicInt running;
+        QFuture<bool> pending;
+        QDateTime last_refreshed;
+        QString last_error;
+    };
+
+    QSharedPointer<Entry> Find(const QString& view_name) const;
+    bool Run(const QSharedPointer<Entry>& entry, Q1Connection* connection);
+    // Scheduler thread: sleeps until the next view is due and starts its refresh
+    void Schedule();
+
+    Q1Connection* connection;
+    mutable QMutex mutex;
+    QHash<QString, QSharedPointer<Entry>> entries;   // lower-case view name
+    QElapsedTimer clock;
+    QWaitCondition wake;
+    QThread* scheduler = nullptr;
+    bool stopping = false;
+};
+
+#endif // Q1VIEWREFRESHER_H
@@ -0,0 +1,125 @@
+#ifndef Q1HISTOGRAM_H
+#define Q1HISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <limits>
+#include <QList>
+#include <QtGlobal>
+
+// Lock-free histogram with power-of-two buckets. Bucket 0 holds 0, bucket i holds
+// [2^(i-1), 2^i - 1]. Record() is a handful of relaxed atomic operations, so it can
+// be called from any thread on the hot path; readers see an eventually consistent view.
+class Q1Histogram
+{
+public:
+    static constexpr int BucketCount = 64;
+
+    Q1Histogram()
+    {
+        Reset();
+    }
+
+    Q1Histogram(const Q1Histogram&) = delete;
+    Q1Histogram& operator=(const Q1Histogram&) = delete;
+
+    void Record(qint64 value)
+    {
+        const quint64 v = value > 0 ? static_cast<quint64>(value) : 0;
+
+        buckets[BucketIndex(v)].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(v, std::memory_order_relaxed);
+
+        quint64 current = max.load(std::memory_order_relaxed);
+        while (v > current && !max.compare_exchange_weak(current, v, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    qint64 Count() const
+    {
+        return static_cast<qint64>(count.load(std::memory_order_relaxed));
+    }
+
+    qint64 Sum() const
+    {
+        return static_cast<qint64>(sum.load(std::memory_order_relaxed));
+    }
+
+    qint64 Max() const
+    {
+        return static_cast<qint64>(max.load(std::memory_order_relaxed));
+    }
+
+    double Mean() const
+    {
+        const qint64 n = Count();
+        return n > 0 ? static_cast<double>(Sum()) / n : 0.0;
+    }
+
+    // Upper bound of the bucket holding the p-th percentile (0 < p <= 100), capped at Max()
+    qint64 Percentile(double p) const
+    {
+        const QList<qint64> counts = BucketCounts();
+
+        qint64 total = 0;
+        for (qint64 c : counts)
+            total += c;
+
+        if (total == 0)
+            return 0;
+
+        const double rank = qBound(0.0, p, 100.0) / 100.0 * total;
+        qint64 seen = 0;
+        for (int i = 0; i < counts.size(); ++i)
+        {
+            seen += counts[i];
+            if (seen > 0 && seen >= rank)
+                return qMin(BucketUpperBound(i), Max());
+        }
+
+        return Max();
+    }
+
+    QList<qint64> BucketCounts() const
+    {
+        QList<qint64> counts;
+        counts.reserve(BucketCount);
+        for (const auto& bucket : buckets)
+            counts.append(static_cast<qint64>(bucket.load(std::memory_order_relaxed)));
+        return counts;
+    }
+
+    static qint64 BucketUpperBound(int index)
+    {
+        if (index <= 0)
+            return 0;
+        if (index >= BucketCount - 1)
+            return std::numeric_limits<qint64>::max();
+        return (qint64(1) << index) - 1;
+    }
+
+    void Reset()
+    {
+        for (auto& bucket : buckets)
+            bucket.store(0, std::memory_order_relaxed);
+        count.store(0, std::memory_order_relaxed);
+        sum.store(0, std::memory_order_relaxed);
+        max.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static int BucketIndex(quint64 value)
+    {
+        return qMin(static_cast<int>(std::bit_width(value)), BucketCount - 1);
+    }
+
+    std::array<std::atomic<quint64>, BucketCount> buckets;
+    std::atomic<quint64> count;
+    std::atomic<quint64> sum;
+    std::atomic<quint64> max;
+};
+
+#endif // Q1HISTOGRAM_H
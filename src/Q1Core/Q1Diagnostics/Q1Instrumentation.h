@@ -0,0 +1,46 @@
+#ifndef Q1INSTRUMENTATION_H
+#define Q1INSTRUMENTATION_H
+
+#include <QString>
+#include <QVariantList>
+#include <QtGlobal>
+
+#include "../../Q1ORM_global.h"
+
+// Timings (nanoseconds) and counters of one executed statement
+struct Q1StatementMetrics
+{
+    QString operation;      // "select", "insert", "update", "delete", "upsert", "scalar", "query"
+    QString table;
+    QString sql;
+    QVariantList binds;     // positional bind values, when the statement has any
+
+    qint64 connect_ns = 0;
+    qint64 prepare_ns = 0;
+    qint64 execute_ns = 0;
+    qint64 fetch_ns = 0;    // cursor movement (QSqlQuery::next)
+    qint64 hydrate_ns = 0;  // turning rows into entities / JSON
+
+    int rows = 0;           // rows returned, or rows affected for writes
+    int sql_bytes = 0;      // UTF-8 size of the statement text
+    bool success = false;
+    bool replica = false;   // ran on a read replica (Q1Connection::AddReplica)
+
+    qint64 TotalNs() const
+    {
+        return connect_ns + prepare_ns + execute_ns + fetch_ns + hydrate_ns;
+    }
+};
+
+// Observer registered with Q1Connection::AddInstrumentation(). OnStatement() runs on
+// the thread that executed the statement, so implementations shared by several
+// connections (Q1Executor clones share the observers) must be thread-safe.
+class Q1ORM_EXPORT Q1Instrumentation
+{
+public:
+    virtual ~Q1Instrumentation() = default;
+
+    virtual void OnStatement(const Q1StatementMetrics& metrics) = 0;
+};
+
+#endif // Q1INSTRUMENTATION_H
@@ -0,0 +1,182 @@
+#include "Q1Metrics.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QStringList>
+
+namespace
+{
+qint64 NowUnixNano()
+{
+    return QDateTime::currentMSecsSinceEpoch() * 1000000;
+}
+
+// OTLP/JSON encodes 64-bit integers as strings
+QJsonValue Int64(qint64 value)
+{
+    return QString::number(value);
+}
+
+QJsonObject Attribute(const QString& key, const QString& value)
+{
+    return QJsonObject{{"key", key}, {"value", QJsonObject{{"stringValue", value}}}};
+}
+
+QJsonObject HistogramMetric(const QString& name, const QString& unit, const Q1Histogram& histogram,
+                            qint64 start_ns, qint64 now_ns)
+{
+    QJsonArray bucket_counts;
+    for (qint64 count : histogram.BucketCounts())
+        bucket_counts.append(Int64(count));
+
+    // explicitBounds has one entry less than bucketCounts; the last bucket is unbounded
+    QJsonArray bounds;
+    for (int i = 0; i < Q1Histogram::BucketCount - 1; ++i)
+        bounds.append(static_cast<double>(Q1Histogram::BucketUpperBound(i)));
+
+    QJsonObject point{
+        {"startTimeUnixNano", Int64(start_ns)},
+        {"timeUnixNano", Int64(now_ns)},
+        {"count", Int64(histogram.Count())},
+        {"sum", static_cast<double>(histogram.Sum())},
+        {"max", static_cast<double>(histogram.Max())},
+        {"bucketCounts", bucket_counts},
+        {"explicitBounds", bounds}
+    };
+
+    return QJsonObject{
+        {"name", name},
+        {"unit", unit},
+        {"histogram", QJsonObject{
+                          {"aggregationTemporality", 2}, // cumulative
+                          {"dataPoints", QJsonArray{point}}
+                      }}
+    };
+}
+
+QJsonObject CounterMetric(const QString& name, const QString& unit, qint64 value,
+                          qint64 start_ns, qint64 now_ns)
+{
+    QJsonObject point{
+        {"startTimeUnixNano", Int64(start_ns)},
+        {"timeUnixNano", Int64(now_ns)},
+        {"asInt", Int64(value)}
+    };
+
+    return QJsonObject{
+        {"name", name},
+        {"unit", unit},
+        {"sum", QJsonObject{
+                    {"aggregationTemporality", 2},
+                    {"isMonotonic", true},
+                    {"dataPoints", QJsonArray{point}}
+                }}
+    };
+}
+
+QString SummaryLine(const QString& label, const Q1Histogram& histogram)
+{
+    return QString("%1: count=%2 mean=%3us p50=%4us p99=%5us max=%6us")
+        .arg(label, -8)
+        .arg(histogram.Count())
+        .arg(histogram.Mean() / 1000.0, 0, 'f', 1)
+        .arg(histogram.Percentile(50) / 1000.0, 0, 'f', 1)
+        .arg(histogram.Percentile(99) / 1000.0, 0, 'f', 1)
+        .arg(histogram.Max() / 1000.0, 0, 'f', 1);
+}
+}
+
+Q1Metrics::Q1Metrics()
+{
+    start_time_ns.store(NowUnixNano(), std::memory_order_relaxed);
+}
+
+void Q1Metrics::OnStatement(const Q1StatementMetrics& metrics)
+{
+    connect.Record(metrics.connect_ns);
+    prepare.Record(metrics.prepare_ns);
+    execute.Record(metrics.execute_ns);
+    fetch.Record(metrics.fetch_ns);
+    hydrate.Record(metrics.hydrate_ns);
+    total.Record(metrics.TotalNs());
+    rows.Record(metrics.rows);
+
+    statements.fetch_add(1, std::memory_order_relaxed);
+    sql_bytes.fetch_add(metrics.sql_bytes, std::memory_order_relaxed);
+
+    if (!metrics.success)
+        failures.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Q1Metrics::Reset()
+{
+    connect.Reset();
+    prepare.Reset();
+    execute.Reset();
+    fetch.Reset();
+    hydrate.Reset();
+    total.Reset();
+    rows.Reset();
+
+    statements.store(0, std::memory_order_relaxed);
+    failures.store(0, std::memory_order_relaxed);
+    sql_bytes.store(0, std::memory_order_relaxed);
+
+    start_time_ns.store(NowUnixNano(), std::memory_order_relaxed);
+}
+
+QString Q1Metrics::Summary() const
+{
+    QStringList lines;
+    lines << QString("statements=%1 failures=%2 sql_bytes=%3")
+                 .arg(Statements()).arg(Failures()).arg(SqlBytes());
+    lines << SummaryLine("connect", connect);
+    lines << SummaryLine("prepare", prepare);
+    lines << SummaryLine("execute", execute);
+    lines << SummaryLine("fetch", fetch);
+    lines << SummaryLine("hydrate", hydrate);
+    lines << SummaryLine("total", total);
+    return lines.join('\n');
+}
+
+bool Q1Metrics::ExportOtlpJson(const QString& path, const QString& service_name) const
+{
+    const qint64 start_ns = start_time_ns.load(std::memory_order_relaxed);
+    const qint64 now_ns = NowUnixNano();
+
+    QJsonArray metrics{
+        HistogramMetric("q1orm.statement.connect", "ns", connect, start_ns, now_ns),
+        HistogramMetric("q1orm.statement.prepare", "ns", prepare, start_ns, now_ns),
+        HistogramMetric("q1orm.statement.execute", "ns", execute, start_ns, now_ns),
+        HistogramMetric("q1orm.statement.fetch", "ns", fetch, start_ns, now_ns),
+        HistogramMetric("q1orm.statement.hydrate", "ns", hydrate, start_ns, now_ns),
+        HistogramMetric("q1orm.statement.duration", "ns", total, start_ns, now_ns),
+        HistogramMetric("q1orm.statement.rows", "{row}", rows, start_ns, now_ns),
+        CounterMetric("q1orm.statements", "{statement}", Statements(), start_ns, now_ns),
+        CounterMetric("q1orm.statement.failures", "{statement}", Failures(), start_ns, now_ns),
+        CounterMetric("q1orm.statement.sql_bytes", "By", SqlBytes(), start_ns, now_ns)
+    };
+
+    const QJsonObject request{
+        {"resourceMetrics", QJsonArray{QJsonObject{
+                                {"resource", QJsonObject{{"attributes", QJsonArray{Attribute("service.name", service_name)}}}},
+                                {"scopeMetrics", QJsonArray{QJsonObject{
+                                                     {"scope", QJsonObject{{"name", "q1orm"}}},
+                                                     {"metrics", metrics}
+                                                 }}}
+                            }}}
+    };
+
+    QMutexLocker locker(&export_mutex);
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+        return false;
+
+    QByteArray line = QJsonDocument(request).toJson(QJsonDocument::Compact);
+    line.append('\n');
+    return file.write(line) == line.size();
+}
@@ -0,0 +1,68 @@
+#ifndef Q1METRICS_H
+#define Q1METRICS_H
+
+#include <atomic>
+#include <QDateTime>
+#include <QMutex>
+#include <QString>
+
+#include "../../Q1Core/Q1Diagnostics/Q1Histogram.h"
+#include "../../Q1Core/Q1Diagnostics/Q1Instrumentation.h"
+#include "../../Q1ORM_global.h"
+
+// Aggregates statement metrics into per-phase histograms and counters.
+//
+//   Q1Metrics metrics;
+//   connection->AddInstrumentation(&metrics);
+//   ...
+//   qDebug() << metrics.Summary();
+//   metrics.ExportOtlpJson("q1orm-metrics.jsonl");
+//
+// OnStatement() only touches atomics, so one instance can observe any number of
+// connections and threads.
+class Q1ORM_EXPORT Q1Metrics : public Q1Instrumentation
+{
+public:
+    Q1Metrics();
+
+    void OnStatement(const Q1StatementMetrics& metrics) override;
+
+    const Q1Histogram& Connect() const { return connect; }
+    const Q1Histogram& Prepare() const { return prepare; }
+    const Q1Histogram& Execute() const { return execute; }
+    const Q1Histogram& Fetch() const { return fetch; }
+    const Q1Histogram& Hydrate() const { return hydrate; }
+    const Q1Histogram& Total() const { return total; }
+    const Q1Histogram& Rows() const { return rows; }
+
+    qint64 Statements() const { return statements.load(std::memory_order_relaxed); }
+    qint64 Failures() const { return failures.load(std::memory_order_relaxed); }
+    qint64 SqlBytes() const { return sql_bytes.load(std::memory_order_relaxed); }
+
+    void Reset();
+
+    // One line per phase: count, mean, p50, p99 and max in microseconds
+    QString Summary() const;
+
+    // Appends one OTLP/JSON ExportMetricsServiceRequest line (the OpenTelemetry file
+    // exporter format) with cumulative histograms and counters since the last Reset().
+    bool ExportOtlpJson(const QString& path, const QString& service_name = "q1orm") const;
+
+private:
+    Q1Histogram connect;
+    Q1Histogram prepare;
+    Q1Histogram execute;
+    Q1Histogram fetch;
+    Q1Histogram hydrate;
+    Q1Histogram total;
+    Q1Histogram rows;
+
+    std::atomic<qint64> statements{0};
+    std::atomic<qint64> failures{0};
+    std::atomic<qint64> sql_bytes{0};
+
+    std::atomic<qint64> start_time_ns{0};
+    mutable QMutex export_mutex;
+};
+
+#endif // Q1METRICS_H
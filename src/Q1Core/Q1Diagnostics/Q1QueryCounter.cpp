@@ -0,0 +1,179 @@
+#include "Q1QueryCounter.h"
+
+#include <QDebug>
+#include <QMutexLocker>
+#include <QRegularExpression>
+#include <QThread>
+
+namespace
+{
+thread_local Qt::HANDLE scope_thread = nullptr;
+}
+
+Q1QueryCounter::Q1QueryCounter(int threshold, Q1QueryCounterMode mode)
+    : threshold(qMax(1, threshold)), mode(mode)
+{
+}
+
+void Q1QueryCounter::SetThreshold(int threshold)
+{
+    QMutexLocker locker(&mutex);
+    this->threshold = qMax(1, threshold);
+}
+
+int Q1QueryCounter::GetThreshold() const
+{
+    QMutexLocker locker(&mutex);
+    return threshold;
+}
+
+void Q1QueryCounter::SetMode(Q1QueryCounterMode mode)
+{
+    QMutexLocker locker(&mutex);
+    this->mode = mode;
+}
+
+Q1QueryCounterMode Q1QueryCounter::GetMode() const
+{
+    QMutexLocker locker(&mutex);
+    return mode;
+}
+
+void Q1QueryCounter::BeginScope(const QString& name)
+{
+    QMutexLocker locker(&mutex);
+    Scope scope;
+    scope.name = name;
+    scopes[ScopeThread()].append(scope);
+}
+
+void Q1QueryCounter::EndScope()
+{
+    QMutexLocker locker(&mutex);
+    auto it = scopes.find(ScopeThread());
+    if (it == scopes.end())
+        return;
+
+    if (!it->isEmpty())
+        it->removeLast();
+
+    if (it->isEmpty())
+        scopes.erase(it);
+}
+
+int Q1QueryCounter::ScopeStatements() const
+{
+    QMutexLocker locker(&mutex);
+    const auto it = scopes.constFind(ScopeThread());
+    if (it == scopes.constEnd() || it->isEmpty())
+        return 0;
+
+    return it->last().statements;
+}
+
+QList<Q1RepeatedQuery> Q1QueryCounter::Violations() const
+{
+    QMutexLocker locker(&mutex);
+    return violations;
+}
+
+void Q1QueryCounter::ClearViolations()
+{
+    QMutexLocker locker(&mutex);
+    violations.clear();
+}
+
+void Q1QueryCounter::OnStatement(const Q1StatementMetrics& metrics)
+{
+    if (metrics.sql.isEmpty())
+        return;
+
+    QMutexLocker locker(&mutex);
+    auto it = scopes.find(ScopeThread());
+    if (it == scopes.end() || it->isEmpty())
+        return;
+
+    // Fingerprint only when a scope is open; outside scopes this costs one hash lookup
+    Scope& scope = it->last();
+    const QString fingerprint = Fingerprint(metrics.sql);
+    const int count = ++scope.counts[fingerprint];
+    ++scope.statements;
+
+    // Report once per shape and scope, the first time it goes over the threshold
+    if (count != threshold + 1)
+        return;
+
+    Q1RepeatedQuery repeated;
+    repeated.scope = scope.name;
+    repeated.operation = metrics.operation;
+    repeated.table = metrics.table;
+    repeated.fingerprint = fingerprint;
+    repeated.count = count;
+    repeated.suggestion = Suggestion(metrics.operation, fingerprint);
+    violations.append(repeated);
+
+    const Q1QueryCounterMode current_mode = mode;
+    const int current_threshold = threshold;
+    locker.unlock();
+
+    const QString message = QString("Possible N+1 in scope '%1': the same %2 ran more than %3 times: %4. %5")
+                                .arg(repeated.scope, repeated.operation)
+                                .arg(current_threshold)
+                                .arg(repeated.fingerprint, repeated.suggestion);
+
+    if (current_mode == Q1QueryCounterMode::Fatal)
+        qFatal("%s", qPrintable(message));
+
+    qWarning().noquote() << message;
+}
+
+Qt::HANDLE Q1QueryCounter::ScopeThread()
+{
+    return scope_thread ? scope_thread : QThread::currentThreadId();
+}
+
+Qt::HANDLE Q1QueryCounter::SetScopeThread(Qt::HANDLE thread)
+{
+    const Qt::HANDLE previous = scope_thread;
+    scope_thread = thread;
+    return previous;
+}
+
+QString Q1QueryCounter::Fingerprint(const QString& sql)
+{
+    static const QRegularExpression string_literal("N?'(?:[^']|'')*'");
+    static const QRegularExpression placeholder("\\$\\d+|(?<!:):\\w+");
+    static const QRegularExpression number("\\b\\d+(?:\\.\\d+)?\\b");
+    static const QRegularExpression in_list("\\bIN\\s*\\(\\s*\\?(?:\\s*,\\s*\\?)*\\s*\\)",
+                                            QRegularExpression::CaseInsensitiveOption);
+    static const QRegularExpression values_list("\\(\\s*\\?(?:\\s*,\\s*\\?)*\\s*\\)(?:\\s*,\\s*\\(\\s*\\?(?:\\s*,\\s*\\?)*\\s*\\))+");
+    static const QRegularExpression whitespace("\\s+");
+
+    QString shape = sql;
+    shape.replace(string_literal, "?");
+    shape.replace(placeholder, "?");
+    shape.replace(number, "?");
+    shape.replace(in_list, "IN (...)");
+    shape.replace(values_list, "(...)");
+    shape.replace(whitespace, " ");
+    return shape.trimmed();
+}
+
+QString Q1QueryCounter::Suggestion(const QString& operation, const QString& fingerprint)
+{
+    static const QRegularExpression key_lookup("\\bWHERE\\s+[\"\\[`]?(\\w+)[\"\\]`]?\\s*=\\s*\\?",
+                                               QRegularExpression::CaseInsensitiveOption);
+
+    if (operation == "insert" || operation == "upsert")
+        return "Write the rows together with UpsertRange() or a Q1Batch.";
+
+    if (operation == "update" || operation == "delete")
+        return "Use UpdateWhere()/DeleteWhere() with one condition, or a Q1Batch.";
+
+    const QRegularExpressionMatch match = key_lookup.match(fingerprint);
+    if (match.hasMatch())
+        return QString("Load the rows in one query with WHERE %1 IN (...), or Include() the relation "
+                       "instead of selecting once per parent row.").arg(match.captured(1));
+
+    return "Move the query out of the loop, or Include() the related rows.";
+}
@@ -0,0 +1,128 @@
+#ifndef Q1QUERYCOUNTER_H
+#define Q1QUERYCOUNTER_H
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+
+#include "../../Q1Core/Q1Diagnostics/Q1Instrumentation.h"
+#include "../../Q1ORM_global.h"
+
+enum class Q1QueryCounterMode
+{
+    Warn,   // qWarning() with the repeated shape and a suggestion
+    Fatal   // qFatal(), so a test or debug run stops at the first N+1 pattern
+};
+
+// A SQL shape that ran more than the threshold inside one scope
+struct Q1RepeatedQuery
+{
+    QString scope;
+    QString operation;
+    QString table;
+    QString fingerprint;
+    int count = 0;
+    QString suggestion;
+};
+
+// Detects N+1 round trips. Statements are fingerprinted (literals and bind
+// placeholders become ?, IN lists collapse) and counted per shape inside the
+// innermost Q1QueryScope of the executing thread. Async calls (Q1Entity and
+// Q1Query *Async()) count in the scope of the thread that started them. A shape
+// that runs more than the threshold times in one scope is reported once.
+// Statements outside any scope are not counted. Thread-safe.
+class Q1ORM_EXPORT Q1QueryCounter : public Q1Instrumentation
+{
+public:
+    explicit Q1QueryCounter(int threshold = 10, Q1QueryCounterMode mode = Q1QueryCounterMode::Warn);
+
+    void SetThreshold(int threshold);
+    int GetThreshold() const;
+
+    void SetMode(Q1QueryCounterMode mode);
+    Q1QueryCounterMode GetMode() const;
+
+    void BeginScope(const QString& name);
+    void EndScope();
+
+    // Statements counted in the calling thread's current scope
+    int ScopeStatements() const;
+
+    QList<Q1RepeatedQuery> Violations() const;
+    void ClearViolations();
+
+    void OnStatement(const Q1StatementMetrics& metrics) override;
+
+    static QString Fingerprint(const QString& sql);
+    static QString Suggestion(const QString& operation, const QString& fingerprint);
+
+    // Thread whose scopes count the calling thread's statements: its own, unless a
+    // Q1QueryScopeHandoff hands them to the thread that queued the current task
+    static Qt::HANDLE ScopeThread();
+    static Qt::HANDLE SetScopeThread(Qt::HANDLE thread);
+
+private:
+    struct Scope
+    {
+        QString name;
+        QHash<QString, int> counts;
+        int statements = 0;
+    };
+
+    mutable QMutex mutex;
+    QHash<Qt::HANDLE, QList<Scope>> scopes;
+    QList<Q1RepeatedQuery> violations;
+    int threshold;
+    Q1QueryCounterMode mode;
+};
+
+// Opens a counting scope for its lifetime, e.g. one request or one service call.
+// A null counter makes the scope a no-op, so release builds can pass
+// Q1Context::GetQueryCounter() unconditionally.
+class Q1QueryScope
+{
+public:
+    Q1QueryScope(Q1QueryCounter* counter, const QString& name)
+        : counter(counter)
+    {
+        if (counter)
+            counter->BeginScope(name);
+    }
+
+    ~Q1QueryScope()
+    {
+        if (counter)
+            counter->EndScope();
+    }
+
+    Q1QueryScope(const Q1QueryScope&) = delete;
+    Q1QueryScope& operator=(const Q1QueryScope&) = delete;
+
+private:
+    Q1QueryCounter* counter;
+};
+
+// Counts the statements of a pool task in the scopes of the thread that queued it,
+// for the task's lifetime. Capture Q1QueryCounter::ScopeThread() when queuing.
+class Q1QueryScopeHandoff
+{
+public:
+    explicit Q1QueryScopeHandoff(Qt::HANDLE origin)
+        : previous(Q1QueryCounter::SetScopeThread(origin))
+    {
+    }
+
+    ~Q1QueryScopeHandoff()
+    {
+        Q1QueryCounter::SetScopeThread(previous);
+    }
+
+    Q1QueryScopeHandoff(const Q1QueryScopeHandoff&) = delete;
+    Q1QueryScopeHandoff& operator=(const Q1QueryScopeHandoff&) = delete;
+
+private:
+    Qt::HANDLE previous;
+};
+
+#endif // Q1QUERYCOUNTER_H
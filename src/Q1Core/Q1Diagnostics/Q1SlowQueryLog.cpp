@@ -0,0 +1,124 @@
+#include "Q1SlowQueryLog.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+
+void Q1SlowQueryLog::SetFile(const QString& path, qint64 max_bytes, int max_files)
+{
+    QMutexLocker locker(&mutex);
+    this->path = path;
+    this->max_bytes = qMax<qint64>(1024, max_bytes);
+    this->max_files = qMax(1, max_files);
+}
+
+QString Q1SlowQueryLog::GetFile() const
+{
+    QMutexLocker locker(&mutex);
+    return path;
+}
+
+void Q1SlowQueryLog::Record(const Q1StatementMetrics& metrics, const QString& plan)
+{
+    const double duration_ms = metrics.TotalNs() / 1000000.0;
+
+    QJsonArray binds;
+    for (const QVariant& value : metrics.binds)
+        binds.append(QJsonValue::fromVariant(value));
+
+    qWarning().noquote() << QString("Slow query (%1 ms, %2 rows) on %3:")
+                                .arg(duration_ms, 0, 'f', 1)
+                                .arg(metrics.rows)
+                                .arg(metrics.table.isEmpty() ? metrics.operation : metrics.table)
+                         << metrics.sql
+                         << (binds.isEmpty() ? QString() : "binds: " + QJsonDocument(binds).toJson(QJsonDocument::Compact));
+
+    Q1SlowQuery entry;
+    entry.time = QDateTime::currentDateTimeUtc();
+    entry.metrics = metrics;
+    entry.plan = plan;
+
+    QMutexLocker locker(&mutex);
+    ++count;
+    last = entry;
+
+    if (path.isEmpty())
+        return;
+
+    QJsonObject json{
+        {"time", entry.time.toString(Qt::ISODateWithMs)},
+        {"duration_ms", duration_ms},
+        {"connect_ms", metrics.connect_ns / 1000000.0},
+        {"execute_ms", metrics.execute_ns / 1000000.0},
+        {"fetch_ms", metrics.fetch_ns / 1000000.0},
+        {"hydrate_ms", metrics.hydrate_ns / 1000000.0},
+        {"operation", metrics.operation},
+        {"table", metrics.table},
+        {"replica", metrics.replica},
+        {"rows", metrics.rows},
+        {"sql", metrics.sql},
+        {"binds", binds}
+    };
+
+    if (!plan.isEmpty())
+    {
+        // PostgreSQL plans are JSON already; keep them structured
+        const QJsonDocument plan_json = QJsonDocument::fromJson(plan.toUtf8());
+        if (plan_json.isArray())
+            json.insert("plan", plan_json.array());
+        else if (plan_json.isObject())
+            json.insert("plan", plan_json.object());
+        else
+            json.insert("plan", plan);
+    }
+
+    QByteArray line = QJsonDocument(json).toJson(QJsonDocument::Compact);
+    line.append('\n');
+    Append(line);
+}
+
+qint64 Q1SlowQueryLog::Count() const
+{
+    QMutexLocker locker(&mutex);
+    return count;
+}
+
+Q1SlowQuery Q1SlowQueryLog::Last() const
+{
+    QMutexLocker locker(&mutex);
+    return last;
+}
+
+void Q1SlowQueryLog::Append(const QByteArray& line)
+{
+    const QFileInfo info(path);
+    if (info.exists() && info.size() + line.size() > max_bytes)
+        Rotate();
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+    {
+        qWarning() << "Q1SlowQueryLog: cannot open" << path << "-" << file.errorString();
+        return;
+    }
+
+    file.write(line);
+}
+
+void Q1SlowQueryLog::Rotate()
+{
+    QFile::remove(QString("%1.%2").arg(path).arg(max_files));
+
+    for (int i = max_files - 1; i >= 1; --i)
+    {
+        const QString from = QString("%1.%2").arg(path).arg(i);
+        if (QFile::exists(from))
+            QFile::rename(from, QString("%1.%2").arg(path).arg(i + 1));
+    }
+
+    QFile::rename(path, path + ".1");
+}
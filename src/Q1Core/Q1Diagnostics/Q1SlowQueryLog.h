@@ -0,0 +1,45 @@
+#ifndef Q1SLOWQUERYLOG_H
+#define Q1SLOWQUERYLOG_H
+
+#include <QDateTime>
+#include <QMutex>
+#include <QString>
+
+#include "../../Q1Core/Q1Diagnostics/Q1Instrumentation.h"
+#include "../../Q1ORM_global.h"
+
+struct Q1SlowQuery
+{
+    QDateTime time;
+    Q1StatementMetrics metrics;
+    QString plan;           // EXPLAIN output, empty when not captured
+};
+
+// Sink for statements slower than Q1Connection::SetSlowQueryThreshold(). Each entry
+// is logged with qWarning() and, when a file is set, appended to it as one JSON line.
+// The file rotates to path.1 ... path.N once it would grow past max_bytes.
+// Shared by a connection and its clones; thread-safe.
+class Q1ORM_EXPORT Q1SlowQueryLog
+{
+public:
+    void SetFile(const QString& path, qint64 max_bytes = 10 * 1024 * 1024, int max_files = 5);
+    QString GetFile() const;
+
+    void Record(const Q1StatementMetrics& metrics, const QString& plan = QString());
+
+    qint64 Count() const;
+    Q1SlowQuery Last() const;
+
+private:
+    void Append(const QByteArray& line);
+    void Rotate();
+
+    mutable QMutex mutex;
+    QString path;
+    qint64 max_bytes = 10 * 1024 * 1024;
+    int max_files = 5;
+    qint64 count = 0;
+    Q1SlowQuery last;
+};
+
+#endif // Q1SLOWQUERYLOG_H
@@ -0,0 +1,122 @@
+#ifndef Q1STATEMENTTIMER_H
+#define Q1STATEMENTTIMER_H
+
+#include <QElapsedTimer>
+#include <QString>
+
+#include "../../Q1Core/Q1Context/Q1Connection.h"
+#include "../../Q1Core/Q1Diagnostics/Q1Instrumentation.h"
+
+enum class Q1StatementPhase
+{
+    Connect,
+    Prepare,
+    Execute,
+    Fetch,
+    Hydrate
+};
+
+// Splits one statement into phases and reports it to the connection's observers.
+// Lap(phase) charges the time since the previous lap to phase. Without registered
+// observers every call returns immediately, so the timer can stay on the hot path.
+// A timer that is never finished reports a failed statement when destroyed.
+class Q1StatementTimer
+{
+public:
+    Q1StatementTimer(Q1Connection* connection, const QString& operation, const QString& table = QString())
+        : connection(connection && connection->HasInstrumentation() ? connection : nullptr)
+    {
+        if (!this->connection)
+            return;
+
+        metrics.operation = operation;
+        metrics.table = table;
+        metrics.replica = connection->IsReplica();
+        timer.start();
+    }
+
+    ~Q1StatementTimer()
+    {
+        Finish(false);
+    }
+
+    Q1StatementTimer(const Q1StatementTimer&) = delete;
+    Q1StatementTimer& operator=(const Q1StatementTimer&) = delete;
+
+    // Reports to the connection read routing picked (a replica, or the primary the
+    // timer started on). Start the timer before routing so that opening the
+    // replica's connection is charged to the Connect phase.
+    void SetConnection(Q1Connection* target)
+    {
+        if (!connection)
+            return;
+
+        connection = target && target->HasInstrumentation() ? target : nullptr;
+        if (connection)
+            metrics.replica = connection->IsReplica();
+    }
+
+    bool IsEnabled() const
+    {
+        return connection != nullptr;
+    }
+
+    void Lap(Q1StatementPhase phase)
+    {
+        if (!connection)
+            return;
+
+        const qint64 now = timer.nsecsElapsed();
+        const qint64 elapsed = now - last_lap;
+        last_lap = now;
+
+        switch (phase)
+        {
+        case Q1StatementPhase::Connect: metrics.connect_ns += elapsed; break;
+        case Q1StatementPhase::Prepare: metrics.prepare_ns += elapsed; break;
+        case Q1StatementPhase::Execute: metrics.execute_ns += elapsed; break;
+        case Q1StatementPhase::Fetch: metrics.fetch_ns += elapsed; break;
+        case Q1StatementPhase::Hydrate: metrics.hydrate_ns += elapsed; break;
+        }
+    }
+
+    void SetSql(const QString& sql)
+    {
+        if (!connection)
+            return;
+
+        metrics.sql = sql;
+        metrics.sql_bytes = sql.toUtf8().size();
+    }
+
+    void SetBinds(const QVariantList& binds)
+    {
+        if (connection)
+            metrics.binds = binds;
+    }
+
+    void AddRows(int rows)
+    {
+        if (connection && rows > 0)
+            metrics.rows += rows;
+    }
+
+    void Finish(bool success)
+    {
+        if (!connection || finished)
+            return;
+
+        finished = true;
+        metrics.success = success;
+        connection->Report(metrics);
+    }
+
+private:
+    Q1Connection* connection;
+    Q1StatementMetrics metrics;
+    QElapsedTimer timer;
+    qint64 last_lap = 0;
+    bool finished = false;
+};
+
+#endif // Q1STATEMENTTIMER_H
@@ -4,6 +4,8 @@
 #include <QString>
 #include <QStringList>
 #include <cstddef>
+#include <functional>
+#include <optional>
 #include <type_traits>
 #include <typeinfo>
 #include <utility>
@@ -11,6 +13,8 @@
 #include <QVariantMap>
 #include <QList>
 #include <QMap>
+#include <QHash>
+#include <QSet>
 #include <QDate>
 #include <QDateTime>
 #include <QSqlRecord>
@@ -18,8 +22,15 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QJsonDocument>
+#include <QFuture>
+#include <QSharedPointer>
+#include <QtConcurrent/QtConcurrentRun>
 
+#include "../../Q1Core/Q1Async/Q1AsyncResult.h"
+#include "../../Q1Core/Q1Async/Q1Executor.h"
 #include "../../Q1Core/Q1Context/Q1Connection.h"
+#include "../../Q1Core/Q1Diagnostics/Q1QueryCounter.h"
+#include "../../Q1Core/Q1Diagnostics/Q1StatementTimer.h"
 #include "../../Q1Core/Q1Entity/Q1Table.h"
 #include "../../Q1Core/Q1Entity/Q1Column.h"
 #include "../../Q1Core/Q1Query/Q1Query.h"
@@ -131,6 +142,50 @@ public:
     }
 
 
+/* ############################################################################### */
+/* *********************************** Index ************************************* */
+/* ############################################################################### */
+
+    // Declare an index on this entity's table; Q1Context::Initialize() creates it.
+    // include_columns makes it covering, where makes it partial (raw SQL predicate).
+    Q1Index Index(const QStringList& columns, bool unique = false,
+                  const QStringList& include_columns = QStringList(),
+                  const QString& where = QString())
+    {
+        Q1Index index(table.table_name, columns, unique, include_columns, where);
+        table.AddIndex(index);
+        return index;
+    }
+
+
+/* ############################################################################### */
+/* ********************************* Partition *********************************** */
+/* ############################################################################### */
+
+    // Partition this entity's table by column, e.g.
+    // PartitionBy(RANGE, "created_at").Every(MONTHLY).Premake(3).Retain(12)
+    Q1Partition& PartitionBy(Q1PartitionType type, const QString& column)
+    {
+        table.partition = Q1Partition(type, column);
+        return table.partition;
+    }
+
+
+/* ############################################################################### */
+/* *********************************** View ************************************** */
+/* ############################################################################### */
+
+    // Map this entity onto a (materialized) view of definition instead of a table.
+    // Properties still declare the columns to read; Q1Context creates the view.
+    Q1View& ToView(const QString& view_name, const QString& definition,
+                   const QStringList& unique_columns = QStringList())
+    {
+        table.table_name = view_name;
+        table.view = Q1View(definition, unique_columns);
+        return table.view;
+    }
+
+
 /* ############################################################################### */
 /* ************************************ Setter *********************************** */
 /* ############################################################################### */
@@ -147,6 +202,13 @@ public:
         lastJson = jsonArray;
     }
 
+    // Switch a copied entity set to the calling thread's connection (see Q1Executor)
+    void BindToCurrentThread()
+    {
+        connection = Q1Executor::ThreadConnection(connection);
+        last_error.clear();
+    }
+
 
 /* ############################################################################### */
 /* ********************************* Getter ************************************** */
@@ -192,6 +254,22 @@ public:
         return table.columns;
     }
 
+    // Column mapped to a member of Entity, or an empty string if it is not a property
+    template<typename Member>
+    QString ColumnName(Member Entity::* member) const
+    {
+        const Entity probe{};
+        const ptrdiff_t offset = reinterpret_cast<const char*>(&(probe.*member)) - reinterpret_cast<const char*>(&probe);
+
+        for (auto it = property_map.constBegin(); it != property_map.constEnd(); ++it)
+        {
+            if (it.value().offset == offset)
+                return it.key();
+        }
+
+        return QString();
+    }
+
 
 
     const QJsonArray& GetLastJson() const
@@ -199,11 +277,38 @@ public:
         return lastJson;
     }
 
+    Q1Connection* GetConnection() const
+    {
+        return connection;
+    }
+
+    // Replica to read from, see Q1Connection::ReadConnection()
+    Q1Connection* ReadConnection(const QString& sql = QString()) const
+    {
+        return connection ? connection->ReadConnection(sql) : nullptr;
+    }
+
+    // Primary unless the connection allows raw reads on replicas
+    Q1Connection* RawReadConnection(const QString& sql) const
+    {
+        return connection ? connection->RawReadConnection(sql) : nullptr;
+    }
+
+    bool UsesPostgreSql() const
+    {
+        return connection && connection->IsPostgreSql();
+    }
+
     bool UsesSqlServer() const
     {
         return connection && connection->IsSqlServer();
     }
 
+    bool UsesSqlite() const
+    {
+        return connection && connection->IsSqlite();
+    }
+
     QString QuoteIdentifier(const QString &identifier) const
     {
         if (!connection)
@@ -253,6 +358,12 @@ public:
                                   "FROM INFORMATION_SCHEMA.COLUMNS "
                                   "WHERE TABLE_NAME = '%1' "
                                   "ORDER BY ORDINAL_POSITION"
+                            : UsesSqlite()
+                                ? "SELECT name AS column_name, dflt_value AS column_default, "
+                                  "CASE WHEN \"notnull\" = 0 AND pk = 0 THEN 'YES' ELSE 'NO' END AS is_nullable, "
+                                  "CASE WHEN pk > 0 AND upper(type) = 'INTEGER' THEN 'YES' ELSE 'NO' END AS is_identity "
+                                  "FROM pragma_table_info('%1') "
+                                  "ORDER BY cid"
                                 : "SELECT column_name, column_default, is_nullable, is_identity "
                                   "FROM information_schema.columns "
                                   "WHERE table_name = '%1' "
@@ -292,11 +403,15 @@ public:
 
     bool Insert(Entity& entity)
     {
+        Q1StatementTimer timer(connection, "insert", table.table_name);
+
         if (!connection || !connection->Connect())
         {
             last_error = "Database connection failed";
             return false;
         }
+        timer.Lap(Q1StatementPhase::Connect);
+        connection->MarkWrite();
 
         QStringList columns;
         QStringList placeholders;
@@ -319,21 +434,7 @@ public:
                 pk_column_name = col.name;
 
                 // Check if this PK is auto-generated
-                bool is_auto = false;
-
-                if (col.default_value.isEmpty())
-                {
-                    is_auto = true;
-                }
-                else if (col.default_value.contains("IDENTITY", Qt::CaseInsensitive) ||
-                         col.default_value.contains("SERIAL", Qt::CaseInsensitive) ||
-                         col.default_value.contains("nextval", Qt::CaseInsensitive) ||
-                         col.default_value.contains("GENERATED", Qt::CaseInsensitive))
-                {
-                    is_auto = true;
-                }
-
-                if (is_auto)
+                if (IsAutoPrimaryKey(col))
                 {
                     has_auto_pk = true;
                     qDebug() << "  --> Detected as auto-increment, will skip in INSERT";
@@ -383,6 +484,8 @@ public:
                            .arg(QuoteIdentifier(table.table_name), columns.join(", "), placeholders.join(", "));
         }
 
+        timer.SetSql(queryStr);
+
         QSqlQuery sql_query(connection->database);
         if (!sql_query.prepare(queryStr))
         {
@@ -391,35 +494,20 @@ public:
             connection->Disconnect();
             return false;
         }
+        timer.Lap(Q1StatementPhase::Prepare);
 
         qDebug() << "Prepared query:" << queryStr;
         qDebug() << "\nBinding values:";
 
         // Bind values for non-auto-increment columns
         int bindIndex = 0;
+        QVariantList binds;
         for (const Q1Column& col : table.columns)
         {
             // Skip auto-generated primary key
-            if (col.primary_key)
+            if (IsAutoPrimaryKey(col))
             {
-                bool is_auto = false;
-
-                if (col.default_value.isEmpty())
-                {
-                    is_auto = true;
-                }
-                else if (col.default_value.contains("IDENTITY", Qt::CaseInsensitive) ||
-                         col.default_value.contains("SERIAL", Qt::CaseInsensitive) ||
-                         col.default_value.contains("nextval", Qt::CaseInsensitive) ||
-                         col.default_value.contains("GENERATED", Qt::CaseInsensitive))
-                {
-                    is_auto = true;
-                }
-
-                if (is_auto)
-                {
-                    continue;
-                }
+                continue;
             }
 
             auto it = property_map.find(col.name);
@@ -464,8 +552,10 @@ public:
 
             qDebug() << "  [" << bindIndex << "]" << col.name << "=" << value;
             sql_query.addBindValue(value);
+            binds.append(value);
             bindIndex++;
         }
+        timer.SetBinds(binds);
 
         qDebug() << "\nExecuting query...";
 
@@ -478,6 +568,7 @@ public:
             connection->Disconnect();
             return false;
         }
+        timer.Lap(Q1StatementPhase::Execute);
 
         // Retrieve auto-generated PK
         if (has_auto_pk)
@@ -529,6 +620,10 @@ public:
             }
         }
 
+        timer.Lap(Q1StatementPhase::Fetch);
+        timer.AddRows(1);
+        timer.Finish(true);
+
         qDebug() << "✓ Insert successful!";
         qDebug() << "========================\n";
         connection->Disconnect();
@@ -536,16 +631,33 @@ public:
     }
 
 
+    // Resolves to the inserted entity with its generated primary key filled in, or to
+    // std::nullopt when the insert failed
+    QFuture<std::optional<Entity>> InsertAsync(const Entity& entity) const
+    {
+        return RunAsync([entity](Q1Entity<Entity>& repository) -> std::optional<Entity> {
+            Entity inserted = entity;
+            if (!repository.Insert(inserted))
+                return std::nullopt;
+            return inserted;
+        });
+    }
+
+
 /* ************************ Update Opertation ************************************** */
 
     // Update entity in database
     bool Update(Entity& entity, const QString& where_clause)
     {
+        Q1StatementTimer timer(connection, "update", table.table_name);
+
         if (!connection || !connection->Connect())
         {
             last_error = "Database connection failed";
             return false;
         }
+        timer.Lap(Q1StatementPhase::Connect);
+        connection->MarkWrite();
 
         QStringList set_clauses;
         QList<QVariant> values;
@@ -633,6 +745,8 @@ public:
 
         qDebug() << "Query:" << query;
         qDebug() << "Binding" << values.size() << "values...";
+        timer.SetSql(query);
+        timer.SetBinds(values);
 
         QSqlQuery sql_query(connection->database);
         if (!sql_query.prepare(query))
@@ -642,6 +756,7 @@ public:
             connection->Disconnect();
             return false;
         }
+        timer.Lap(Q1StatementPhase::Prepare);
 
         // Bind values in the order of set_clauses
         for (int i = 0; i < values.size(); ++i)
@@ -661,7 +776,11 @@ public:
             return false;
         }
 
+        timer.Lap(Q1StatementPhase::Execute);
+
         int rows_affected = sql_query.numRowsAffected();
+        timer.AddRows(rows_affected);
+        timer.Finish(true);
         qDebug() << "✓ Update successful!";
         qDebug() << "Rows affected:" << rows_affected;
 
@@ -703,17 +822,38 @@ public:
     }
 
 
+    QFuture<bool> UpdateAsync(const Entity& entity, const QString& where_clause) const
+    {
+        return RunAsync([entity, where_clause](Q1Entity<Entity>& repository) {
+            Entity updated = entity;
+            return repository.Update(updated, where_clause);
+        });
+    }
+
+    QFuture<bool> UpdateByIdAsync(const Entity& entity, int id) const
+    {
+        return RunAsync([entity, id](Q1Entity<Entity>& repository) {
+            Entity updated = entity;
+            return repository.UpdateById(updated, id);
+        });
+    }
+
+
 /* ************************ Delete Opertation ************************************** */
 
 
     // Delete entity from database
     bool Delete(const QString& where_clause)
     {
+        Q1StatementTimer timer(connection, "delete", table.table_name);
+
         if (!connection || !connection->Connect())
         {
             last_error = "Database connection failed";
             return false;
         }
+        timer.Lap(Q1StatementPhase::Connect);
+        connection->MarkWrite();
 
         qDebug() << "\n=== DELETE DEBUG INFO ===";
         qDebug() << "Table:" << table.table_name;
@@ -732,6 +872,8 @@ public:
 
         qDebug() << "Query:" << query;
         qDebug() << "Executing delete...";
+        timer.SetSql(query);
+        timer.Lap(Q1StatementPhase::Prepare);
 
         QSqlQuery sql_query(connection->database);
         bool success = sql_query.exec(query);
@@ -745,7 +887,11 @@ public:
             return false;
         }
 
+        timer.Lap(Q1StatementPhase::Execute);
+
         int rows_affected = sql_query.numRowsAffected();
+        timer.AddRows(rows_affected);
+        timer.Finish(true);
         qDebug() << "✓ Delete successful!";
         qDebug() << "Rows affected:" << rows_affected;
 
@@ -787,6 +933,197 @@ public:
 
 
 
+    QFuture<bool> DeleteAsync(const QString& where_clause) const
+    {
+        return RunAsync([where_clause](Q1Entity<Entity>& repository) {
+            return repository.Delete(where_clause);
+        });
+    }
+
+    QFuture<bool> DeleteByIdAsync(int id) const
+    {
+        return RunAsync([id](Q1Entity<Entity>& repository) {
+            return repository.DeleteById(id);
+        });
+    }
+
+
+
+    // Set-based UPDATE of the given columns on every row matching where_clause.
+    // Returns the number of affected rows, or -1 on error.
+    int UpdateWhere(const QVariantMap& values, const QString& where_clause)
+    {
+        if (values.isEmpty())
+        {
+            last_error = "No columns to update";
+            qDebug() << "❌ Update FAILED:" << last_error;
+            return -1;
+        }
+
+        if (where_clause.isEmpty())
+        {
+            last_error = "UPDATE without WHERE clause is dangerous and not allowed";
+            qDebug() << "❌ Update FAILED: WHERE clause is required";
+            return -1;
+        }
+
+        QStringList set_clauses;
+        QVariantList binds;
+        for (auto it = values.constBegin(); it != values.constEnd(); ++it)
+        {
+            if (!table.HasColumn(it.key()))
+            {
+                last_error = QString("Unknown column: %1").arg(it.key());
+                qDebug() << "❌ Update FAILED:" << last_error;
+                return -1;
+            }
+
+            set_clauses.append(QuoteIdentifier(it.key()) + " = ?");
+            binds.append(it.value());
+        }
+
+        QString query = QString("UPDATE %1 SET %2 WHERE %3")
+                            .arg(QuoteIdentifier(table.table_name), set_clauses.join(", "), where_clause);
+
+        return ExecuteNonQuery(query, binds);
+    }
+
+    // Set-based DELETE; returns the number of affected rows, or -1 on error
+    int DeleteWhere(const QString& where_clause)
+    {
+        if (where_clause.isEmpty())
+        {
+            last_error = "DELETE without WHERE clause is dangerous and not allowed";
+            qDebug() << "❌ Delete FAILED: WHERE clause is required for safety";
+            return -1;
+        }
+
+        QString query = QString("DELETE FROM %1 WHERE %2")
+                            .arg(QuoteIdentifier(table.table_name), where_clause);
+
+        return ExecuteNonQuery(query);
+    }
+
+
+/* ************************ Upsert Opertation ************************************** */
+
+
+    // Insert entity, or update the row that has the same conflict_columns values.
+    // conflict_columns must be covered by a primary key or unique constraint.
+    bool Upsert(Entity& entity, const QStringList& conflict_columns)
+    {
+        QList<Entity> entities;
+        entities.append(entity);
+
+        if (!UpsertRange(entities, conflict_columns))
+        {
+            return false;
+        }
+
+        entity = entities.first();
+        return true;
+    }
+
+    // One INSERT ... ON CONFLICT (PostgreSQL) or MERGE (SQL Server) per chunk of rows,
+    // all chunks in one transaction. Generated primary keys are written back.
+    bool UpsertRange(QList<Entity>& entities, const QStringList& conflict_columns)
+    {
+        if (entities.isEmpty())
+        {
+            return true;
+        }
+
+        if (conflict_columns.isEmpty())
+        {
+            last_error = "Upsert requires at least one conflict column";
+            qDebug() << "❌ Upsert FAILED:" << last_error;
+            return false;
+        }
+
+        QList<Q1Column> key_columns;
+        for (const QString& name : conflict_columns)
+        {
+            bool found = false;
+            for (const Q1Column& col : table.columns)
+            {
+                if (col.name.compare(name, Qt::CaseInsensitive) == 0)
+                {
+                    key_columns.append(col);
+                    found = true;
+                    break;
+                }
+            }
+
+            if (!found)
+            {
+                last_error = QString("Unknown conflict column: %1").arg(name);
+                qDebug() << "❌ Upsert FAILED:" << last_error;
+                return false;
+            }
+        }
+
+        // Auto-generated primary keys are only sent when they are part of the conflict target
+        QList<Q1Column> value_columns;
+        const Q1Column* pk_col = nullptr;
+        for (const Q1Column& col : table.columns)
+        {
+            if (col.primary_key)
+            {
+                pk_col = &col;
+            }
+
+            if (IsAutoPrimaryKey(col) && !IsKeyColumn(col, key_columns))
+            {
+                continue;
+            }
+
+            value_columns.append(col);
+        }
+
+        // SQL Server also allows at most 1000 rows in a table value constructor
+        const int rows_per_chunk = qBound(1, MaxBindParameters() / qMax(1, value_columns.size()), 1000);
+
+        if (!connection || !connection->Connect())
+        {
+            last_error = "Database connection failed";
+            return false;
+        }
+        connection->MarkWrite();
+
+        qDebug() << "\n=== UPSERT DEBUG INFO ===";
+        qDebug() << "Table:" << table.table_name;
+        qDebug() << "Conflict columns:" << conflict_columns;
+        qDebug() << "Rows:" << entities.size() << "| Rows per statement:" << rows_per_chunk;
+
+        const bool in_transaction = connection->database.transaction();
+
+        bool success = true;
+        for (int start = 0; start < entities.size() && success; start += rows_per_chunk)
+        {
+            const int count = qMin(rows_per_chunk, entities.size() - start);
+            success = UpsertChunk(entities, start, count, value_columns, key_columns, pk_col);
+        }
+
+        if (in_transaction)
+        {
+            if (success)
+            {
+                connection->database.commit();
+            }
+            else
+            {
+                connection->database.rollback();
+            }
+        }
+
+        qDebug() << (success ? "✓ Upsert successful!" : "❌ Upsert FAILED");
+        qDebug() << "========================\n";
+        connection->Disconnect();
+        return success;
+    }
+
+
+
 /* ************************ Select Opertation ************************************** */
 
 
@@ -815,36 +1152,137 @@ public:
                          const QString& having_clause = QString())
     {
         lastJson = QJsonArray(); // Clear previous JSON
+        last_error.clear();
         QList<Entity> results;
+        Q1StatementTimer timer(connection, "select", table.table_name);
+        Q1Connection* reader = ReadConnection();
+        timer.SetConnection(reader);
 
-        if (!connection || !connection->Connect()) {
+        if (!reader || !reader->Connect()) {
             last_error = "Database connection failed";
             return results;
         }
+        timer.Lap(Q1StatementPhase::Connect);
 
-        // Build SQL query
-        QString query;
+        QString query = BuildSelectSql(where_clause, order_by, limit, joins, columns, group_by, having_clause);
 
-        // SELECT clause
-        if (!columns.isEmpty()) {
-            query = "SELECT ";
-            if (limit > 0 && UsesSqlServer())
-                query += QString("TOP %1 ").arg(limit);
+        qDebug() << "SQL Query:" << query;
+        timer.SetSql(query);
+        timer.Lap(Q1StatementPhase::Prepare);
 
-            query += columns.join(", ");
-        } else {
-            query = "SELECT ";
-            if (limit > 0 && UsesSqlServer())
-                query += QString("TOP %1 ").arg(limit);
+        QSqlQuery sql_query(reader->database);
+        sql_query.setForwardOnly(true);
+        if (!sql_query.exec(query)) {
+            last_error = sql_query.lastError().text();
+            qDebug() << "Select failed:" << last_error;
+            reader->Disconnect();
+            return results;
+        }
+        timer.Lap(Q1StatementPhase::Execute);
+
+        // Convert ALL result columns to JSON (including joined columns)
+        results = ReadResult(sql_query, &lastJson, &timer);
+        timer.AddRows(results.size());
+        timer.Finish(true);
+
+        reader->Disconnect();
+        return results;
+    }
+
+    // Loads the row whose primary key equals key. found (if given) tells a missing
+    // row apart from a row that hydrates to a default Entity.
+    template<typename Key>
+    Entity FindById(const Key& key, bool* found = nullptr)
+    {
+        const QList<Entity> rows = FindMany(QList<Key>{key});
+        if (found) *found = !rows.isEmpty();
+        return rows.isEmpty() ? Entity{} : rows.first();
+    }
+
+    // Loads the rows for keys with one bound IN (...) query per chunk of keys instead
+    // of one query per key. The result follows the order of keys (a key listed twice
+    // appears twice); keys without a row are appended once to missing.
+    template<typename Key>
+    QList<Entity> FindMany(const QList<Key>& keys, QList<Key>* missing = nullptr)
+    {
+        QList<Entity> results;
+        if (keys.isEmpty()) return results;
 
-            query += QString("* FROM %1").arg(QuoteIdentifier(table.table_name));
+        const QList<Q1Column> pk_columns = table.GetPrimaryKeys();
+        if (pk_columns.size() != 1) {
+            last_error = pk_columns.isEmpty() ? "No primary key defined for this table"
+                                              : "FindMany does not support composite primary keys";
+            qDebug() << "❌ FindMany FAILED:" << last_error;
+            return results;
+        }
+        const Q1Column pk_col = pk_columns.first();
+
+        // Each key is sent once; rows are matched back by the key's text form
+        QVariantList unique_keys;
+        QSet<QString> seen;
+        for (const Key& key : keys) {
+            const QVariant value = QVariant::fromValue(key);
+            if (seen.contains(value.toString())) continue;
+            seen.insert(value.toString());
+            unique_keys.append(value);
         }
 
-        // FROM clause (only if columns are specified)
-        if (!columns.isEmpty()) {
-            query += QString(" FROM %1").arg(QuoteIdentifier(table.table_name));
+        QHash<QString, Entity> rows_by_key;
+        const int chunk_size = MaxBindParameters();
+        for (int start = 0; start < unique_keys.size(); start += chunk_size) {
+            const QVariantList chunk = unique_keys.mid(start, chunk_size);
+
+            QString where_clause;
+            if (chunk.size() == 1) {
+                where_clause = QString("%1 = ?").arg(QuoteIdentifier(pk_col.name));
+            } else {
+                QStringList placeholders;
+                for (int i = 0; i < chunk.size(); ++i) placeholders.append("?");
+                where_clause = QString("%1 IN (%2)").arg(QuoteIdentifier(pk_col.name), placeholders.join(", "));
+            }
+
+            bool ok = false;
+            const QList<Entity> rows = SelectBound(where_clause, chunk, &ok);
+            if (!ok) return QList<Entity>();
+
+            for (const Entity& entity : rows) {
+                rows_by_key.insert(PropertyValue(entity, pk_col).toString(), entity);
+            }
         }
 
+        QSet<QString> reported;
+        for (const Key& key : keys) {
+            const QString text = QVariant::fromValue(key).toString();
+            auto it = rows_by_key.constFind(text);
+            if (it != rows_by_key.constEnd()) {
+                results.append(it.value());
+            } else if (missing && !reported.contains(text)) {
+                reported.insert(text);
+                missing->append(key);
+            }
+        }
+
+        return results;
+    }
+
+    QString BuildSelectSql(const QString& where_clause = QString(),
+                           const QString& order_by = QString(),
+                           int limit = -1,
+                           const QString& joins = QString(),
+                           const QStringList& columns = QStringList(),
+                           const QString& group_by = QString(),
+                           const QString& having_clause = QString()) const
+    {
+        // SELECT clause
+        QString query = "SELECT ";
+        if (limit > 0 && UsesSqlServer())
+            query += QString("TOP %1 ").arg(limit);
+
+        query += columns.isEmpty() ? QString("*") : columns.join(", ");
+
+        // FROM clause
+        query += QString(" FROM %1").arg(QuoteIdentifier(table.table_name));
+
         // JOIN clause
         if (!joins.isEmpty()) {
             query += joins;
@@ -875,142 +1313,449 @@ public:
             query += " LIMIT " + QString::number(limit);
         }
 
+        return query;
+    }
+
+    // Hydrate the remaining rows of an executed query; json (if given) receives
+    // every result column, including joined and aliased ones. timer (if given) is
+    // charged fetch time for next() and hydrate time for the conversion.
+    QList<Entity> ReadResult(QSqlQuery& sql_query, QJsonArray* json = nullptr,
+                             Q1StatementTimer* timer = nullptr) const
+    {
+        QList<Entity> results;
+        const QSqlRecord rec = sql_query.record();
+        const bool timed = timer && timer->IsEnabled();
+
+        while (sql_query.next()) {
+            if (timed) timer->Lap(Q1StatementPhase::Fetch);
+
+            Entity entity;
+            ReadEntity(sql_query, rec, entity);
+
+            if (json) {
+                json->append(ReadJson(sql_query, rec));
+            }
+
+            results.append(entity);
+            if (timed) timer->Lap(Q1StatementPhase::Hydrate);
+        }
+
+        if (timed) timer->Lap(Q1StatementPhase::Fetch);
+        return results;
+    }
+
+    // Populate entity members from table.columns
+    void ReadEntity(const QSqlQuery& sql_query, const QSqlRecord& rec, Entity& entity) const
+    {
+        for (const Q1Column& col : table.columns) {
+            // Get column index (works for simple select and joins)
+            int colIndex = rec.indexOf(col.name);
+            if (colIndex < 0) continue;
+
+            AssignValue(entity, col, sql_query.value(colIndex));
+        }
+    }
+
+    Entity JsonToEntity(const QJsonObject& obj) const
+    {
+        Entity entity;
+
+        for (const Q1Column& col : table.columns) {
+            auto it = obj.constFind(col.name);
+            if (it == obj.constEnd()) continue;
+
+            AssignValue(entity, col, it.value().toVariant());
+        }
+
+        return entity;
+    }
+
+    static QJsonObject ReadJson(const QSqlQuery& sql_query, const QSqlRecord& rec)
+    {
+        QJsonObject obj;
+
+        for (int i = 0; i < rec.count(); ++i) {
+            const QString colName = rec.fieldName(i);
+            if (obj.contains(colName)) continue; // first occurrence wins on name clashes
+
+            obj.insert(colName, ToJsonValue(sql_query.value(i)));
+        }
+
+        return obj;
+    }
+
+    static QJsonValue ToJsonValue(const QVariant& val)
+    {
+        if (val.isNull()) {
+            return QJsonValue(QJsonValue::Null);
+        } else if (val.type() == QVariant::Int) {
+            return val.toInt();
+        } else if (val.type() == QVariant::Double) {
+            return val.toDouble();
+        } else if (val.type() == QVariant::Bool) {
+            return val.toBool();
+        } else if (val.type() == QVariant::Date) {
+            return val.toDate().toString(Qt::ISODate);
+        } else if (val.type() == QVariant::DateTime) {
+            return val.toDateTime().toString(Qt::ISODate);
+        }
+
+        return val.toString();
+    }
+
+
+
+
+private:
+    // Runs function on Q1Executor's pool against a copy of this entity set that is
+    // bound to the pool thread's connection. Its statements count in the caller's
+    // Q1QueryScope.
+    template<typename Function>
+    auto RunAsync(Function function) const -> QFuture<decltype(function(std::declval<Q1Entity<Entity>&>()))>
+    {
+        const QSharedPointer<Q1Entity<Entity>> snapshot(new Q1Entity<Entity>(*this));
+        const Qt::HANDLE scope_thread = Q1QueryCounter::ScopeThread();
+
+        return QtConcurrent::run(Q1Executor::Pool(), [snapshot, function, scope_thread]() {
+            const Q1QueryScopeHandoff handoff(scope_thread);
+            snapshot->BindToCurrentThread();
+            return function(*snapshot);
+        });
+    }
+
+    void AssignValue(Entity& entity, const Q1Column& col, const QVariant& val) const
+    {
+        auto it = property_map.find(col.name);
+        if (it == property_map.end()) return;
+
+        const PropertyInfo& info = it.value();
+        char* memberPtr = reinterpret_cast<char*>(&entity) + info.offset;
+
+        if (val.isNull()) {
+            switch (col.type) {
+            case INTEGER:
+            case SMALLINT:
+            case BIGINT:
+                *reinterpret_cast<int*>(memberPtr) = 0;
+                break;
+            case REAL:
+                *reinterpret_cast<float*>(memberPtr) = 0.0f;
+                break;
+            case DOUBLE_PRECISION:
+                *reinterpret_cast<double*>(memberPtr) = 0.0;
+                break;
+            case BOOLEAN:
+                *reinterpret_cast<bool*>(memberPtr) = false;
+                break;
+            case CHAR:
+            case TEXT:
+            case VARCHAR:
+                *reinterpret_cast<QString*>(memberPtr) = QString();
+                break;
+            case DATE:
+                *reinterpret_cast<QDate*>(memberPtr) = QDate();
+                break;
+            case TIMESTAMP:
+                *reinterpret_cast<QDateTime*>(memberPtr) = QDateTime();
+                break;
+            default:
+                break;
+            }
+        } else {
+            switch (col.type) {
+            case INTEGER:
+                *reinterpret_cast<int*>(memberPtr) = val.toInt();
+                break;
+            case SMALLINT:
+                *reinterpret_cast<short*>(memberPtr) = static_cast<short>(val.toInt());
+                break;
+            case BIGINT:
+                *reinterpret_cast<long long*>(memberPtr) = val.toLongLong();
+                break;
+            case REAL:
+                *reinterpret_cast<float*>(memberPtr) = static_cast<float>(val.toDouble());
+                break;
+            case DOUBLE_PRECISION:
+                *reinterpret_cast<double*>(memberPtr) = val.toDouble();
+                break;
+            case BOOLEAN:
+                *reinterpret_cast<bool*>(memberPtr) = val.toBool();
+                break;
+            case CHAR:
+            case TEXT:
+            case VARCHAR:
+                *reinterpret_cast<QString*>(memberPtr) = val.toString();
+                break;
+            case DATE:
+                *reinterpret_cast<QDate*>(memberPtr) = val.toDate();
+                break;
+            case TIMESTAMP:
+                *reinterpret_cast<QDateTime*>(memberPtr) = val.toDateTime();
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    QVariant PropertyValue(const Entity& entity, const Q1Column& col) const
+    {
+        auto it = property_map.find(col.name);
+        if (it == property_map.end()) return QVariant();
+
+        const PropertyInfo& info = it.value();
+        const char* memberPtr = reinterpret_cast<const char*>(&entity) + info.offset;
+
+        switch (col.type) {
+        case INTEGER:
+            return *reinterpret_cast<const int*>(memberPtr);
+        case SMALLINT:
+            return *reinterpret_cast<const short*>(memberPtr);
+        case BIGINT:
+            return *reinterpret_cast<const long long*>(memberPtr);
+        case REAL:
+            return *reinterpret_cast<const float*>(memberPtr);
+        case DOUBLE_PRECISION:
+            return *reinterpret_cast<const double*>(memberPtr);
+        case BOOLEAN:
+            return *reinterpret_cast<const bool*>(memberPtr);
+        case CHAR:
+        case TEXT:
+        case VARCHAR:
+            return *reinterpret_cast<const QString*>(memberPtr);
+        case DATE:
+            return *reinterpret_cast<const QDate*>(memberPtr);
+        case TIMESTAMP:
+            return *reinterpret_cast<const QDateTime*>(memberPtr);
+        default:
+            return QVariant();
+        }
+    }
+
+    // Bind values per statement: PostgreSQL allows 65535, SQL Server 2100 and
+    // SQLite 999 before 3.32; stay below all of them with room to spare.
+    int MaxBindParameters() const
+    {
+        if (UsesSqlServer()) return 2000;
+        if (UsesSqlite()) return 999;
+        return 30000;
+    }
+
+    // SELECT * with a bound WHERE clause; ok (if given) reports whether it ran
+    QList<Entity> SelectBound(const QString& where_clause, const QVariantList& binds, bool* ok = nullptr)
+    {
+        QList<Entity> results;
+        if (ok) *ok = false;
+        Q1StatementTimer timer(connection, "select", table.table_name);
+        Q1Connection* reader = ReadConnection();
+        timer.SetConnection(reader);
+
+        if (!reader || !reader->Connect()) {
+            last_error = "Database connection failed";
+            return results;
+        }
+        timer.Lap(Q1StatementPhase::Connect);
+
+        const QString query = BuildSelectSql(where_clause);
         qDebug() << "SQL Query:" << query;
+        timer.SetSql(query);
+        timer.SetBinds(binds);
 
-        QSqlQuery sql_query(connection->database);
-        if (!sql_query.exec(query)) {
+        QSqlQuery sql_query(reader->database);
+        sql_query.setForwardOnly(true);
+        if (!sql_query.prepare(query)) {
             last_error = sql_query.lastError().text();
             qDebug() << "Select failed:" << last_error;
-            connection->Disconnect();
+            reader->Disconnect();
             return results;
         }
 
-        QSqlRecord rec = sql_query.record();
-        QStringList allColumnNames;
+        for (const QVariant& value : binds) {
+            sql_query.addBindValue(value);
+        }
+        timer.Lap(Q1StatementPhase::Prepare);
 
-        // Get all column names from result set
-        for (int i = 0; i < rec.count(); ++i) {
-            allColumnNames << rec.fieldName(i);
+        if (!sql_query.exec()) {
+            last_error = sql_query.lastError().text();
+            qDebug() << "Select failed:" << last_error;
+            reader->Disconnect();
+            return results;
         }
+        timer.Lap(Q1StatementPhase::Execute);
 
-        while (sql_query.next()) {
-            Entity entity;
+        results = ReadResult(sql_query, nullptr, &timer);
+        timer.AddRows(results.size());
+        timer.Finish(true);
 
-            // Populate entity members from table.columns
-            for (const Q1Column& col : table.columns) {
-                auto it = property_map.find(col.name);
-                if (it == property_map.end()) continue;
+        reader->Disconnect();
+        if (ok) *ok = true;
+        return results;
+    }
 
-                const PropertyInfo& info = it.value();
-                char* memberPtr = reinterpret_cast<char*>(&entity) + info.offset;
-
-                // Get column index (works for simple select and joins)
-                int colIndex = rec.indexOf(col.name);
-                if (colIndex < 0) continue;
-
-                QVariant val = sql_query.value(colIndex);
-
-                if (val.isNull()) {
-                    switch (col.type) {
-                    case INTEGER:
-                    case SMALLINT:
-                    case BIGINT:
-                        *reinterpret_cast<int*>(memberPtr) = 0;
-                        break;
-                    case REAL:
-                        *reinterpret_cast<float*>(memberPtr) = 0.0f;
-                        break;
-                    case DOUBLE_PRECISION:
-                        *reinterpret_cast<double*>(memberPtr) = 0.0;
-                        break;
-                    case BOOLEAN:
-                        *reinterpret_cast<bool*>(memberPtr) = false;
-                        break;
-                    case CHAR:
-                    case TEXT:
-                    case VARCHAR:
-                        *reinterpret_cast<QString*>(memberPtr) = QString();
-                        break;
-                    case DATE:
-                        *reinterpret_cast<QDate*>(memberPtr) = QDate();
-                        break;
-                    case TIMESTAMP:
-                        *reinterpret_cast<QDateTime*>(memberPtr) = QDateTime();
-                        break;
-                    default:
-                        break;
-                    }
-                } else {
-                    switch (col.type) {
-                    case INTEGER:
-                        *reinterpret_cast<int*>(memberPtr) = val.toInt();
-                        break;
-                    case SMALLINT:
-                        *reinterpret_cast<short*>(memberPtr) = static_cast<short>(val.toInt());
-                        break;
-                    case BIGINT:
-                        *reinterpret_cast<long long*>(memberPtr) = val.toLongLong();
-                        break;
-                    case REAL:
-                        *reinterpret_cast<float*>(memberPtr) = static_cast<float>(val.toDouble());
-                        break;
-                    case DOUBLE_PRECISION:
-                        *reinterpret_cast<double*>(memberPtr) = val.toDouble();
-                        break;
-                    case BOOLEAN:
-                        *reinterpret_cast<bool*>(memberPtr) = val.toBool();
-                        break;
-                    case CHAR:
-                    case TEXT:
-                    case VARCHAR:
-                        *reinterpret_cast<QString*>(memberPtr) = val.toString();
-                        break;
-                    case DATE:
-                        *reinterpret_cast<QDate*>(memberPtr) = val.toDate();
-                        break;
-                    case TIMESTAMP:
-                        *reinterpret_cast<QDateTime*>(memberPtr) = val.toDateTime();
-                        break;
-                    default:
-                        break;
-                    }
-                }
+    static bool IsAutoPrimaryKey(const Q1Column& col)
+    {
+        if (!col.primary_key)
+            return false;
+
+        return col.default_value.isEmpty() ||
+               col.default_value.contains("IDENTITY", Qt::CaseInsensitive) ||
+               col.default_value.contains("SERIAL", Qt::CaseInsensitive) ||
+               col.default_value.contains("nextval", Qt::CaseInsensitive) ||
+               col.default_value.contains("GENERATED", Qt::CaseInsensitive);
+    }
+
+    static bool IsKeyColumn(const Q1Column& col, const QList<Q1Column>& key_columns)
+    {
+        for (const Q1Column& key : key_columns) {
+            if (key.name == col.name) return true;
+        }
+        return false;
+    }
+
+    static QString UpsertKey(const QVariantList& values)
+    {
+        QStringList parts;
+        for (const QVariant& value : values) {
+            parts.append(value.isNull() ? QString() : value.toString());
+        }
+        return parts.join(QChar(0x1f));
+    }
+
+    bool UpsertChunk(QList<Entity>& entities, int start, int count,
+                     const QList<Q1Column>& value_columns,
+                     const QList<Q1Column>& key_columns,
+                     const Q1Column* pk_col)
+    {
+        Q1StatementTimer timer(connection, "upsert", table.table_name);
+
+        // Both dialects reject touching a row twice in one statement, so rows with the
+        // same key are sent once (the last one wins) and all of them get the key back.
+        QMap<QString, QList<int>> rows_by_key;
+        QStringList key_order;
+        for (int i = start; i < start + count; ++i) {
+            QVariantList key_values;
+            for (const Q1Column& col : key_columns) {
+                key_values.append(PropertyValue(entities[i], col));
             }
 
-            // Convert ALL result columns to JSON (including joined columns)
-            QJsonObject obj;
-            for (const QString& colName : allColumnNames) {
-                QVariant val = sql_query.value(rec.indexOf(colName));
-
-                if (val.isNull()) {
-                    obj.insert(colName, QJsonValue::Null);
-                } else if (val.type() == QVariant::Int) {
-                    obj.insert(colName, val.toInt());
-                } else if (val.type() == QVariant::Double) {
-                    obj.insert(colName, val.toDouble());
-                } else if (val.type() == QVariant::Bool) {
-                    obj.insert(colName, val.toBool());
-                } else if (val.type() == QVariant::Date) {
-                    obj.insert(colName, val.toDate().toString(Qt::ISODate));
-                } else if (val.type() == QVariant::DateTime) {
-                    obj.insert(colName, val.toDateTime().toString(Qt::ISODate));
-                } else {
-                    obj.insert(colName, val.toString());
-                }
+            const QString key = UpsertKey(key_values);
+            if (!rows_by_key.contains(key)) key_order.append(key);
+            rows_by_key[key].append(i);
+        }
+
+        QStringList placeholders;
+        for (int i = 0; i < value_columns.size(); ++i) {
+            placeholders.append("?");
+        }
+        const QString row = "(" + placeholders.join(", ") + ")";
+
+        QStringList rows;
+        for (int i = 0; i < key_order.size(); ++i) {
+            rows.append(row);
+        }
+
+        QStringList columns, keys, update_set, insert_columns, insert_values, match, output;
+        for (const Q1Column& col : value_columns) {
+            const QString name = QuoteIdentifier(col.name);
+            columns.append(name);
+
+            if (!UsesSqlServer() || !IsAutoPrimaryKey(col)) {
+                insert_columns.append(name);
+                insert_values.append("source." + name);
             }
 
-            lastJson.append(obj);
-            results.append(entity);
+            if (col.primary_key || IsKeyColumn(col, key_columns)) continue;
+
+            update_set.append(UsesSqlServer() ? QString("target.%1 = source.%1").arg(name)
+                                              : QString("%1 = EXCLUDED.%1").arg(name));
         }
 
-        connection->Disconnect();
-        return results;
-    }
+        for (const Q1Column& col : key_columns) {
+            const QString name = QuoteIdentifier(col.name);
+            keys.append(name);
+            match.append(QString("target.%1 = source.%1").arg(name));
+            output.append(UsesSqlServer() ? "INSERTED." + name : name);
+        }
 
+        if (pk_col) {
+            output.append(UsesSqlServer() ? "INSERTED." + QuoteIdentifier(pk_col->name)
+                                          : QuoteIdentifier(pk_col->name));
+        }
 
+        // Nothing to update: touch a key column so existing rows are still returned
+        if (update_set.isEmpty()) {
+            update_set.append(UsesSqlServer() ? QString("target.%1 = source.%1").arg(keys.first())
+                                              : QString("%1 = EXCLUDED.%1").arg(keys.first()));
+        }
 
+        QString query;
+        if (UsesSqlServer()) {
+            query = QString("MERGE INTO %1 WITH (HOLDLOCK) AS target "
+                            "USING (VALUES %2) AS source (%3) ON %4 "
+                            "WHEN MATCHED THEN UPDATE SET %5 "
+                            "WHEN NOT MATCHED THEN INSERT (%6) VALUES (%7)")
+                        .arg(QuoteIdentifier(table.table_name), rows.join(", "), columns.join(", "),
+                             match.join(" AND "), update_set.join(", "),
+                             insert_columns.join(", "), insert_values.join(", "));
+            if (pk_col) query += " OUTPUT " + output.join(", ");
+            query += ";";
+        } else {
+            query = QString("INSERT INTO %1 (%2) VALUES %3 ON CONFLICT (%4) DO UPDATE SET %5")
+                        .arg(QuoteIdentifier(table.table_name), columns.join(", "), rows.join(", "),
+                             keys.join(", "), update_set.join(", "));
+            if (pk_col) query += " RETURNING " + output.join(", ");
+        }
+
+        qDebug() << "Query:" << query;
+        timer.SetSql(query);
+
+        QSqlQuery sql_query(connection->database);
+        if (!sql_query.prepare(query)) {
+            last_error = sql_query.lastError().text();
+            qDebug() << "❌ Query preparation failed:" << last_error;
+            return false;
+        }
+
+        for (const QString& key : key_order) {
+            const Entity& entity = entities[rows_by_key[key].last()];
+            for (const Q1Column& col : value_columns) {
+                sql_query.addBindValue(PropertyValue(entity, col));
+            }
+        }
+
+        timer.Lap(Q1StatementPhase::Prepare);
+
+        if (!sql_query.exec()) {
+            last_error = sql_query.lastError().text();
+            qDebug() << "❌ Upsert FAILED:" << last_error;
+            return false;
+        }
+        timer.Lap(Q1StatementPhase::Execute);
+        timer.AddRows(key_order.size());
+
+        if (!pk_col) {
+            timer.Finish(true);
+            return true;
+        }
+
+        // Write generated keys back, matching returned rows by their conflict values
+        while (sql_query.next()) {
+            QVariantList key_values;
+            for (int i = 0; i < key_columns.size(); ++i) {
+                key_values.append(sql_query.value(i));
+            }
+
+            const QVariant pk_value = sql_query.value(key_columns.size());
+            for (int index : rows_by_key.value(UpsertKey(key_values))) {
+                AssignValue(entities[index], *pk_col, pk_value);
+            }
+        }
+
+        timer.Lap(Q1StatementPhase::Fetch);
+        timer.Finish(true);
+        return true;
+    }
 
-private:
     template<typename T>
     int DetermineSize(Q1ColumnDataType type)
     {
@@ -1093,148 +1838,232 @@ public:
 
 
 
-    QVariant ExecuteScalar(const QString& sql)
+    // Runs a statement with positional bind values; returns affected rows or -1 on error
+    int ExecuteNonQuery(const QString& sql, const QVariantList& binds = QVariantList())
     {
+        Q1StatementTimer timer(connection, "execute", table.table_name);
+
         if(!connection || !connection->Connect())
         {
             last_error = "Database connection failed";
-            return QVariant();
+            return -1;
         }
+        timer.Lap(Q1StatementPhase::Connect);
+        connection->MarkWrite();
+
+        qDebug() << "Executing statement:" << sql;
+        timer.SetSql(sql);
+        timer.SetBinds(binds);
 
         QSqlQuery query(connection->database);
+        if(!query.prepare(sql))
+        {
+            last_error = query.lastError().text();
+            qDebug() << "ExecuteNonQuery failed: " << last_error;
+            connection->Disconnect();
+            return -1;
+        }
+
+        for(const QVariant& value : binds)
+        {
+            query.addBindValue(value);
+        }
+        timer.Lap(Q1StatementPhase::Prepare);
+
+        if(!query.exec())
+        {
+            last_error = query.lastError().text();
+            qDebug() << "ExecuteNonQuery failed: " << last_error;
+            connection->Disconnect();
+            return -1;
+        }
+        timer.Lap(Q1StatementPhase::Execute);
+
+        int rows_affected = query.numRowsAffected();
+        qDebug() << "Rows affected:" << rows_affected;
+        timer.AddRows(rows_affected);
+        timer.Finish(true);
+
+        connection->Disconnect();
+        return rows_affected;
+    }
+
+    // generated: sql was built by Q1Query and may run on a replica; caller-written sql
+    // follows Q1Connection::SetRawReadsOnReplicas()
+    QVariant ExecuteScalar(const QString& sql, bool generated = false)
+    {
+        Q1StatementTimer timer(connection, "scalar", table.table_name);
+        Q1Connection* reader = generated ? ReadConnection(sql) : RawReadConnection(sql);
+        timer.SetConnection(reader);
+
+        if(!reader || !reader->Connect())
+        {
+            last_error = "Database connection failed";
+            return QVariant();
+        }
+        timer.Lap(Q1StatementPhase::Connect);
+        timer.SetSql(sql);
+
+        QSqlQuery query(reader->database);
         if(!query.exec(sql))
         {
             last_error = query.lastError().text();
             qDebug() << "ExecuteScalar failed: " << last_error;
-            connection->Disconnect();
+            reader->Disconnect();
             return QVariant();
         }
+        timer.Lap(Q1StatementPhase::Execute);
 
         QVariant result;
         if(query.next())
         {
             result = query.value(0);
+            timer.AddRows(1);
         }
+        timer.Lap(Q1StatementPhase::Fetch);
+        timer.Finish(true);
 
 
-        connection->Disconnect();
+        reader->Disconnect();
         return result;
     }
 
+    // Runs sql forward-only and calls handler for every row; generated as for ExecuteScalar()
+    bool ForEachRow(const QString& sql, const std::function<void(const QSqlQuery&)>& handler,
+                    bool generated = false)
+    {
+        Q1StatementTimer timer(connection, "query", table.table_name);
+        Q1Connection* reader = generated ? ReadConnection(sql) : RawReadConnection(sql);
+        timer.SetConnection(reader);
+
+        if(!reader || !reader->Connect())
+        {
+            last_error = "Database connection failed";
+            return false;
+        }
+        timer.Lap(Q1StatementPhase::Connect);
+
+        qDebug() << "Executing query:" << sql;
+        timer.SetSql(sql);
+
+        QSqlQuery query(reader->database);
+        query.setForwardOnly(true);
+        if(!query.exec(sql))
+        {
+            last_error = query.lastError().text();
+            qDebug() << "ForEachRow failed: " << last_error;
+            reader->Disconnect();
+            return false;
+        }
+        timer.Lap(Q1StatementPhase::Execute);
+
+        int rows = 0;
+        while(query.next())
+        {
+            timer.Lap(Q1StatementPhase::Fetch);
+            handler(query);
+            timer.Lap(Q1StatementPhase::Hydrate);
+            ++rows;
+        }
+        timer.Lap(Q1StatementPhase::Fetch);
+        timer.AddRows(rows);
+        timer.Finish(true);
+
+        reader->Disconnect();
+        return true;
+    }
+
 
     QList<QJsonObject> ExecuteRelationQuery(const QString& query)
     {
         QList<QJsonObject> results;
+        Q1StatementTimer timer(connection, "relation", table.table_name);
+        Q1Connection* reader = ReadConnection();
+        timer.SetConnection(reader);
 
-        if (!connection || !connection->Connect()) {
+        if (!reader || !reader->Connect()) {
             last_error = "Database connection failed";
             return results;
         }
+        timer.Lap(Q1StatementPhase::Connect);
 
         qDebug() << "Executing relation query:" << query;
+        timer.SetSql(query);
 
-        QSqlQuery sql_query(connection->database);
+        QSqlQuery sql_query(reader->database);
         if (!sql_query.exec(query)) {
             last_error = sql_query.lastError().text();
             qDebug() << "Relation query failed:" << last_error;
-            connection->Disconnect();
+            reader->Disconnect();
             return results;
         }
+        timer.Lap(Q1StatementPhase::Execute);
 
         QSqlRecord rec = sql_query.record();
-        QStringList columnNames;
-
-        // Get all column names from result set
-        for (int i = 0; i < rec.count(); ++i) {
-            columnNames << rec.fieldName(i);
-        }
 
         // Fetch all rows as JSON objects
         while (sql_query.next()) {
-            QJsonObject obj;
-
-            // Convert each column value to appropriate JSON type
-            for (const QString& colName : columnNames) {
-                QVariant val = sql_query.value(rec.indexOf(colName));
-
-                if (val.isNull()) {
-                    obj.insert(colName, QJsonValue::Null);
-                } else if (val.type() == QVariant::Int) {
-                    obj.insert(colName, val.toInt());
-                } else if (val.type() == QVariant::Double) {
-                    obj.insert(colName, val.toDouble());
-                } else if (val.type() == QVariant::Bool) {
-                    obj.insert(colName, val.toBool());
-                } else if (val.type() == QVariant::Date) {
-                    obj.insert(colName, val.toDate().toString(Qt::ISODate));
-                } else if (val.type() == QVariant::DateTime) {
-                    obj.insert(colName, val.toDateTime().toString(Qt::ISODate));
-                } else {
-                    obj.insert(colName, val.toString());
-                }
-            }
-
+            timer.Lap(Q1StatementPhase::Fetch);
+            QJsonObject obj = ReadJson(sql_query, rec);
             results.append(obj);
+            timer.Lap(Q1StatementPhase::Hydrate);
         }
+        timer.Lap(Q1StatementPhase::Fetch);
+        timer.AddRows(results.size());
+        timer.Finish(true);
 
-        connection->Disconnect();
+        reader->Disconnect();
         return results;
     }
 
+    QFuture<Q1AsyncResult<QList<QJsonObject>>> ExecuteAsync(const QString& query) const
+    {
+        return RunAsync([query](Q1Entity<Entity>& repository) {
+            Q1AsyncResult<QList<QJsonObject>> result;
+            result.value = repository.ExecuteQuery(query);
+            result.error = repository.GetLastError();
+            return result;
+        });
+    }
+
     QList<QJsonObject> ExecuteQuery(const QString& query)
     {
         QList<QJsonObject> results;
+        Q1StatementTimer timer(connection, "query", table.table_name);
+        Q1Connection* reader = RawReadConnection(query);
+        timer.SetConnection(reader);
 
-        if (!connection || !connection->Connect()) {
+        if (!reader || !reader->Connect()) {
             last_error = "Database connection failed";
             return results;
         }
+        timer.Lap(Q1StatementPhase::Connect);
 
         qDebug() << "Executing query:" << query;
+        timer.SetSql(query);
 
-        QSqlQuery sql_query(connection->database);
+        QSqlQuery sql_query(reader->database);
         if (!sql_query.exec(query)) {
             last_error = sql_query.lastError().text();
             qDebug() << "Query failed:" << last_error;
-            connection->Disconnect();
+            reader->Disconnect();
             return results;
         }
+        timer.Lap(Q1StatementPhase::Execute);
 
         QSqlRecord rec = sql_query.record();
 
-        // Get all column names
-        for (int i = 0; i < rec.count(); ++i) {
-            // Process each row
-            while (sql_query.next()) {
-                QJsonObject obj;
-
-                for (int j = 0; j < rec.count(); ++j) {
-                    QString colName = rec.fieldName(j);
-                    QVariant val = sql_query.value(j);
-
-                    if (val.isNull()) {
-                        obj.insert(colName, QJsonValue::Null);
-                    } else if (val.type() == QVariant::Int) {
-                        obj.insert(colName, val.toInt());
-                    } else if (val.type() == QVariant::Double) {
-                        obj.insert(colName, val.toDouble());
-                    } else if (val.type() == QVariant::Bool) {
-                        obj.insert(colName, val.toBool());
-                    } else if (val.type() == QVariant::Date) {
-                        obj.insert(colName, val.toDate().toString(Qt::ISODate));
-                    } else if (val.type() == QVariant::DateTime) {
-                        obj.insert(colName, val.toDateTime().toString(Qt::ISODate));
-                    } else {
-                        obj.insert(colName, val.toString());
-                    }
-                }
-
-                results.append(obj);
-            }
-            break;
+        // Process each row
+        while (sql_query.next()) {
+            timer.Lap(Q1StatementPhase::Fetch);
+            results.append(ReadJson(sql_query, rec));
+            timer.Lap(Q1StatementPhase::Hydrate);
         }
+        timer.Lap(Q1StatementPhase::Fetch);
+        timer.AddRows(results.size());
+        timer.Finish(true);
 
-        connection->Disconnect();
+        reader->Disconnect();
         return results;
     }
 
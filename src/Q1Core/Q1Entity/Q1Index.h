@@ -0,0 +1,80 @@
+#ifndef Q1INDEX_H
+#define Q1INDEX_H
+
+#include <QCryptographicHash>
+#include <QString>
+#include <QStringList>
+
+#include "../../Q1ORM_global.h"
+
+class Q1ORM_EXPORT Q1Index
+{
+public:
+    Q1Index() {}
+
+    Q1Index(const QString& table,
+            const QStringList& columns,
+            bool unique = false,
+            const QStringList& include_columns = QStringList(),
+            const QString& where = QString())
+        :
+        table(table),
+        columns(columns),
+        include_columns(include_columns),
+        where(where),
+        unique(unique)
+    {}
+
+    // IX_<table>_<columns> or UX_ for unique indexes, plus a hash of the include
+    // columns and predicate when there are any, so changing those renames the index
+    // and Initialize() rebuilds it. Only names following this pattern are ever dropped.
+    QString GetName() const
+    {
+        if (!name.isEmpty())
+            return name;
+
+        QString generated = (unique ? "UX_" : "IX_") + table + "_" + columns.join("_");
+
+        if (!include_columns.isEmpty() || !where.isEmpty())
+        {
+            const QByteArray shape = (include_columns.join(",") + "|" + where.simplified()).toUtf8();
+            generated += "_" + QString::fromLatin1(QCryptographicHash::hash(shape, QCryptographicHash::Md5).toHex().left(8));
+        }
+
+        // PostgreSQL truncates identifiers to 63 bytes, which would break the lookup by name
+        if (generated.size() <= 63)
+            return generated;
+
+        const QByteArray hash = QCryptographicHash::hash(generated.toUtf8(), QCryptographicHash::Md5).toHex();
+        return generated.left(54) + "_" + QString::fromLatin1(hash.left(8));
+    }
+
+    static bool IsGeneratedName(const QString& table, const QString& index_name)
+    {
+        return index_name.startsWith("IX_" + table + "_", Qt::CaseInsensitive) ||
+               index_name.startsWith("UX_" + table + "_", Qt::CaseInsensitive);
+    }
+
+    // True when the index can serve lookups on column (it is the leading key)
+    bool Leads(const QString& column) const
+    {
+        return !columns.isEmpty() && columns.first().compare(column, Qt::CaseInsensitive) == 0;
+    }
+
+    bool IsValid() const
+    {
+        return !table.isEmpty() && !columns.isEmpty();
+    }
+
+public:
+    QString table;
+    QStringList columns;
+    QStringList include_columns;    // covering columns (INCLUDE); ignored on SQLite
+    QString where;                  // partial index predicate, raw SQL
+    bool unique = false;
+    bool automatic = false;         // created for a foreign key, not declared
+    bool concurrently = true;       // PostgreSQL cannot build indexes of partitioned tables concurrently
+    QString name;                   // overrides GetName()
+};
+
+#endif // Q1INDEX_H
@@ -0,0 +1,173 @@
+#ifndef Q1PARTITION_H
+#define Q1PARTITION_H
+
+#include <QDate>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+
+#include "../../Q1ORM_global.h"
+
+enum Q1PartitionType
+{
+    NO_PARTITION,
+    RANGE,          // one partition per time interval of a DATE/TIMESTAMP column
+    LIST,           // one partition per declared value list, plus a default partition
+    HASH            // a fixed number of partitions by hash of the column
+};
+
+enum Q1PartitionInterval
+{
+    DAILY,
+    WEEKLY,
+    MONTHLY,
+    YEARLY
+};
+
+// Partitioning template of a table, declared with Q1Entity::PartitionBy().
+// RANGE partitions split a DATE or TIMESTAMP column and are named <table>_p<yyyyMMdd>
+// after their lower bound; the migration layer keeps Premake() future ones ahead
+// of today and drops the ones older than Retain() intervals.
+class Q1ORM_EXPORT Q1Partition
+{
+public:
+    Q1Partition() {}
+
+    Q1Partition(Q1PartitionType type, const QString& column)
+        : type(type), column(column)
+    {}
+
+    Q1Partition& Every(Q1PartitionInterval interval)
+    {
+        this->interval = interval;
+        return *this;
+    }
+
+    // Future RANGE partitions to create ahead of the current one
+    Q1Partition& Premake(int count)
+    {
+        premake = qMax(0, count);
+        return *this;
+    }
+
+    // Past RANGE partitions to keep; older ones are dropped. 0 keeps everything.
+    Q1Partition& Retain(int count)
+    {
+        retain = qMax(0, count);
+        return *this;
+    }
+
+    Q1Partition& Modulus(int count)
+    {
+        modulus = qMax(1, count);
+        return *this;
+    }
+
+    Q1Partition& Values(const QString& name, const QStringList& values)
+    {
+        lists.append(qMakePair(name, values));
+        return *this;
+    }
+
+    bool IsPartitioned() const
+    {
+        return type != NO_PARTITION && !column.isEmpty();
+    }
+
+    QString TypeName() const
+    {
+        switch (type)
+        {
+        case RANGE: return "RANGE";
+        case LIST:  return "LIST";
+        case HASH:  return "HASH";
+        default:    return QString();
+        }
+    }
+
+    // First day of the interval that contains date
+    QDate IntervalStart(const QDate& date) const
+    {
+        switch (interval)
+        {
+        case DAILY:   return date;
+        case WEEKLY:  return date.addDays(1 - date.dayOfWeek());
+        case YEARLY:  return QDate(date.year(), 1, 1);
+        case MONTHLY:
+        default:      return QDate(date.year(), date.month(), 1);
+        }
+    }
+
+    QDate NextStart(const QDate& start) const
+    {
+        switch (interval)
+        {
+        case DAILY:   return start.addDays(1);
+        case WEEKLY:  return start.addDays(7);
+        case YEARLY:  return start.addYears(1);
+        case MONTHLY:
+        default:      return start.addMonths(1);
+        }
+    }
+
+    // Lower bounds of the current partition and the Premake() ones after it
+    QList<QDate> UpcomingStarts(const QDate& today) const
+    {
+        QList<QDate> starts;
+        QDate start = IntervalStart(today);
+        for (int i = 0; i <= premake; ++i)
+        {
+            starts.append(start);
+            start = NextStart(start);
+        }
+        return starts;
+    }
+
+    // Rows below this bound are past retention; invalid when Retain() is 0
+    QDate RetentionCutoff(const QDate& today) const
+    {
+        if (retain == 0)
+            return QDate();
+
+        QDate cutoff = IntervalStart(today);
+        for (int i = 0; i < retain; ++i)
+        {
+            switch (interval)
+            {
+            case DAILY:   cutoff = cutoff.addDays(-1); break;
+            case WEEKLY:  cutoff = cutoff.addDays(-7); break;
+            case YEARLY:  cutoff = cutoff.addYears(-1); break;
+            case MONTHLY:
+            default:      cutoff = cutoff.addMonths(-1); break;
+            }
+        }
+        return cutoff;
+    }
+
+    static QString RangePartitionName(const QString& table, const QDate& start)
+    {
+        return table + "_p" + start.toString("yyyyMMdd");
+    }
+
+    // Lower bound encoded in a RangePartitionName(); invalid for other names
+    static QDate RangePartitionStart(const QString& table, const QString& partition_name)
+    {
+        const QString prefix = table + "_p";
+        if (!partition_name.startsWith(prefix, Qt::CaseInsensitive))
+            return QDate();
+
+        return QDate::fromString(partition_name.mid(prefix.size()), "yyyyMMdd");
+    }
+
+public:
+    Q1PartitionType type = NO_PARTITION;
+    QString column;
+    Q1PartitionInterval interval = MONTHLY;
+    int premake = 3;
+    int retain = 0;
+    int modulus = 4;
+    QList<QPair<QString, QStringList>> lists;   // LIST: partition suffix -> values
+};
+
+#endif // Q1PARTITION_H
@@ -4,7 +4,10 @@
 #include <QStringList>
 
 #include "../../Q1Core/Q1Entity/Q1Column.h"
+#include "../../Q1Core/Q1Entity/Q1Index.h"
+#include "../../Q1Core/Q1Entity/Q1Partition.h"
 #include "../../Q1Core/Q1Entity/Q1Relation.h"
+#include "../../Q1Core/Q1Entity/Q1View.h"
 
 #include "../../Q1ORM_global.h"
 
@@ -35,6 +38,35 @@ public:
         relations.append(relation);
     }
 
+    void AddIndex(const Q1Index& index)
+    {
+        for (const Q1Index& existing : indexes)
+        {
+            if (existing.GetName().compare(index.GetName(), Qt::CaseInsensitive) == 0)
+                return;
+        }
+
+        indexes.append(index);
+    }
+
+    // True when a declared index or the primary key starts with column
+    bool HasIndexOn(const QString& column) const
+    {
+        for (const Q1Index& index : indexes)
+        {
+            if (index.Leads(column))
+                return true;
+        }
+
+        for (const Q1Column& col : columns)
+        {
+            if (col.primary_key)
+                return col.name.compare(column, Qt::CaseInsensitive) == 0;
+        }
+
+        return false;
+    }
+
     Q1Column* FindColumn(const QString& name)
     {
         for(int i = 0; i < columns.size(); i++)
@@ -104,6 +136,26 @@ public:
         return relations;
     }
 
+    QList<Q1Index>& GetIndexes()
+    {
+        return indexes;
+    }
+
+    const QList<Q1Index>& GetIndexes() const
+    {
+        return indexes;
+    }
+
+    bool IsPartitioned() const
+    {
+        return partition.IsPartitioned();
+    }
+
+    bool IsView() const
+    {
+        return view.IsView();
+    }
+
     int ColumnCount() const
     {
         return columns.size();
@@ -118,12 +170,18 @@ public:
     {
         columns.clear();
         relations.clear();
+        indexes.clear();
+        partition = Q1Partition();
+        view = Q1View();
     }
 
 public:
     QString table_name;
     QList<Q1Column> columns;
     QList<Q1Relation> relations;
+    QList<Q1Index> indexes;
+    Q1Partition partition;
+    Q1View view;
 };
 
 #endif // Q1TABLE_H
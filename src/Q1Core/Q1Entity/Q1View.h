@@ -0,0 +1,61 @@
+#ifndef Q1VIEW_H
+#define Q1VIEW_H
+
+#include <QCryptographicHash>
+#include <QString>
+#include <QStringList>
+
+#include "../../Q1ORM_global.h"
+
+// Maps an entity onto a view instead of a table, declared with Q1Entity::ToView().
+// A materialized view stores the result of definition and is read like a table;
+// Q1ViewRefresher recomputes it on demand or every refresh_interval_ms.
+class Q1ORM_EXPORT Q1View
+{
+public:
+    Q1View() {}
+
+    Q1View(const QString& definition, const QStringList& unique_columns = QStringList())
+        : definition(definition), unique_columns(unique_columns)
+    {}
+
+    // 0 refreshes only on demand (Q1Context::RefreshView()). Timed refreshes are
+    // scheduled on Q1ViewRefresher's own thread; no event loop is required.
+    Q1View& RefreshEvery(int interval_ms)
+    {
+        refresh_interval_ms = qMax(0, interval_ms);
+        return *this;
+    }
+
+    Q1View& Materialized(bool materialized)
+    {
+        this->materialized = materialized;
+        return *this;
+    }
+
+    bool IsView() const
+    {
+        return !definition.isEmpty();
+    }
+
+    // Stored next to the view; a different value means the declaration changed
+    QString Fingerprint() const
+    {
+        const QString text = QString("%1|%2|%3").arg(definition.simplified(), unique_columns.join(','))
+                                 .arg(int(materialized));
+        return QString::fromLatin1(QCryptographicHash::hash(text.toUtf8(), QCryptographicHash::Sha256).toHex().left(16));
+    }
+
+    QString Marker() const
+    {
+        return "q1orm:" + Fingerprint();
+    }
+
+public:
+    QString definition;             // SELECT statement
+    QStringList unique_columns;     // unique index; PostgreSQL refreshes CONCURRENTLY only with one
+    bool materialized = true;
+    int refresh_interval_ms = 0;
+};
+
+#endif // Q1VIEW_H
@@ -1,6 +1,9 @@
 #include "Q1Migration.h"
+#include <QCryptographicHash>
+#include <QSet>
 #include <QSqlError>
 #include <QDebug>
+#include <QThread>
 
 Q1Migration::Q1Migration(Q1Connection &connection)
     : connection(connection)
@@ -9,12 +12,21 @@ Q1Migration::Q1Migration(Q1Connection &connection)
         translator = Q1MigrationQuery(DatabaseType::PostgreSQL);
     else if (connection.GetDriver() == Q1Driver::SQLSERVER)
         translator = Q1MigrationQuery(DatabaseType::SQLServer);
+    else if (connection.GetDriver() == Q1Driver::SQLITE)
+        translator = Q1MigrationQuery(DatabaseType::SQLite);
 }
 
 QStringList Q1Migration::GetDatabases()
 {
     QStringList databases;
 
+    // An SQLite database is its file, created on first open
+    if (connection.IsSqlite())
+    {
+        databases.append(connection.GetDatabaseName());
+        return databases;
+    }
+
     if (!connection.RootConnect())
     {
         m_lastError = "Cannot connect to server: " + connection.ErrorMessage();
@@ -76,33 +88,196 @@ QList<Q1Column> Q1Migration::GetColumns(QString table_name)
     else
     {
         while (sql.next())
+            columns.append(Q1SchemaSnapshot::ColumnFromRow(sql));
+    }
+
+    connection.Disconnect();
+    return columns;
+}
+
+bool Q1Migration::LoadSchemaSnapshot(Q1SchemaSnapshot &snapshot)
+{
+    snapshot.Clear();
+
+    if (!connection.Connect())
+    {
+        m_lastError = "Cannot connect: " + connection.ErrorMessage();
+        return false;
+    }
+
+    QSqlQuery sql(connection.database);
+    sql.setForwardOnly(true);
+
+    bool success = sql.exec(translator.SchemaColumnsSQL());
+    if (success)
+    {
+        snapshot.ReadColumns(sql);
+        success = sql.exec(translator.SchemaConstraintsSQL());
+    }
+
+    if (!success)
+    {
+        m_lastError = sql.lastError().text();
+        qWarning() << "LoadSchemaSnapshot failed:" << m_lastError;
+        snapshot.Clear();
+    }
+    else
+    {
+        snapshot.ReadConstraints(sql);
+        snapshot.SetLoaded(true);
+    }
+
+    connection.Disconnect();
+    return success;
+}
+
+QString Q1Migration::ModelFingerprint(const QList<Q1Table*> &tables, const QList<Q1Relation> &relations,
+                                     const QList<Q1Index> &indexes)
+{
+    QStringList table_lines;
+    for (const Q1Table* table : tables)
+    {
+        if (!table) continue;
+
+        QStringList parts;
+        parts << "table:" + table->GetName();
+        for (const Q1Column &column : table->GetColumns())
         {
-            Q1Column column;
-            column.name = sql.value("column_name").toString();
-            column.type = Q1Column::GetColumnType(sql.value("data_type").toString());
-            column.size = sql.value("character_maximum_length").toInt();
-            column.nullable = (sql.value("is_nullable").toString() == "YES");
-            const QVariant identityValue = sql.value("is_identity");
-            const QString identityText = identityValue.toString();
-            const bool isIdentity = identityValue.toBool() ||
-                                    identityValue.toInt() != 0 ||
-                                    identityText.compare("YES", Qt::CaseInsensitive) == 0 ||
-                                    identityText.compare("true", Qt::CaseInsensitive) == 0;
-            column.is_identity = isIdentity;
-            column.default_value = isIdentity
-                                       ? QStringLiteral("GENERATED ALWAYS AS IDENTITY")
-                                       : Q1Column::NormalizeDefaultValue(sql.value("column_default").toString());
-
-            columns.append(column);
+            parts << QString("column:%1|%2|%3|%4|%5|%6|%7")
+                         .arg(column.name)
+                         .arg(static_cast<int>(column.type))
+                         .arg(column.size)
+                         .arg(int(column.nullable))
+                         .arg(int(column.primary_key))
+                         .arg(int(column.is_identity))
+                         .arg(column.default_value);
         }
+        if (table->IsView())
+            parts << "view:" + table->view.Marker();
+
+        const Q1Partition &partition = table->partition;
+        if (partition.IsPartitioned())
+        {
+            QStringList lists;
+            for (const auto &list : partition.lists)
+                lists << list.first + "=" + list.second.join(',');
+
+            parts << QString("partition:%1|%2|%3|%4|%5|%6|%7")
+                         .arg(partition.TypeName(), partition.column)
+                         .arg(static_cast<int>(partition.interval))
+                         .arg(partition.premake)
+                         .arg(partition.retain)
+                         .arg(partition.modulus)
+                         .arg(lists.join(';'));
+        }
+        table_lines << parts.join('\n');
+    }
+    table_lines.sort();
+
+    // Relations come from OnTableRelationCreating() and from the tables themselves
+    QList<Q1Relation> all_relations = relations;
+    for (const Q1Table* table : tables)
+    {
+        if (table)
+            all_relations.append(table->GetRelations());
+    }
+
+    QStringList relation_lines;
+    for (const Q1Relation &relation : all_relations)
+    {
+        relation_lines << QString("relation:%1|%2|%3|%4|%5|%6|%7")
+                              .arg(relation.base_table, relation.top_table, relation.foreign_key, relation.reference_key)
+                              .arg(static_cast<int>(relation.type))
+                              .arg(static_cast<int>(relation.on_delete))
+                              .arg(static_cast<int>(relation.on_update));
     }
+    relation_lines.sort();
+    relation_lines.removeDuplicates();
+
+    QList<Q1Index> all_indexes = indexes;
+    for (const Q1Table* table : tables)
+    {
+        if (!table) continue;
+
+        for (Q1Index index : table->GetIndexes())
+        {
+            index.table = table->GetName();
+            all_indexes.append(index);
+        }
+    }
+
+    QStringList index_lines;
+    for (const Q1Index &index : all_indexes)
+    {
+        index_lines << QString("index:%1|%2|%3|%4|%5|%6")
+                           .arg(index.table, index.GetName(), index.columns.join(','),
+                                index.include_columns.join(','), index.where)
+                           .arg(int(index.unique));
+    }
+    index_lines.sort();
+    index_lines.removeDuplicates();
+
+    // Bump the prefix whenever Initialize() starts producing different DDL for the same model
+    const QByteArray model = ("q1orm-model-v2\n" + table_lines.join('\n') + '\n' + relation_lines.join('\n') +
+                              '\n' + index_lines.join('\n')).toUtf8();
+    return QString::fromLatin1(QCryptographicHash::hash(model, QCryptographicHash::Sha256).toHex());
+}
+
+QString Q1Migration::GetModelFingerprint()
+{
+    QString fingerprint;
+
+    if (!connection.Connect())
+    {
+        m_lastError = "Cannot connect: " + connection.ErrorMessage();
+        return fingerprint;
+    }
+
+    // Fails on the first start, before __q1orm_model exists; that only means "unknown"
+    QSqlQuery sql(connection.database);
+    if (sql.exec(translator.GetModelFingerprintSQL()) && sql.next())
+        fingerprint = sql.value(0).toString();
 
     connection.Disconnect();
-    return columns;
+    return fingerprint;
+}
+
+bool Q1Migration::SetModelFingerprint(const QString &fingerprint)
+{
+    if (!connection.Connect())
+    {
+        m_lastError = "Cannot connect: " + connection.ErrorMessage();
+        return false;
+    }
+
+    QSqlQuery sql(connection.database);
+    bool success = sql.exec(translator.CreateModelTableSQL());
+
+    if (success)
+    {
+        success = sql.prepare(translator.SetModelFingerprintSQL());
+        if (success)
+        {
+            sql.addBindValue(fingerprint);
+            success = sql.exec();
+        }
+    }
+
+    if (!success)
+    {
+        m_lastError = sql.lastError().text();
+        qWarning() << "SetModelFingerprint failed:" << m_lastError;
+    }
+
+    connection.Disconnect();
+    return success;
 }
 
 bool Q1Migration::AddDatabase(QString database_name)
 {
+    if (connection.IsSqlite())
+        return true;
+
     if (!connection.RootConnect())
     {
         m_lastError = "Cannot connect to server: " + connection.ErrorMessage();
@@ -238,7 +413,7 @@ bool Q1Migration::AddColumn(QString table_name, Q1Column &column)
     return true;
 }
 
-bool Q1Migration::AddRelation(const Q1Relation &relation)
+bool Q1Migration::AddRelation(const Q1Relation &relation, const Q1SchemaSnapshot *schema)
 {
     if (!relation.IsValid())
     {
@@ -255,7 +430,8 @@ bool Q1Migration::AddRelation(const Q1Relation &relation)
         }
     }
 
-    QStringList existingTables = connection.database.tables();
+    const bool useSchema = schema && schema->IsLoaded();
+    QStringList existingTables = useSchema ? schema->Tables() : connection.database.tables();
     for (QString &t : existingTables) t = t.toLower();
 
     if (!existingTables.contains(relation.base_table.toLower()) ||
@@ -266,13 +442,62 @@ bool Q1Migration::AddRelation(const Q1Relation &relation)
         return false;
     }
 
-    QString sql = translator.AddRelationSQL(relation);
-    if (sql.isEmpty())
+    const QList<Q1Statement> statements = translator.AddRelationStatements(relation);
+    if (statements.isEmpty())
     {
-        m_lastError = "No SQL generated for relation";
+        m_lastError = translator.lastError().isEmpty() ? "No SQL generated for relation" : translator.lastError();
         return false;
     }
 
+    return ExecuteStatements(statements, schema);
+}
+
+bool Q1Migration::ExecuteStatements(const QList<Q1Statement> &statements, const Q1SchemaSnapshot *schema)
+{
+    if (!connection.database.isOpen())
+    {
+        if (!connection.Connect())
+        {
+            m_lastError = connection.ErrorMessage();
+            return false;
+        }
+    }
+
+    const bool useSchema = schema && schema->IsLoaded();
+    QList<Q1Statement> pending;
+    QSet<QString> seen;
+
+    for (const Q1Statement &statement : statements)
+    {
+        const QString key = QString::number(statement.kind) + ":" + statement.target.toLower();
+        if (seen.contains(key))
+            continue;
+        seen.insert(key);
+
+        bool exists = false;
+        switch (statement.kind)
+        {
+        case Q1Statement::CREATE_TABLE:
+            exists = useSchema && schema->HasTable(statement.target);
+            break;
+        case Q1Statement::ADD_CONSTRAINT:
+            exists = useSchema ? schema->HasConstraint(statement.target)
+                               : ConstraintExists(connection.database, statement.target);
+            break;
+        }
+
+        if (exists)
+        {
+            qDebug() << "[Info] Skipping existing object:" << statement.target;
+            continue;
+        }
+
+        pending.append(statement);
+    }
+
+    if (pending.isEmpty())
+        return true;
+
     QSqlQuery q(connection.database);
 
     bool startedTx = connection.database.transaction();
@@ -287,35 +512,9 @@ bool Q1Migration::AddRelation(const Q1Relation &relation)
         startedTx = true;
     }
 
-    QStringList statements = sql.split(';', Qt::SkipEmptyParts);
-    QRegExp addConstraintRx("\\badd\\s+constraint\\s+((\"[^\"]+\")|([A-Za-z0-9_]+))", Qt::CaseInsensitive);
-    addConstraintRx.setMinimal(true);
-
-    for (QString stmt : statements)
+    for (const Q1Statement &statement : pending)
     {
-        stmt = stmt.trimmed();
-        if (stmt.isEmpty()) continue;
-
-        QString constraintName;
-        if (stmt.toLower().contains(" add constraint "))
-        {
-            int pos = addConstraintRx.indexIn(stmt);
-            if (pos != -1) constraintName = addConstraintRx.cap(1);
-
-            if (!constraintName.isEmpty())
-            {
-                if (constraintName.startsWith('"') && constraintName.endsWith('"') && constraintName.size() >= 2)
-                    constraintName = constraintName.mid(1, constraintName.size() - 2);
-
-                if (ConstraintExists(connection.database, constraintName))
-                {
-                    qDebug() << "[Info] Skipping existing constraint:" << constraintName;
-                    continue;
-                }
-            }
-        }
-
-        if (!q.exec(stmt))
+        if (!q.exec(statement.sql))
         {
             QString err = q.lastError().text();
             if (startedTx)
@@ -323,7 +522,7 @@ bool Q1Migration::AddRelation(const Q1Relation &relation)
                 connection.database.rollback();
             }
             m_lastError = err;
-            qWarning() << "[Error] Failed to execute relation SQL:" << err << "\nQuery:" << stmt;
+            qWarning() << "[Error] Failed to execute relation SQL:" << err << "\nQuery:" << statement.sql;
             return false;
         }
     }
@@ -332,7 +531,8 @@ bool Q1Migration::AddRelation(const Q1Relation &relation)
     {
         if (!connection.database.commit())
         {
-            qWarning() << "[Warning] Failed to commit relation transaction:" << connection.database.lastError().text();
+            m_lastError = connection.database.lastError().text();
+            qWarning() << "[Warning] Failed to commit relation transaction:" << m_lastError;
             connection.database.rollback();
             return false;
         }
@@ -363,6 +563,264 @@ bool Q1Migration::DropTable(QString table_name)
     return success;
 }
 
+bool Q1Migration::CreateIndex(const Q1Index &index)
+{
+    const QString query = translator.CreateIndexSQL(index);
+    if (query.isEmpty())
+    {
+        m_lastError = translator.lastError();
+        return false;
+    }
+
+    if (!connection.Connect())
+    {
+        m_lastError = "Cannot connect: " + connection.ErrorMessage();
+        return false;
+    }
+
+    QSqlQuery sql(connection.database);
+
+    // IF NOT EXISTS would accept the invalid leftover as the index
+    bool success = true;
+    if (translator.databaseType() == DatabaseType::PostgreSQL && index.concurrently)
+        success = sql.exec(translator.DropIndexSQL(index.table, index.GetName()));
+
+    if (success)
+        success = sql.exec(query);
+
+    if (!success)
+    {
+        m_lastError = sql.lastError().text();
+        qWarning() << "CreateIndex failed:" << m_lastError;
+    }
+
+    connection.Disconnect();
+    return success;
+}
+
+bool Q1Migration::DropIndex(const QString &table_name, const QString &index_name, bool concurrently)
+{
+    if (!connection.Connect())
+    {
+        m_lastError = "Cannot connect: " + connection.ErrorMessage();
+        return false;
+    }
+
+    QSqlQuery sql(connection.database);
+
+    bool success = sql.exec(translator.DropIndexSQL(table_name, index_name, concurrently));
+    if (!success)
+    {
+        m_lastError = sql.lastError().text();
+        qWarning() << "DropIndex failed:" << m_lastError;
+    }
+
+    connection.Disconnect();
+    return success;
+}
+
+bool Q1Migration::IndexExists(const QString &index_name)
+{
+    if (!connection.Connect())
+    {
+        m_lastError = "Cannot connect: " + connection.ErrorMessage();
+        return false;
+    }
+
+    QSqlQuery sql(connection.database);
+
+    bool exists = false;
+    if (sql.exec(translator.IndexExistsSQL(index_name)) && sql.next())
+        exists = sql.value(0).toInt() > 0;
+    else
+        m_lastError = sql.lastError().text();
+
+    connection.Disconnect();
+    return exists;
+}
+
+bool Q1Migration::CreateView(const Q1Table &view)
+{
+    const QStringList statements = translator.CreateViewSQL(view);
+    if (statements.isEmpty())
+    {
+        m_lastError = translator.lastError();
+        return false;
+    }
+
+    if (!connection.Connect())
+    {
+        m_lastError = "Cannot connect: " + connection.ErrorMessage();
+        return false;
+    }
+
+    // CREATE VIEW must start its own batch on SQL Server, so nothing is combined
+    QSqlQuery sql(connection.database);
+    bool success = true;
+    for (const QString &statement : statements)
+    {
+        qDebug() << "CreateView - executing:" << statement;
+
+        if (!sql.exec(statement))
+        {
+            m_lastError = sql.lastError().text();
+            qWarning() << "CreateView failed:" << m_lastError;
+            success = false;
+            break;
+        }
+    }
+
+    connection.Disconnect();
+    return success;
+}
+
+bool Q1Migration::DropView(const Q1Table &view)
+{
+    if (!connection.Connect())
+    {
+        m_lastError = "Cannot connect: " + connection.ErrorMessage();
+        return false;
+    }
+
+    QSqlQuery sql(connection.database);
+
+    bool success = sql.exec(translator.DropViewSQL(view));
+    if (!success)
+    {
+        m_lastError = sql.lastError().text();
+        qWarning() << "DropView failed:" << m_lastError;
+    }
+
+    connection.Disconnect();
+    return success;
+}
+
+bool Q1Migration::RefreshView(const Q1Table &view)
+{
+    const QString query = translator.RefreshViewSQL(view);
+    if (query.isEmpty())
+        return true;
+
+    if (!connection.Connect())
+    {
+        m_lastError = "Cannot connect: " + connection.ErrorMessage();
+        return false;
+    }
+
+    QSqlQuery sql(connection.database);
+
+    bool success = sql.exec(query);
+    if (!success)
+    {
+        m_lastError = sql.lastError().text();
+        qWarning() << "RefreshView failed:" << view.GetName() << "-" << m_lastError;
+    }
+
+    connection.Disconnect();
+    return success;
+}
+
+bool Q1Migration::IsViewCurrent(const Q1Table &view, bool *exists)
+{
+    if (exists)
+        *exists = false;
+
+    if (!connection.Connect())
+    {
+        m_lastError = "Cannot connect: " + connection.ErrorMessage();
+        return false;
+    }
+
+    QSqlQuery sql(connection.database);
+
+    bool current = false;
+    if (sql.exec(translator.ViewDefinitionSQL(view.GetName())))
+    {
+        if (sql.next())
+        {
+            if (exists)
+                *exists = true;
+            current = sql.value("definition").toString().contains(view.view.Marker());
+        }
+    }
+    else
+    {
+        m_lastError = sql.lastError().text();
+    }
+
+    connection.Disconnect();
+    return current;
+}
+
+bool Q1Migration::MaintainPartitions(const Q1Table &q1table, const QDate &today)
+{
+    if (!q1table.IsPartitioned())
+        return true;
+
+    if (q1table.partition.type == RANGE && translator.SupportsPartition(q1table.partition)
+        && !translator.CheckRangeColumn(q1table))
+    {
+        m_lastError = translator.lastError();
+        return false;
+    }
+
+    if (!connection.Connect())
+    {
+        m_lastError = "Cannot connect: " + connection.ErrorMessage();
+        return false;
+    }
+
+    QSqlQuery sql(connection.database);
+    bool success = true;
+
+    for (const QString &statement : translator.CreatePartitionsSQL(q1table, today))
+    {
+        if (!sql.exec(statement))
+        {
+            m_lastError = sql.lastError().text();
+            qWarning() << "MaintainPartitions - cannot create partition of" << q1table.GetName() << ":" << m_lastError;
+            success = false;
+            break;
+        }
+    }
+
+    QStringList existing;
+    const QString list = translator.PartitionListSQL(q1table.GetName());
+    if (success && q1table.partition.retain > 0 && !list.isEmpty())
+    {
+        if (sql.exec(list))
+        {
+            while (sql.next())
+                existing << sql.value("partition_name").toString();
+        }
+        else
+        {
+            m_lastError = sql.lastError().text();
+            success = false;
+        }
+    }
+
+    // Retention drops whole partitions instead of deleting rows
+    if (success)
+    {
+        for (const QString &statement : translator.DropExpiredPartitionsSQL(q1table, existing, today))
+        {
+            qDebug() << "MaintainPartitions - dropping expired partitions:" << statement;
+
+            if (!sql.exec(statement))
+            {
+                m_lastError = sql.lastError().text();
+                qWarning() << "MaintainPartitions - cannot drop partition of" << q1table.GetName() << ":" << m_lastError;
+                success = false;
+                break;
+            }
+        }
+    }
+
+    connection.Disconnect();
+    return success;
+}
+
 bool Q1Migration::DropColumn(QString table_name, QString column_name)
 {
     if (!connection.Connect())
@@ -394,6 +852,14 @@ bool Q1Migration::DropColumnNullable(QString table_name, QString column_name)
     }
 
     QString query = translator.DropColumnNullableSQL(table_name, column_name);
+    if (query.isEmpty())
+    {
+        m_lastError = translator.lastError();
+        qWarning() << "DropColumnNullable skipped:" << m_lastError;
+        connection.Disconnect();
+        return false;
+    }
+
     QSqlQuery sql(connection.database);
 
     bool success = sql.exec(query);
@@ -416,6 +882,14 @@ bool Q1Migration::DropColumnDefault(QString table_name, QString column_name)
     }
 
     QString query = translator.DropColumnDefaultSQL(table_name, column_name);
+    if (query.isEmpty())
+    {
+        m_lastError = translator.lastError();
+        qWarning() << "DropColumnDefault skipped:" << m_lastError;
+        connection.Disconnect();
+        return false;
+    }
+
     QSqlQuery sql(connection.database);
 
     bool success = sql.exec(query);
@@ -438,6 +912,14 @@ bool Q1Migration::SetColumnNullable(QString table_name, QString column_name)
     }
 
     QString query = translator.SetColumnNullableSQL(table_name, column_name);
+    if (query.isEmpty())
+    {
+        m_lastError = translator.lastError();
+        qWarning() << "SetColumnNullable skipped:" << m_lastError;
+        connection.Disconnect();
+        return false;
+    }
+
     QSqlQuery sql(connection.database);
 
     bool success = sql.exec(query);
@@ -460,6 +942,14 @@ bool Q1Migration::setColumnDefault(QString table_name, QString column_name, QStr
     }
 
     QString query = translator.SetColumnDefaultSQL(table_name, column_name, default_value);
+    if (query.isEmpty())
+    {
+        m_lastError = translator.lastError();
+        qWarning() << "setColumnDefault skipped:" << m_lastError;
+        connection.Disconnect();
+        return false;
+    }
+
     QSqlQuery sql(connection.database);
 
     bool success = sql.exec(query);
@@ -482,6 +972,14 @@ bool Q1Migration::UpdateColumnSize(QString table_name, QString column_name, int
     }
 
     QString query = translator.UpdateColumnSizeSQL(table_name, column_name, size);
+    if (query.isEmpty())
+    {
+        m_lastError = translator.lastError();
+        qWarning() << "UpdateColumnSize skipped:" << m_lastError;
+        connection.Disconnect();
+        return false;
+    }
+
     QSqlQuery sql(connection.database);
 
     bool success = sql.exec(query);
@@ -495,6 +993,144 @@ bool Q1Migration::UpdateColumnSize(QString table_name, QString column_name, int
     return success;
 }
 
+void Q1Migration::SetOnlineMigrations(bool online, int lock_timeout_ms, int batch_size)
+{
+    translator.SetOnline(online, lock_timeout_ms, batch_size);
+}
+
+Q1MigrationPlan Q1Migration::CreatePlan() const
+{
+    Q1MigrationPlan plan(translator.databaseType());
+    plan.SetOnline(translator.IsOnline(), translator.LockTimeoutMs(), translator.BatchSize());
+    return plan;
+}
+
+bool Q1Migration::ExecutePlan(const Q1MigrationPlan &plan)
+{
+    if (plan.IsEmpty())
+        return true;
+
+    if (plan.IsOnline())
+        return ExecuteOnlinePlan(plan);
+
+    if (!connection.Connect())
+    {
+        m_lastError = "Cannot connect: " + connection.ErrorMessage();
+        return false;
+    }
+
+    QSqlDatabase &db = connection.database;
+    const bool in_transaction = db.transaction();
+    if (!in_transaction)
+        qWarning() << "ExecutePlan - no transaction, steps are applied one by one:" << db.lastError().text();
+
+    QSqlQuery sql(db);
+    for (const Q1MigrationStep &step : plan.Steps())
+    {
+        qDebug() << "ExecutePlan -" << step.table << "-" << step.description << ":" << step.sql;
+
+        if (!sql.exec(step.sql))
+        {
+            m_lastError = QString("%1 (%2): %3").arg(step.table, step.description, sql.lastError().text());
+            qWarning() << "ExecutePlan failed:" << m_lastError;
+
+            if (in_transaction)
+                db.rollback();
+
+            connection.Disconnect();
+            return false;
+        }
+    }
+
+    if (in_transaction && !db.commit())
+    {
+        m_lastError = "Failed to commit: " + db.lastError().text();
+        qWarning() << m_lastError;
+        db.rollback();
+        connection.Disconnect();
+        return false;
+    }
+
+    connection.Disconnect();
+    return true;
+}
+
+bool Q1Migration::ExecuteOnlinePlan(const Q1MigrationPlan &plan)
+{
+    if (!connection.Connect())
+    {
+        m_lastError = "Cannot connect: " + connection.ErrorMessage();
+        return false;
+    }
+
+    QSqlDatabase &db = connection.database;
+    bool ok = true;
+
+    for (const Q1MigrationStep &step : plan.Steps())
+    {
+        qDebug() << "ExecutePlan (online) -" << step.table << "-" << step.description << ":" << step.sql;
+
+        int rows = 0;
+        do
+        {
+            ok = ExecuteOnlineStep(db, plan, step, rows);
+        } while (ok && step.repeat && rows > 0);
+
+        if (!ok)
+            break;
+    }
+
+    const QString reset = translator.ResetLockTimeoutSQL();
+    if (!reset.isEmpty())
+        QSqlQuery(db).exec(reset);
+
+    connection.Disconnect();
+    return ok;
+}
+
+bool Q1Migration::ExecuteOnlineStep(QSqlDatabase &db, const Q1MigrationPlan &plan, const Q1MigrationStep &step, int &rows)
+{
+    // A lock timeout means another transaction held the table; back off and retry
+    // rather than queueing behind it and blocking everything that arrives later
+    const int max_attempts = 3;
+    const QString lock_timeout = plan.LockTimeoutSQL();
+
+    for (int attempt = 1; attempt <= max_attempts; ++attempt)
+    {
+        const bool in_transaction = db.transaction();
+        QSqlQuery sql(db);
+
+        const bool ok = (lock_timeout.isEmpty() || sql.exec(lock_timeout)) && sql.exec(step.sql);
+        if (ok)
+        {
+            rows = sql.numRowsAffected();
+            if (!in_transaction || db.commit())
+                return true;
+
+            m_lastError = QString("%1 (%2): failed to commit: %3").arg(step.table, step.description, db.lastError().text());
+            db.rollback();
+            return false;
+        }
+
+        const QSqlError error = sql.lastError();
+        if (in_transaction)
+            db.rollback();
+
+        if (!translator.IsLockTimeout(error.nativeErrorCode()) || attempt == max_attempts)
+        {
+            m_lastError = QString("%1 (%2): %3").arg(step.table, step.description, error.text());
+            qWarning() << "ExecutePlan failed:" << m_lastError;
+            return false;
+        }
+
+        qWarning() << "ExecutePlan - lock timeout on" << step.table << "-" << step.description
+                   << ", retry" << attempt << "of" << max_attempts - 1;
+        QThread::msleep(500 * attempt);
+    }
+
+    return false;
+}
+
 bool Q1Migration::HasNullData(QString table_name, QString column_name)
 {
     if (!connection.Connect())
@@ -7,7 +7,9 @@
 #include "../../Q1Core/Q1Context/Q1Connection.h"
 #include "../../Q1Core/Q1Entity/Q1Column.h"
 #include "../../Q1Core/Q1Entity/Q1Table.h"
+#include "../../Q1Core/Q1Migration/Q1MigrationPlan.h"
 #include "../../Q1Core/Q1Migration/Q1MigrationQuery.h"
+#include "../../Q1Core/Q1Migration/Q1SchemaSnapshot.h"
 
 #include "../../Q1ORM_global.h"
 
@@ -19,12 +21,42 @@ public:
     QStringList GetDatabases();
     QList<Q1Column> GetColumns(QString table_name);
 
+    // Reads every table, column, constraint and index of the schema in two queries
+    bool LoadSchemaSnapshot(Q1SchemaSnapshot &snapshot);
+
+    // SHA-256 over every declared table, column, relation and index, order-independent
+    // for tables. indexes adds ones that are not declared on a table (foreign key indexes).
+    static QString ModelFingerprint(const QList<Q1Table*> &tables, const QList<Q1Relation> &relations,
+                                    const QList<Q1Index> &indexes = QList<Q1Index>());
+
+    // Fingerprint stored in __q1orm_model; empty if the table or its row does not exist
+    QString GetModelFingerprint();
+    bool SetModelFingerprint(const QString &fingerprint);
+
     bool AddDatabase(QString database_name);
     bool AddTable(Q1Table q1table);
     bool AddColumn(QString table_name, Q1Column &column);
-    bool AddRelation(const Q1Relation &relation);
+    // With a loaded schema the table and constraint checks read it instead of the catalog
+    bool AddRelation(const Q1Relation &relation, const Q1SchemaSnapshot *schema = nullptr);
     bool CreateTableWithColumns(Q1Table& q1table);
 
+    // Runs outside any transaction. On PostgreSQL an index of the same name is dropped
+    // first to clear the invalid leftover of an interrupted concurrent build, so call
+    // it for indexes IndexExists() does not report.
+    bool CreateIndex(const Q1Index &index);
+    bool DropIndex(const QString &table_name, const QString &index_name, bool concurrently = true);
+    bool IndexExists(const QString &index_name);
+
+    bool CreateView(const Q1Table &view);
+    bool DropView(const Q1Table &view);
+    bool RefreshView(const Q1Table &view);
+    // False when the view is missing or was created from another declaration
+    bool IsViewCurrent(const Q1Table &view, bool *exists = nullptr);
+
+    // Creates the current and premade partitions of a partitioned table and drops
+    // the ones past its retention. Idempotent; run it at least once per interval.
+    bool MaintainPartitions(const Q1Table &q1table, const QDate &today = QDate::currentDate());
+
     bool DropTable(QString table_name);
     bool DropColumn(QString table_name, QString column_name);
     bool DropColumnNullable(QString table_name, QString column_name);
@@ -37,6 +69,26 @@ public:
 
     bool HasNullData(QString table_name, QString column_name);
 
+    // Plans created afterwards render lock-aware DDL, see Q1MigrationQuery::SetOnline()
+    void SetOnlineMigrations(bool online, int lock_timeout_ms = 5000, int batch_size = 10000);
+    bool IsOnlineMigrations() const { return translator.IsOnline(); }
+
+    // Empty plan in this connection's dialect
+    Q1MigrationPlan CreatePlan() const;
+
+    // Runs every step on one connection inside one transaction; the first failing
+    // step rolls the whole plan back. Without transaction support the steps run
+    // one by one and stop at the first failure.
+    // An online plan runs each step in its own short transaction under the lock
+    // timeout instead, repeats backfill steps until they change no rows and retries
+    // a step that timed out waiting for its lock. A failure stops the plan but
+    // keeps the steps already committed.
+    bool ExecutePlan(const Q1MigrationPlan &plan);
+
+    // Runs statements in one transaction, skipping duplicates and objects that
+    // already exist (in schema when it is loaded, else constraints in the catalog)
+    bool ExecuteStatements(const QList<Q1Statement> &statements, const Q1SchemaSnapshot *schema = nullptr);
+
     bool ConstraintExists(QSqlDatabase &db, const QString &constraint_name);
 
     QStringList GetTables();
@@ -45,6 +97,9 @@ public:
     QString ErrorMessage() const { return m_lastError; }
 
 private:
+    bool ExecuteOnlinePlan(const Q1MigrationPlan &plan);
+    bool ExecuteOnlineStep(QSqlDatabase &db, const Q1MigrationPlan &plan, const Q1MigrationStep &step, int &rows);
+
     Q1Connection connection;
     Q1MigrationQuery translator;
     QString m_lastError;
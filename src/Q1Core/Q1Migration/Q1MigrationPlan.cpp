@@ -0,0 +1,187 @@
+#include "Q1MigrationPlan.h"
+
+Q1MigrationPlan::Q1MigrationPlan(DatabaseType type)
+    : translator(type)
+{
+}
+
+void Q1MigrationPlan::AddColumn(const QString &table_name, const Q1Column &column)
+{
+    if (!translator.NeedsBackfill(column))
+    {
+        Add(table_name, "add column " + column.name, translator.AddColumnSQL(table_name, column));
+        return;
+    }
+
+    // A volatile default would rewrite every row under the ADD COLUMN lock. Add the
+    // column empty, set the default for new rows, fill existing rows in batches and
+    // only then enforce NOT NULL.
+    Q1Column empty = column;
+    empty.nullable = true;
+    empty.default_value.clear();
+
+    Add(table_name, "add column " + column.name, translator.AddColumnSQL(table_name, empty));
+    SetColumnDefault(table_name, column.name, column.default_value);
+    Add(table_name, "backfill " + column.name, translator.BackfillSQL(table_name, column), true);
+
+    if (!column.nullable)
+        DropColumnNullable(table_name, column.name);
+}
+
+void Q1MigrationPlan::DropColumn(const QString &table_name, const QString &column_name)
+{
+    Add(table_name, "drop column " + column_name, translator.DropColumnSQL(table_name, column_name));
+}
+
+void Q1MigrationPlan::SetColumnNullable(const QString &table_name, const QString &column_name)
+{
+    Add(table_name, "make " + column_name + " nullable", translator.SetColumnNullableSQL(table_name, column_name));
+}
+
+void Q1MigrationPlan::DropColumnNullable(const QString &table_name, const QString &column_name)
+{
+    if (!translator.IsOnline())
+    {
+        Add(table_name, "make " + column_name + " NOT NULL", translator.DropColumnNullableSQL(table_name, column_name));
+        return;
+    }
+
+    const QStringList statements = translator.SetNotNullOnlineSQL(table_name, column_name);
+    if (statements.size() == 1)
+    {
+        Add(table_name, "make " + column_name + " NOT NULL", statements.first());
+        return;
+    }
+
+    const QStringList descriptions = {
+        "check " + column_name + " IS NOT NULL (not valid)",
+        "validate NOT NULL check of " + column_name,
+        "make " + column_name + " NOT NULL",
+        "drop NOT NULL check of " + column_name
+    };
+
+    for (int i = 0; i < statements.size(); ++i)
+        Add(table_name, descriptions.value(i, "make " + column_name + " NOT NULL"), statements.at(i));
+}
+
+void Q1MigrationPlan::SetColumnDefault(const QString &table_name, const QString &column_name, const QString &default_value)
+{
+    Add(table_name, "set default of " + column_name,
+        translator.SetColumnDefaultSQL(table_name, column_name, default_value));
+}
+
+void Q1MigrationPlan::DropColumnDefault(const QString &table_name, const QString &column_name)
+{
+    Add(table_name, "drop default of " + column_name, translator.DropColumnDefaultSQL(table_name, column_name));
+}
+
+void Q1MigrationPlan::UpdateColumnSize(const QString &table_name, const QString &column_name, int size)
+{
+    Add(table_name, QString("resize %1 to %2").arg(column_name).arg(size),
+        translator.UpdateColumnSizeSQL(table_name, column_name, size));
+}
+
+void Q1MigrationPlan::AddStatement(const QString &table_name, const QString &description, const QString &sql)
+{
+    Add(table_name, description, sql);
+}
+
+void Q1MigrationPlan::CreateTable(Q1Table q1table)
+{
+    Add(q1table.GetName(), "create table", translator.AddTableSQL(q1table));
+}
+
+void Q1MigrationPlan::AddRelation(const Q1Relation &relation)
+{
+    const QList<Q1Statement> statements = translator.AddRelationStatements(relation);
+    if (statements.isEmpty())
+    {
+        Add(relation.base_table, "add relation " + relation.GetConstraintName(), QString());
+        return;
+    }
+
+    for (const Q1Statement &statement : statements)
+    {
+        const QString description = statement.kind == Q1Statement::CREATE_TABLE ? "create table"
+                                                                                 : "add constraint " + statement.target;
+        Add(statement.table, description, statement.sql);
+    }
+}
+
+void Q1MigrationPlan::CreatePartitions(const Q1Table &q1table, const QDate &today)
+{
+    for (const QString &sql : translator.CreatePartitionsSQL(q1table, today))
+        Add(q1table.GetName(), "create partition", sql);
+}
+
+void Q1MigrationPlan::CreateIndex(const Q1Index &index)
+{
+    Add(index.table, "create index " + index.GetName(), translator.CreateIndexSQL(index));
+}
+
+void Q1MigrationPlan::DropIndex(const QString &table_name, const QString &index_name, bool concurrently)
+{
+    Add(table_name, "drop index " + index_name, translator.DropIndexSQL(table_name, index_name, concurrently));
+}
+
+void Q1MigrationPlan::Append(const Q1MigrationPlan &other)
+{
+    steps.append(other.steps);
+    skipped.append(other.skipped);
+}
+
+void Q1MigrationPlan::SetOnline(bool online, int lock_timeout_ms, int batch_size)
+{
+    translator.SetOnline(online, lock_timeout_ms, batch_size);
+}
+
+QString Q1MigrationPlan::ToSql() const
+{
+    QStringList lines;
+
+    for (const Q1MigrationStep &step : steps)
+    {
+        lines << QString("-- %1: %2%3").arg(step.table, step.description,
+                                            step.repeat ? " (repeat until no rows change)" : "");
+        lines << (step.sql.trimmed().endsWith(';') ? step.sql : step.sql + ";");
+    }
+
+    for (const QString &reason : skipped)
+        lines << "-- skipped: " + reason;
+
+    return lines.join('\n');
+}
+
+QList<Q1MigrationPlan> Q1MigrationPlan::SplitByTable() const
+{
+    QList<Q1MigrationPlan> plans;
+    QStringList tables;
+
+    for (const Q1MigrationStep &step : steps)
+    {
+        int index = tables.indexOf(step.table);
+        if (index < 0)
+        {
+            index = tables.size();
+            tables.append(step.table);
+            plans.append(Q1MigrationPlan(GetDatabaseType()));
+            plans.last().translator.SetOnline(translator.IsOnline(), translator.LockTimeoutMs(), translator.BatchSize());
+        }
+
+        plans[index].steps.append(step);
+    }
+
+    return plans;
+}
+
+void Q1MigrationPlan::Add(const QString &table_name, const QString &description, const QString &sql, bool repeat)
+{
+    if (sql.isEmpty())
+    {
+        const QString reason = translator.lastError().isEmpty() ? "no SQL generated" : translator.lastError();
+        skipped << QString("%1: %2 (%3)").arg(table_name, description, reason);
+        return;
+    }
+
+    steps.append({table_name, description, sql, repeat});
+}
@@ -0,0 +1,77 @@
+#ifndef Q1MIGRATIONPLAN_H
+#define Q1MIGRATIONPLAN_H
+
+#include <QDate>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "../../Q1Core/Q1Entity/Q1Column.h"
+#include "../../Q1Core/Q1Migration/Q1MigrationQuery.h"
+
+#include "../../Q1ORM_global.h"
+
+struct Q1MigrationStep
+{
+    QString table;
+    QString description;    // e.g. "add column name"
+    QString sql;
+    bool repeat = false;    // batched backfill: run again until it affects no rows
+};
+
+// Ordered list of schema changes rendered through Q1MigrationQuery. Nothing runs
+// until Q1Migration::ExecutePlan(), which applies all steps in one transaction.
+// Changes the dialect cannot express in place (SQLite ALTER COLUMN) are kept in
+// Skipped() instead of becoming steps. ToSql() renders the plan for review.
+// In online mode (SetOnline) steps avoid long table locks and the plan runs one
+// short transaction per step instead; see Q1MigrationQuery::SetOnline().
+class Q1ORM_EXPORT Q1MigrationPlan
+{
+public:
+    explicit Q1MigrationPlan(DatabaseType type = DatabaseType::PostgreSQL);
+
+    void AddColumn(const QString &table_name, const Q1Column &column);
+    void DropColumn(const QString &table_name, const QString &column_name);
+    void SetColumnNullable(const QString &table_name, const QString &column_name);
+    void DropColumnNullable(const QString &table_name, const QString &column_name);
+    void SetColumnDefault(const QString &table_name, const QString &column_name, const QString &default_value);
+    void DropColumnDefault(const QString &table_name, const QString &column_name);
+    void UpdateColumnSize(const QString &table_name, const QString &column_name, int size);
+
+    void AddStatement(const QString &table_name, const QString &description, const QString &sql);
+
+    // Whole objects, so a dry run lists everything Initialize() would create
+    void CreateTable(Q1Table q1table);
+    void AddRelation(const Q1Relation &relation);
+    void CreatePartitions(const Q1Table &q1table, const QDate &today);
+    void CreateIndex(const Q1Index &index);
+    void DropIndex(const QString &table_name, const QString &index_name, bool concurrently = true);
+
+    // Steps and skipped changes of other, after this plan's
+    void Append(const Q1MigrationPlan &other);
+
+    // Set before adding steps; only steps added afterwards are rendered online
+    void SetOnline(bool online, int lock_timeout_ms = 5000, int batch_size = 10000);
+    bool IsOnline() const { return translator.IsOnline(); }
+    QString LockTimeoutSQL() const { return translator.LockTimeoutSQL(); }
+
+    bool IsEmpty() const { return steps.isEmpty(); }
+    int Size() const { return steps.size(); }
+    const QList<Q1MigrationStep> &Steps() const { return steps; }
+    QStringList Skipped() const { return skipped; }
+    DatabaseType GetDatabaseType() const { return translator.databaseType(); }
+
+    QString ToSql() const;
+
+    // One plan per table, in first-step order; skipped changes stay with this plan
+    QList<Q1MigrationPlan> SplitByTable() const;
+
+private:
+    void Add(const QString &table_name, const QString &description, const QString &sql, bool repeat = false);
+
+    Q1MigrationQuery translator;
+    QList<Q1MigrationStep> steps;
+    QStringList skipped;
+};
+
+#endif // Q1MIGRATIONPLAN_H
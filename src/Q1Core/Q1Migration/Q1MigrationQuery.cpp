@@ -1,5 +1,6 @@
 #include "Q1MigrationQuery.h"
 
+#include <QRegularExpression>
 #include <QStringList>
 
 Q1MigrationQuery::Q1MigrationQuery(DatabaseType type)
@@ -13,9 +14,10 @@ QString Q1MigrationQuery::GetDatabasesSQL()
     {
     case DatabaseType::SQLServer:
         return "SELECT name FROM sys.databases ORDER BY name";
+    case DatabaseType::SQLite:
+        return "SELECT name FROM pragma_database_list";
     case DatabaseType::PostgreSQL:
     case DatabaseType::MySQL:
-    case DatabaseType::SQLite:
     default:
         return "SELECT datname FROM pg_database WHERE datistemplate = false";
     }
@@ -46,9 +48,23 @@ QString Q1MigrationQuery::GetColumnsSQL(QString table_name)
                    "WHERE c.TABLE_NAME = '%1' "
                    "ORDER BY c.ORDINAL_POSITION")
             .arg(EscapeSqlString(table_name));
+    case DatabaseType::SQLite:
+        // pragma_table_info keeps the declared type, e.g. VARCHAR(120); split it into type and size.
+        // A single INTEGER PRIMARY KEY is the rowid alias and generates its own values.
+        return QString(
+                   "SELECT c.name AS column_name, "
+                   "CASE WHEN instr(c.type, '(') > 0 THEN trim(substr(c.type, 1, instr(c.type, '(') - 1)) ELSE c.type END AS data_type, "
+                   "CASE WHEN instr(c.type, '(') > 0 THEN CAST(substr(c.type, instr(c.type, '(') + 1) AS INTEGER) END AS character_maximum_length, "
+                   "CASE WHEN c.\"notnull\" = 0 AND c.pk = 0 THEN 'YES' ELSE 'NO' END AS is_nullable, "
+                   "c.dflt_value AS column_default, "
+                   "CASE WHEN c.pk = 1 AND upper(c.type) = 'INTEGER' "
+                   " AND (SELECT COUNT(*) FROM pragma_table_info('%1') WHERE pk > 0) = 1 THEN 1 ELSE 0 END AS is_identity, "
+                   "c.cid + 1 AS ordinal_position, "
+                   "CASE WHEN c.pk > 0 THEN 'pk_%1' END AS constraint_name "
+                   "FROM pragma_table_info('%1') c ORDER BY c.cid")
+            .arg(EscapeSqlString(table_name));
     case DatabaseType::PostgreSQL:
     case DatabaseType::MySQL:
-    case DatabaseType::SQLite:
     default:
         return QString(
                    "SELECT column_name, data_type, character_maximum_length, is_nullable, column_default, is_identity, ordinal_position, "
@@ -68,9 +84,14 @@ QString Q1MigrationQuery::ConstraintExistsSQL(const QString &constraint_name)
                    "SELECT COUNT(*) FROM INFORMATION_SCHEMA.TABLE_CONSTRAINTS "
                    "WHERE LOWER(CONSTRAINT_NAME) = LOWER('%1')")
             .arg(EscapeSqlString(constraint_name));
+    case DatabaseType::SQLite:
+        // Constraints only exist inside the CREATE TABLE text
+        return QString(
+                   "SELECT COUNT(*) FROM sqlite_master "
+                   "WHERE type = 'table' AND instr(LOWER(sql), LOWER('\"%1\"')) > 0")
+            .arg(EscapeSqlString(constraint_name));
     case DatabaseType::PostgreSQL:
     case DatabaseType::MySQL:
-    case DatabaseType::SQLite:
     default:
         return QString(
                    "SELECT COUNT(*) FROM information_schema.table_constraints "
@@ -79,6 +100,167 @@ QString Q1MigrationQuery::ConstraintExistsSQL(const QString &constraint_name)
     }
 }
 
+QString Q1MigrationQuery::SchemaColumnsSQL()
+{
+    switch (db_type)
+    {
+    case DatabaseType::SQLServer:
+        // sys.columns stores nvarchar/nchar lengths in bytes
+        return QString(
+            "SELECT t.name AS table_name, c.name AS column_name, ty.name AS data_type, "
+            "CASE WHEN ty.name IN ('nvarchar', 'nchar') THEN CASE WHEN c.max_length = -1 THEN -1 ELSE c.max_length / 2 END "
+            "     WHEN ty.name IN ('varchar', 'char', 'varbinary', 'binary') THEN c.max_length END AS character_maximum_length, "
+            "CASE WHEN c.is_nullable = 1 THEN 'YES' ELSE 'NO' END AS is_nullable, "
+            "dc.definition AS column_default, "
+            "CAST(c.is_identity AS INT) AS is_identity, "
+            "c.column_id AS ordinal_position "
+            "FROM sys.tables t "
+            "JOIN sys.columns c ON c.object_id = t.object_id "
+            "JOIN sys.types ty ON ty.user_type_id = c.user_type_id "
+            "LEFT JOIN sys.default_constraints dc ON dc.object_id = c.default_object_id "
+            "WHERE t.schema_id = SCHEMA_ID() "
+            "ORDER BY t.name, c.column_id");
+    case DatabaseType::SQLite:
+        return QString(
+            "SELECT m.name AS table_name, c.name AS column_name, "
+            "CASE WHEN instr(c.type, '(') > 0 THEN trim(substr(c.type, 1, instr(c.type, '(') - 1)) ELSE c.type END AS data_type, "
+            "CASE WHEN instr(c.type, '(') > 0 THEN CAST(substr(c.type, instr(c.type, '(') + 1) AS INTEGER) END AS character_maximum_length, "
+            "CASE WHEN c.\"notnull\" = 0 AND c.pk = 0 THEN 'YES' ELSE 'NO' END AS is_nullable, "
+            "c.dflt_value AS column_default, "
+            "CASE WHEN c.pk = 1 AND upper(c.type) = 'INTEGER' "
+            " AND (SELECT COUNT(*) FROM pragma_table_info(m.name) WHERE pk > 0) = 1 THEN 1 ELSE 0 END AS is_identity, "
+            "c.cid + 1 AS ordinal_position "
+            "FROM sqlite_master m JOIN pragma_table_info(m.name) c "
+            "WHERE m.type = 'table' AND m.name NOT LIKE 'sqlite_%' "
+            "ORDER BY m.name, c.cid");
+    case DatabaseType::PostgreSQL:
+    case DatabaseType::MySQL:
+    default:
+        // format_type() without a modifier gives the information_schema type names
+        return QString(
+            "SELECT c.relname AS table_name, a.attname AS column_name, "
+            "format_type(a.atttypid, NULL) AS data_type, "
+            "CASE WHEN a.atttypid IN (1042, 1043) AND a.atttypmod > 0 THEN a.atttypmod - 4 END AS character_maximum_length, "
+            "CASE WHEN a.attnotnull THEN 'NO' ELSE 'YES' END AS is_nullable, "
+            "pg_get_expr(d.adbin, d.adrelid) AS column_default, "
+            "CASE WHEN a.attidentity <> '' THEN 1 ELSE 0 END AS is_identity, "
+            "a.attnum AS ordinal_position "
+            "FROM pg_catalog.pg_class c "
+            "JOIN pg_catalog.pg_namespace n ON n.oid = c.relnamespace "
+            "JOIN pg_catalog.pg_attribute a ON a.attrelid = c.oid "
+            "LEFT JOIN pg_catalog.pg_attrdef d ON d.adrelid = a.attrelid AND d.adnum = a.attnum "
+            "WHERE n.nspname = current_schema() AND c.relkind IN ('r', 'p') "
+            "AND a.attnum > 0 AND NOT a.attisdropped "
+            "ORDER BY c.relname, a.attnum");
+    }
+}
+
+QString Q1MigrationQuery::SchemaConstraintsSQL()
+{
+    switch (db_type)
+    {
+    case DatabaseType::SQLServer:
+        return QString(
+            "SELECT o.name AS constraint_name, OBJECT_NAME(o.parent_object_id) AS table_name, "
+            "CAST(NULL AS NVARCHAR(MAX)) AS definition, 'constraint' AS kind "
+            "FROM sys.objects o "
+            "WHERE o.type IN ('PK', 'F', 'UQ', 'C') AND o.schema_id = SCHEMA_ID() "
+            "UNION ALL "
+            "SELECT i.name, t.name, NULL, 'index' "
+            "FROM sys.indexes i JOIN sys.tables t ON t.object_id = i.object_id "
+            "WHERE i.name IS NOT NULL AND t.schema_id = SCHEMA_ID()");
+    case DatabaseType::SQLite:
+        // Constraint names only exist inside the CREATE TABLE text; the snapshot searches it
+        return QString(
+            "SELECT NULL AS constraint_name, name AS table_name, sql AS definition, 'constraint' AS kind "
+            "FROM sqlite_master WHERE type = 'table' AND name NOT LIKE 'sqlite_%' "
+            "UNION ALL "
+            "SELECT name, tbl_name, NULL, 'index' FROM sqlite_master WHERE type = 'index'");
+    case DatabaseType::PostgreSQL:
+    case DatabaseType::MySQL:
+    default:
+        return QString(
+            "SELECT con.conname AS constraint_name, rel.relname AS table_name, NULL AS definition, 'constraint' AS kind "
+            "FROM pg_catalog.pg_constraint con "
+            "JOIN pg_catalog.pg_class rel ON rel.oid = con.conrelid "
+            "JOIN pg_catalog.pg_namespace n ON n.oid = rel.relnamespace "
+            "WHERE n.nspname = current_schema() "
+            "UNION ALL "
+            "SELECT ic.relname, rel.relname, NULL, 'index' "
+            "FROM pg_catalog.pg_index i "
+            "JOIN pg_catalog.pg_class ic ON ic.oid = i.indexrelid "
+            "JOIN pg_catalog.pg_class rel ON rel.oid = i.indrelid "
+            "JOIN pg_catalog.pg_namespace n ON n.oid = rel.relnamespace "
+            "WHERE n.nspname = current_schema() AND i.indisvalid");
+    }
+}
+
+QString Q1MigrationQuery::IndexExistsSQL(const QString &index_name)
+{
+    switch (db_type)
+    {
+    case DatabaseType::SQLServer:
+        return QString("SELECT COUNT(*) FROM sys.indexes WHERE name = N'%1'").arg(EscapeSqlString(index_name));
+    case DatabaseType::SQLite:
+        return QString("SELECT COUNT(*) FROM sqlite_master WHERE type = 'index' AND lower(name) = lower('%1')")
+            .arg(EscapeSqlString(index_name));
+    case DatabaseType::PostgreSQL:
+    case DatabaseType::MySQL:
+    default:
+        // An interrupted CREATE INDEX CONCURRENTLY leaves an invalid index behind; it does not count
+        return QString("SELECT COUNT(*) FROM pg_catalog.pg_index i "
+                       "JOIN pg_catalog.pg_class c ON c.oid = i.indexrelid "
+                       "JOIN pg_catalog.pg_namespace n ON n.oid = c.relnamespace "
+                       "WHERE n.nspname = current_schema() AND lower(c.relname) = lower('%1') AND i.indisvalid")
+            .arg(EscapeSqlString(index_name));
+    }
+}
+
+QString Q1MigrationQuery::CreateModelTableSQL()
+{
+    switch (db_type)
+    {
+    case DatabaseType::SQLServer:
+        return QString("IF OBJECT_ID(N'__q1orm_model', N'U') IS NULL "
+                       "CREATE TABLE %1 ([id] INT PRIMARY KEY, [fingerprint] NVARCHAR(64) NOT NULL, "
+                       "[updated_at] DATETIME2 NOT NULL DEFAULT SYSUTCDATETIME())")
+            .arg(QuoteIdentifier("__q1orm_model"));
+    case DatabaseType::SQLite:
+    case DatabaseType::PostgreSQL:
+    case DatabaseType::MySQL:
+    default:
+        return QString("CREATE TABLE IF NOT EXISTS %1 (\"id\" INTEGER PRIMARY KEY, \"fingerprint\" VARCHAR(64) NOT NULL, "
+                       "\"updated_at\" TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP)")
+            .arg(QuoteIdentifier("__q1orm_model"));
+    }
+}
+
+QString Q1MigrationQuery::GetModelFingerprintSQL()
+{
+    return QString("SELECT %1 FROM %2 WHERE %3 = 1")
+        .arg(QuoteIdentifier("fingerprint"), QuoteIdentifier("__q1orm_model"), QuoteIdentifier("id"));
+}
+
+QString Q1MigrationQuery::SetModelFingerprintSQL()
+{
+    switch (db_type)
+    {
+    case DatabaseType::SQLServer:
+        return QString("MERGE %1 AS t USING (SELECT 1 AS id, ? AS fingerprint) AS s ON t.[id] = s.id "
+                       "WHEN MATCHED THEN UPDATE SET [fingerprint] = s.fingerprint, [updated_at] = SYSUTCDATETIME() "
+                       "WHEN NOT MATCHED THEN INSERT ([id], [fingerprint]) VALUES (s.id, s.fingerprint);")
+            .arg(QuoteIdentifier("__q1orm_model"));
+    case DatabaseType::SQLite:
+    case DatabaseType::PostgreSQL:
+    case DatabaseType::MySQL:
+    default:
+        return QString("INSERT INTO %1 (\"id\", \"fingerprint\") VALUES (1, ?) "
+                       "ON CONFLICT (\"id\") DO UPDATE SET \"fingerprint\" = excluded.\"fingerprint\", "
+                       "\"updated_at\" = CURRENT_TIMESTAMP")
+            .arg(QuoteIdentifier("__q1orm_model"));
+    }
+}
+
 QString Q1MigrationQuery::AddDatabaseSQL(QString database_name)
 {
     switch (db_type)
@@ -86,9 +268,11 @@ QString Q1MigrationQuery::AddDatabaseSQL(QString database_name)
     case DatabaseType::SQLServer:
         return QString("IF DB_ID(N'%1') IS NULL CREATE DATABASE %2")
             .arg(EscapeSqlString(database_name), QuoteIdentifier(database_name));
+    case DatabaseType::SQLite:
+        m_lastError = "SQLite creates the database file when it is opened";
+        return "";
     case DatabaseType::PostgreSQL:
     case DatabaseType::MySQL:
-    case DatabaseType::SQLite:
     default:
         return QString("CREATE DATABASE \"%1\" WITH ENCODING='UTF8' CONNECTION LIMIT=-1").arg(database_name);
     }
@@ -102,27 +286,81 @@ QString Q1MigrationQuery::AddTableSQL(Q1Table &q1table)
         return "";
     }
 
+    const Q1Partition &partition = q1table.partition;
+    const bool partitioned = q1table.IsPartitioned() && SupportsPartition(partition);
+    if (q1table.IsPartitioned() && !partitioned)
+        qWarning() << "AddTableSQL:" << partition.TypeName() << "partitioning is not supported here, creating"
+                   << q1table.table_name << "as a plain table";
+
+    const Q1Column *partition_column = partitioned ? q1table.FindColumn(partition.column) : nullptr;
+    if (partitioned && !partition_column)
+    {
+        m_lastError = "Partition column not found: " + partition.column;
+        return "";
+    }
+    if (partitioned && partition.type == RANGE && !CheckRangeColumn(q1table))
+        return "";
+
+    // The primary key of a partitioned table must contain the partition column,
+    // so it moves from the column definition to a table constraint
     QStringList column_defs;
+    QStringList key_columns;
     for (const Q1Column &column : q1table.columns)
     {
-        const QString column_definition = ColumnProperty(column);
+        QString column_definition = ColumnProperty(column);
+        if (partitioned && column.primary_key)
+        {
+            column_definition.remove(" PRIMARY KEY");
+            key_columns << QuoteIdentifier(column.name);
+        }
+
         if (!column_definition.isEmpty())
             column_defs.append(column_definition);
     }
 
+    if (partitioned && !key_columns.isEmpty())
+    {
+        if (!key_columns.contains(QuoteIdentifier(partition_column->name)))
+            key_columns << QuoteIdentifier(partition_column->name);
+        column_defs << QString("PRIMARY KEY (%1)").arg(key_columns.join(", "));
+    }
+
     switch (db_type)
     {
     case DatabaseType::SQLServer:
+        if (partitioned)
+        {
+            const QString function = PartitionFunctionName(q1table.table_name);
+            const QString scheme = PartitionSchemeName(q1table.table_name);
+            const QString first = partition.IntervalStart(QDate::currentDate()).toString(Qt::ISODate);
+
+            return QString("IF NOT EXISTS (SELECT 1 FROM sys.partition_functions WHERE name = N'%1') "
+                           "CREATE PARTITION FUNCTION %2 (%3) AS RANGE RIGHT FOR VALUES ('%4'); "
+                           "IF NOT EXISTS (SELECT 1 FROM sys.partition_schemes WHERE name = N'%5') "
+                           "CREATE PARTITION SCHEME %6 AS PARTITION %2 ALL TO ([PRIMARY]); "
+                           "IF OBJECT_ID(N'%7', N'U') IS NULL CREATE TABLE %8 (%9) ON %6(%10)")
+                .arg(EscapeSqlString(function), QuoteIdentifier(function), ColumnTypeSql(*partition_column), first,
+                     EscapeSqlString(scheme), QuoteIdentifier(scheme),
+                     EscapeSqlString(q1table.table_name), QuoteIdentifier(q1table.table_name))
+                .arg(column_defs.join(", "), QuoteIdentifier(partition_column->name));
+        }
+
         return QString("IF OBJECT_ID(N'%1', N'U') IS NULL CREATE TABLE %2 (%3)")
             .arg(EscapeSqlString(q1table.table_name),
                  QuoteIdentifier(q1table.table_name),
                  column_defs.join(", "));
+    case DatabaseType::SQLite:
+        // ALTER TABLE cannot add constraints later, so foreign keys are declared here
+        column_defs.append(InlineForeignKeys(q1table));
+        return QString("CREATE TABLE IF NOT EXISTS %1 (%2)")
+            .arg(QuoteIdentifier(q1table.table_name), column_defs.join(", "));
     case DatabaseType::PostgreSQL:
     case DatabaseType::MySQL:
-    case DatabaseType::SQLite:
     default:
-        return QString("CREATE TABLE IF NOT EXISTS \"%1\" (%2)")
-            .arg(q1table.table_name, column_defs.join(", "));
+        return QString("CREATE TABLE IF NOT EXISTS \"%1\" (%2)%3")
+            .arg(q1table.table_name, column_defs.join(", "),
+                 partitioned ? QString(" PARTITION BY %1 (%2)").arg(partition.TypeName(), QuoteIdentifier(partition.column))
+                             : QString());
     }
 }
 
@@ -141,12 +379,14 @@ QString Q1MigrationQuery::AddColumnSQL(QString table_name, const Q1Column &colum
     }
 }
 
-QString Q1MigrationQuery::AddRelationSQL(const Q1Relation &relation)
+QList<Q1Statement> Q1MigrationQuery::AddRelationStatements(const Q1Relation &relation)
 {
+    QList<Q1Statement> statements;
+
     if (!relation.IsValid())
     {
         m_lastError = "Invalid relation";
-        return "";
+        return statements;
     }
 
     const QString fkName = relation.GetConstraintName();
@@ -155,27 +395,16 @@ QString Q1MigrationQuery::AddRelationSQL(const Q1Relation &relation)
     QString fkColumn;
     QString fkRefCol;
 
-    switch (relation.type)
-    {
-    case ONE_TO_ONE:
-        fkBase = relation.base_table;
-        fkTop = relation.top_table;
-        fkColumn = relation.foreign_key;
-        fkRefCol = relation.reference_key;
-        break;
-    case ONE_TO_MANY:
-        fkBase = relation.top_table;
-        fkTop = relation.base_table;
-        fkColumn = relation.foreign_key;
-        fkRefCol = relation.reference_key;
-        break;
-    case MANY_TO_ONE:
-        fkBase = relation.base_table;
-        fkTop = relation.top_table;
-        fkColumn = relation.foreign_key;
-        fkRefCol = relation.reference_key;
-        break;
-    case MANY_TO_MANY:
+    auto add = [&statements](Q1Statement::Kind kind, const QString &table, const QString &target, const QString &sql) {
+        Q1Statement statement;
+        statement.kind = kind;
+        statement.table = table;
+        statement.target = target;
+        statement.sql = sql;
+        statements.append(statement);
+    };
+
+    if (!ForeignKeyColumns(relation, fkBase, fkTop, fkColumn, fkRefCol))
     {
         const QString junction = relation.base_table + "_" + relation.top_table;
         const QString base_col = relation.base_table + "_" + relation.foreign_key;
@@ -183,81 +412,92 @@ QString Q1MigrationQuery::AddRelationSQL(const Q1Relation &relation)
 
         if (db_type == DatabaseType::SQLServer)
         {
-            return QString(
-                       "IF OBJECT_ID(N'%1', N'U') IS NULL "
-                       "CREATE TABLE %2 ("
-                       "%3 INT NOT NULL, "
-                       "%4 INT NOT NULL, "
-                       "CONSTRAINT %5 PRIMARY KEY (%3, %4), "
-                       "CONSTRAINT %6 FOREIGN KEY (%3) REFERENCES %7(%8) ON DELETE CASCADE, "
-                       "CONSTRAINT %9 FOREIGN KEY (%4) REFERENCES %10(%11) ON DELETE CASCADE)")
-                .arg(EscapeSqlString(junction),
-                     QuoteIdentifier(junction),
-                     QuoteIdentifier(base_col),
-                     QuoteIdentifier(top_col),
-                     QuoteIdentifier(QString("PK_%1").arg(junction)),
-                     QuoteIdentifier(QString("fk_%1_%2").arg(junction, base_col)),
-                     QuoteIdentifier(relation.base_table),
-                     QuoteIdentifier(relation.foreign_key),
-                     QuoteIdentifier(QString("fk_%1_%2").arg(junction, top_col)),
-                     QuoteIdentifier(relation.top_table),
-                     QuoteIdentifier(relation.reference_key));
+            add(Q1Statement::CREATE_TABLE, junction, junction,
+                QString(
+                    "IF OBJECT_ID(N'%1', N'U') IS NULL "
+                    "CREATE TABLE %2 ("
+                    "%3 INT NOT NULL, "
+                    "%4 INT NOT NULL, "
+                    "CONSTRAINT %5 PRIMARY KEY (%3, %4), "
+                    "CONSTRAINT %6 FOREIGN KEY (%3) REFERENCES %7(%8) ON DELETE CASCADE, "
+                    "CONSTRAINT %9 FOREIGN KEY (%4) REFERENCES %10(%11) ON DELETE CASCADE)")
+                    .arg(EscapeSqlString(junction),
+                         QuoteIdentifier(junction),
+                         QuoteIdentifier(base_col),
+                         QuoteIdentifier(top_col),
+                         QuoteIdentifier(QString("PK_%1").arg(junction)),
+                         QuoteIdentifier(QString("fk_%1_%2").arg(junction, base_col)),
+                         QuoteIdentifier(relation.base_table),
+                         QuoteIdentifier(relation.foreign_key),
+                         QuoteIdentifier(QString("fk_%1_%2").arg(junction, top_col)),
+                         QuoteIdentifier(relation.top_table),
+                         QuoteIdentifier(relation.reference_key)));
+            return statements;
         }
 
-        return QString(
-                   "CREATE TABLE IF NOT EXISTS \"%1\" ("
-                   "\"%2\" INTEGER NOT NULL, "
-                   "\"%3\" INTEGER NOT NULL, "
-                   "PRIMARY KEY (\"%2\", \"%3\"), "
-                   "CONSTRAINT fk_%1_%2 FOREIGN KEY (\"%2\") REFERENCES \"%4\"(\"%5\") ON DELETE CASCADE, "
-                   "CONSTRAINT fk_%1_%3 FOREIGN KEY (\"%3\") REFERENCES \"%6\"(\"%7\") ON DELETE CASCADE)")
-            .arg(junction, base_col, top_col, relation.base_table, relation.foreign_key,
-                 relation.top_table, relation.reference_key);
+        add(Q1Statement::CREATE_TABLE, junction, junction,
+            QString(
+                "CREATE TABLE IF NOT EXISTS \"%1\" ("
+                "\"%2\" INTEGER NOT NULL, "
+                "\"%3\" INTEGER NOT NULL, "
+                "PRIMARY KEY (\"%2\", \"%3\"), "
+                "CONSTRAINT fk_%1_%2 FOREIGN KEY (\"%2\") REFERENCES \"%4\"(\"%5\") ON DELETE CASCADE, "
+                "CONSTRAINT fk_%1_%3 FOREIGN KEY (\"%3\") REFERENCES \"%6\"(\"%7\") ON DELETE CASCADE)")
+                .arg(junction, base_col, top_col, relation.base_table, relation.foreign_key,
+                     relation.top_table, relation.reference_key));
+        return statements;
     }
+
+    if (db_type == DatabaseType::SQLite)
+    {
+        m_lastError = "SQLite declares foreign keys in CREATE TABLE; recreate the table to add " + fkName;
+        return statements;
     }
 
+    const QString uqName = QString("uq_%1_%2").arg(fkBase, fkColumn).toLower();
+
     if (db_type == DatabaseType::SQLServer)
     {
         const QString baseTable = QuoteIdentifier(fkBase);
-        const QString topTable = QuoteIdentifier(fkTop);
         const QString foreignKey = QuoteIdentifier(fkColumn);
-        const QString referenceKey = QuoteIdentifier(fkRefCol);
-        const QString quotedConstraint = QuoteIdentifier(fkName);
 
         if (relation.type == ONE_TO_ONE)
         {
-            const QString uqName = QuoteIdentifier(QString("uq_%1_%2").arg(fkBase, fkColumn).toLower());
-            const QString uqSql = QString("ALTER TABLE %1 ADD CONSTRAINT %2 UNIQUE (%3)")
-                                      .arg(baseTable, uqName, foreignKey);
-            const QString fkSql = QString("ALTER TABLE %1 ADD CONSTRAINT %2 FOREIGN KEY (%3) "
-                                          "REFERENCES %4(%5) ON DELETE %6 ON UPDATE %7")
-                                      .arg(baseTable, quotedConstraint, foreignKey, topTable, referenceKey,
-                                           relation.GetOnDeleteString(), relation.GetOnUpdateString());
-            return uqSql + "; " + fkSql;
+            add(Q1Statement::ADD_CONSTRAINT, fkBase, uqName,
+                QString("ALTER TABLE %1 ADD CONSTRAINT %2 UNIQUE (%3)")
+                    .arg(baseTable, QuoteIdentifier(uqName), foreignKey));
         }
 
-        return QString("ALTER TABLE %1 ADD CONSTRAINT %2 FOREIGN KEY (%3) "
-                       "REFERENCES %4(%5) ON DELETE %6 ON UPDATE %7")
-            .arg(baseTable, quotedConstraint, foreignKey, topTable, referenceKey,
-                 relation.GetOnDeleteString(), relation.GetOnUpdateString());
+        add(Q1Statement::ADD_CONSTRAINT, fkBase, fkName,
+            QString("ALTER TABLE %1 ADD CONSTRAINT %2 FOREIGN KEY (%3) "
+                    "REFERENCES %4(%5) ON DELETE %6 ON UPDATE %7")
+                .arg(baseTable, QuoteIdentifier(fkName), foreignKey, QuoteIdentifier(fkTop),
+                     QuoteIdentifier(fkRefCol), relation.GetOnDeleteString(), relation.GetOnUpdateString()));
+        return statements;
     }
 
     if (relation.type == ONE_TO_ONE)
     {
-        const QString uqName = QString("uq_%1_%2").arg(fkBase, fkColumn).toLower();
-        const QString uqSql = QString("ALTER TABLE \"%1\" ADD CONSTRAINT \"%2\" UNIQUE (\"%3\")")
-                                  .arg(fkBase, uqName, fkColumn);
-        const QString fkSql = QString("ALTER TABLE \"%1\" ADD CONSTRAINT \"%2\" FOREIGN KEY (\"%3\") "
-                                      "REFERENCES \"%4\"(\"%5\") ON DELETE %6 ON UPDATE %7")
-                                  .arg(fkBase, fkName, fkColumn, fkTop, fkRefCol,
-                                       relation.GetOnDeleteString(), relation.GetOnUpdateString());
-        return uqSql + "; " + fkSql;
+        add(Q1Statement::ADD_CONSTRAINT, fkBase, uqName,
+            QString("ALTER TABLE \"%1\" ADD CONSTRAINT \"%2\" UNIQUE (\"%3\")")
+                .arg(fkBase, uqName, fkColumn));
     }
 
-    return QString("ALTER TABLE \"%1\" ADD CONSTRAINT \"%2\" FOREIGN KEY (\"%3\") "
-                   "REFERENCES \"%4\"(\"%5\") ON DELETE %6 ON UPDATE %7")
-        .arg(fkBase, fkName, fkColumn, fkTop, fkRefCol,
-             relation.GetOnDeleteString(), relation.GetOnUpdateString());
+    add(Q1Statement::ADD_CONSTRAINT, fkBase, fkName,
+        QString("ALTER TABLE \"%1\" ADD CONSTRAINT \"%2\" FOREIGN KEY (\"%3\") "
+                "REFERENCES \"%4\"(\"%5\") ON DELETE %6 ON UPDATE %7")
+            .arg(fkBase, fkName, fkColumn, fkTop, fkRefCol,
+                 relation.GetOnDeleteString(), relation.GetOnUpdateString()));
+    return statements;
+}
+
+QString Q1MigrationQuery::AddRelationSQL(const Q1Relation &relation)
+{
+    QStringList sql;
+    for (const Q1Statement &statement : AddRelationStatements(relation))
+        sql << statement.sql;
+
+    return sql.join("; ");
 }
 
 QString Q1MigrationQuery::DropTableSQL(QString table_name)
@@ -267,9 +507,10 @@ QString Q1MigrationQuery::DropTableSQL(QString table_name)
     case DatabaseType::SQLServer:
         return QString("IF OBJECT_ID(N'%1', N'U') IS NOT NULL DROP TABLE %2")
             .arg(EscapeSqlString(table_name), QuoteIdentifier(table_name));
+    case DatabaseType::SQLite:
+        return QString("DROP TABLE IF EXISTS %1").arg(QuoteIdentifier(table_name));
     case DatabaseType::PostgreSQL:
     case DatabaseType::MySQL:
-    case DatabaseType::SQLite:
     default:
         return QString("DROP TABLE IF EXISTS \"%1\" CASCADE").arg(table_name);
     }
@@ -288,9 +529,11 @@ QString Q1MigrationQuery::DropColumnSQL(QString table_name, QString column_name)
                  EscapeSqlString(column_name),
                  QuoteIdentifier(table_name),
                  QuoteIdentifier(column_name));
+    case DatabaseType::SQLite:
+        return QString("ALTER TABLE %1 DROP COLUMN %2")
+            .arg(QuoteIdentifier(table_name), QuoteIdentifier(column_name));
     case DatabaseType::PostgreSQL:
     case DatabaseType::MySQL:
-    case DatabaseType::SQLite:
     default:
         return QString("ALTER TABLE \"%1\" DROP COLUMN IF EXISTS \"%2\" CASCADE").arg(table_name, column_name);
     }
@@ -301,6 +544,9 @@ QString Q1MigrationQuery::DropColumnNullableSQL(QString table_name, QString colu
     if (db_type == DatabaseType::SQLServer)
         return AlterColumnNullabilitySQL(table_name, column_name, false);
 
+    if (db_type == DatabaseType::SQLite)
+        return UnsupportedAlterColumn(table_name, column_name);
+
     return QString("ALTER TABLE \"%1\" ALTER COLUMN \"%2\" SET NOT NULL").arg(table_name, column_name);
 }
 
@@ -309,6 +555,9 @@ QString Q1MigrationQuery::DropColumnDefaultSQL(QString table_name, QString colum
     if (db_type == DatabaseType::SQLServer)
         return DropDefaultConstraintSQL(table_name, column_name);
 
+    if (db_type == DatabaseType::SQLite)
+        return UnsupportedAlterColumn(table_name, column_name);
+
     return QString("ALTER TABLE \"%1\" ALTER COLUMN \"%2\" DROP DEFAULT").arg(table_name, column_name);
 }
 
@@ -317,11 +566,17 @@ QString Q1MigrationQuery::SetColumnNullableSQL(QString table_name, QString colum
     if (db_type == DatabaseType::SQLServer)
         return AlterColumnNullabilitySQL(table_name, column_name, true);
 
+    if (db_type == DatabaseType::SQLite)
+        return UnsupportedAlterColumn(table_name, column_name);
+
     return QString("ALTER TABLE \"%1\" ALTER COLUMN \"%2\" DROP NOT NULL").arg(table_name, column_name);
 }
 
 QString Q1MigrationQuery::SetColumnDefaultSQL(QString table_name, QString column_name, QString default_value)
 {
+    if (db_type == DatabaseType::SQLite)
+        return UnsupportedAlterColumn(table_name, column_name);
+
     if (db_type == DatabaseType::SQLServer)
     {
         return QString("%1; ALTER TABLE %2 ADD CONSTRAINT %3 DEFAULT %4 FOR %5")
@@ -337,18 +592,24 @@ QString Q1MigrationQuery::SetColumnDefaultSQL(QString table_name, QString column
 
 QString Q1MigrationQuery::UpdateColumnSizeSQL(QString table_name, QString column_name, int size)
 {
+    if (db_type == DatabaseType::SQLite)
+        return UnsupportedAlterColumn(table_name, column_name);
+
     if (db_type == DatabaseType::SQLServer)
     {
         return QString(
                    "DECLARE @is_nullable NVARCHAR(8) = N'NULL'; "
                    "IF EXISTS (SELECT 1 FROM sys.columns WHERE object_id = OBJECT_ID(N'%1') AND name = N'%2' AND is_nullable = 0) "
                    "SET @is_nullable = N'NOT NULL'; "
-                   "EXEC(N'ALTER TABLE %3 ALTER COLUMN %4 NVARCHAR(%5) ' + @is_nullable);")
+                   "%6"
+                   "EXEC(N'ALTER TABLE %3 ALTER COLUMN %4 NVARCHAR(%5) ' + @is_nullable%7);")
             .arg(EscapeSqlString(table_name),
                  EscapeSqlString(column_name),
                  QuoteIdentifier(table_name),
                  QuoteIdentifier(column_name),
-                 QString::number(size));
+                 QString::number(size),
+                 OnlineAlterClauseSQL(),
+                 online ? " + @online" : "");
     }
 
     return QString("ALTER TABLE \"%1\" ALTER COLUMN \"%2\" TYPE VARCHAR(%3)").arg(table_name, column_name).arg(size);
@@ -369,6 +630,494 @@ QString Q1MigrationQuery::HasNullDataSQL(QString table_name, QString column_name
     }
 }
 
+QString Q1MigrationQuery::CreateIndexSQL(const Q1Index &index)
+{
+    if (!index.IsValid())
+    {
+        m_lastError = "Invalid index";
+        return "";
+    }
+
+    QStringList keys;
+    for (const QString &column : index.columns)
+        keys << QuoteIdentifier(column);
+
+    QStringList included;
+    for (const QString &column : index.include_columns)
+        included << QuoteIdentifier(column);
+
+    const QString name = QuoteIdentifier(index.GetName());
+    const QString table = QuoteIdentifier(index.table);
+    const QString unique = index.unique ? "UNIQUE " : "";
+    const QString where = index.where.isEmpty() ? QString() : " WHERE " + index.where;
+
+    switch (db_type)
+    {
+    case DatabaseType::SQLServer:
+    {
+        const QString create = QString("CREATE %1NONCLUSTERED INDEX %2 ON %3 (%4)%5%6")
+                                   .arg(unique, name, table, keys.join(", "),
+                                        included.isEmpty() ? QString() : " INCLUDE (" + included.join(", ") + ")",
+                                        where);
+        const QString missing = QString("IF NOT EXISTS (SELECT 1 FROM sys.indexes WHERE name = N'%1' AND object_id = OBJECT_ID(N'%2')) ")
+                                    .arg(EscapeSqlString(index.GetName()), EscapeSqlString(index.table));
+
+        if (!online)
+            return missing + create;
+
+        return OnlineAlterClauseSQL() + missing +
+               QString("EXEC(N'%1' + @online)").arg(EscapeSqlString(create));
+    }
+    case DatabaseType::SQLite:
+        // SQLite has no covering indexes; the include columns are left out
+        return QString("CREATE %1INDEX IF NOT EXISTS %2 ON %3 (%4)%5")
+            .arg(unique, name, table, keys.join(", "), where);
+    case DatabaseType::PostgreSQL:
+    case DatabaseType::MySQL:
+    default:
+        // CONCURRENTLY takes SHARE UPDATE EXCLUSIVE: writes to the table continue during the build
+        return QString("CREATE %1INDEX %2IF NOT EXISTS %3 ON %4 (%5)%6%7")
+            .arg(unique, index.concurrently ? "CONCURRENTLY " : "", name, table, keys.join(", "),
+                 included.isEmpty() ? QString() : " INCLUDE (" + included.join(", ") + ")",
+                 where);
+    }
+}
+
+QString Q1MigrationQuery::DropIndexSQL(const QString &table_name, const QString &index_name, bool concurrently)
+{
+    switch (db_type)
+    {
+    case DatabaseType::SQLServer:
+        return QString("IF EXISTS (SELECT 1 FROM sys.indexes WHERE name = N'%1' AND object_id = OBJECT_ID(N'%2')) "
+                       "DROP INDEX %3 ON %4")
+            .arg(EscapeSqlString(index_name), EscapeSqlString(table_name),
+                 QuoteIdentifier(index_name), QuoteIdentifier(table_name));
+    case DatabaseType::SQLite:
+        return QString("DROP INDEX IF EXISTS %1").arg(QuoteIdentifier(index_name));
+    case DatabaseType::PostgreSQL:
+    case DatabaseType::MySQL:
+    default:
+        return QString("DROP INDEX %1IF EXISTS %2").arg(concurrently ? "CONCURRENTLY " : "", QuoteIdentifier(index_name));
+    }
+}
+
+Q1Index Q1MigrationQuery::ForeignKeyIndex(const Q1Relation &relation) const
+{
+    if (!relation.IsValid() || relation.type == ONE_TO_ONE)
+        return Q1Index();
+
+    QString fkBase, fkTop, fkColumn, fkRefCol;
+    Q1Index index;
+
+    if (ForeignKeyColumns(relation, fkBase, fkTop, fkColumn, fkRefCol))
+    {
+        index = Q1Index(fkBase, {fkColumn});
+    }
+    else
+    {
+        // The junction's primary key starts with the base column; the top column needs its own
+        const QString junction = relation.base_table + "_" + relation.top_table;
+        index = Q1Index(junction, {relation.top_table + "_" + relation.reference_key});
+    }
+
+    index.automatic = true;
+    return index;
+}
+
+bool Q1MigrationQuery::SupportsPartition(const Q1Partition &partition) const
+{
+    switch (db_type)
+    {
+    case DatabaseType::PostgreSQL:
+        return partition.IsPartitioned();
+    case DatabaseType::SQLServer:
+        return partition.IsPartitioned() && partition.type == RANGE;
+    case DatabaseType::SQLite:
+    case DatabaseType::MySQL:
+    default:
+        return false;
+    }
+}
+
+bool Q1MigrationQuery::CheckRangeColumn(const Q1Table &q1table)
+{
+    const Q1Column *column = q1table.FindColumn(q1table.partition.column);
+    if (!column)
+    {
+        m_lastError = "Partition column not found: " + q1table.partition.column;
+        return false;
+    }
+    if (column->type != DATE && column->type != TIMESTAMP)
+    {
+        m_lastError = "RANGE partition column must be DATE or TIMESTAMP: " + column->name;
+        return false;
+    }
+    return true;
+}
+
+QStringList Q1MigrationQuery::CreatePartitionsSQL(const Q1Table &q1table, const QDate &today)
+{
+    const Q1Partition &partition = q1table.partition;
+    if (!q1table.IsPartitioned() || !SupportsPartition(partition))
+        return {};
+    if (partition.type == RANGE && !CheckRangeColumn(q1table))
+        return {};
+
+    const QString table = q1table.table_name;
+    QStringList statements;
+
+    if (db_type == DatabaseType::SQLServer)
+    {
+        // Future boundaries split an empty partition off the last one, which moves no rows
+        const QString function = PartitionFunctionName(table);
+        for (const QDate &start : partition.UpcomingStarts(today))
+        {
+            const QString bound = start.toString(Qt::ISODate);
+            statements << QString("IF NOT EXISTS (SELECT 1 FROM sys.partition_range_values v "
+                                  "JOIN sys.partition_functions f ON f.function_id = v.function_id "
+                                  "WHERE f.name = N'%1' AND CAST(v.value AS DATE) = '%2') "
+                                  "BEGIN ALTER PARTITION SCHEME %3 NEXT USED [PRIMARY]; "
+                                  "ALTER PARTITION FUNCTION %4() SPLIT RANGE ('%2'); END")
+                              .arg(EscapeSqlString(function), bound,
+                                   QuoteIdentifier(PartitionSchemeName(table)), QuoteIdentifier(function));
+        }
+        return statements;
+    }
+
+    switch (partition.type)
+    {
+    case RANGE:
+        for (const QDate &start : partition.UpcomingStarts(today))
+        {
+            statements << QString("CREATE TABLE IF NOT EXISTS %1 PARTITION OF %2 FOR VALUES FROM ('%3') TO ('%4')")
+                              .arg(QuoteIdentifier(Q1Partition::RangePartitionName(table, start)),
+                                   QuoteIdentifier(table),
+                                   start.toString(Qt::ISODate),
+                                   partition.NextStart(start).toString(Qt::ISODate));
+        }
+        // Rows outside the premade intervals (back-dated or too far ahead) land here
+        // instead of failing the INSERT; its name never parses as an expired interval
+        statements << QString("CREATE TABLE IF NOT EXISTS %1 PARTITION OF %2 DEFAULT")
+                          .arg(QuoteIdentifier(table + "_default"), QuoteIdentifier(table));
+        break;
+    case LIST:
+        for (const auto &list : partition.lists)
+        {
+            QStringList values;
+            for (const QString &value : list.second)
+                values << QuoteLiteral(value);
+
+            statements << QString("CREATE TABLE IF NOT EXISTS %1 PARTITION OF %2 FOR VALUES IN (%3)")
+                              .arg(QuoteIdentifier(table + "_" + list.first), QuoteIdentifier(table), values.join(", "));
+        }
+        statements << QString("CREATE TABLE IF NOT EXISTS %1 PARTITION OF %2 DEFAULT")
+                          .arg(QuoteIdentifier(table + "_default"), QuoteIdentifier(table));
+        break;
+    case HASH:
+        for (int i = 0; i < partition.modulus; ++i)
+        {
+            statements << QString("CREATE TABLE IF NOT EXISTS %1 PARTITION OF %2 FOR VALUES WITH (MODULUS %3, REMAINDER %4)")
+                              .arg(QuoteIdentifier(QString("%1_h%2").arg(table).arg(i)), QuoteIdentifier(table))
+                              .arg(partition.modulus)
+                              .arg(i);
+        }
+        break;
+    default:
+        break;
+    }
+
+    return statements;
+}
+
+QString Q1MigrationQuery::PartitionListSQL(const QString &table_name)
+{
+    if (db_type != DatabaseType::PostgreSQL)
+        return QString();
+
+    return QString("SELECT c.relname AS partition_name FROM pg_catalog.pg_inherits i "
+                   "JOIN pg_catalog.pg_class c ON c.oid = i.inhrelid "
+                   "JOIN pg_catalog.pg_class p ON p.oid = i.inhparent "
+                   "JOIN pg_catalog.pg_namespace n ON n.oid = p.relnamespace "
+                   "WHERE n.nspname = current_schema() AND p.relname = '%1' "
+                   "ORDER BY c.relname")
+        .arg(EscapeSqlString(table_name));
+}
+
+QStringList Q1MigrationQuery::DropExpiredPartitionsSQL(const Q1Table &q1table, const QStringList &existing, const QDate &today)
+{
+    const Q1Partition &partition = q1table.partition;
+    const QDate cutoff = partition.RetentionCutoff(today);
+    if (!q1table.IsPartitioned() || partition.type != RANGE || !cutoff.isValid() || !SupportsPartition(partition))
+        return {};
+    if (!CheckRangeColumn(q1table))
+        return {};
+
+    const QString table = q1table.table_name;
+
+    if (db_type == DatabaseType::SQLServer)
+    {
+        // RANGE RIGHT: partitions 1 .. $PARTITION(cutoff) - 1 hold only rows below the cutoff.
+        // Truncating them is metadata-only; merging their boundaries removes them.
+        const QString function = PartitionFunctionName(table);
+        return {QString("DECLARE @cutoff DATE = '%1'; "
+                        "DECLARE @last INT = $PARTITION.%2(@cutoff) - 1; "
+                        "IF @last >= 1 EXEC(N'TRUNCATE TABLE %3 WITH (PARTITIONS (1 TO ' + CAST(@last AS NVARCHAR(10)) + N'))'); "
+                        "DECLARE @boundary SQL_VARIANT; "
+                        "WHILE 1 = 1 BEGIN "
+                        "SET @boundary = NULL; "
+                        "SELECT TOP (1) @boundary = v.value FROM sys.partition_range_values v "
+                        "JOIN sys.partition_functions f ON f.function_id = v.function_id "
+                        "WHERE f.name = N'%4' AND CAST(v.value AS DATE) < @cutoff ORDER BY v.boundary_id; "
+                        "IF @boundary IS NULL BREAK; "
+                        "ALTER PARTITION FUNCTION %2() MERGE RANGE (@boundary); "
+                        "END")
+                    .arg(cutoff.toString(Qt::ISODate), QuoteIdentifier(function),
+                         EscapeSqlString(QuoteIdentifier(table)), EscapeSqlString(function))};
+    }
+
+    QStringList statements;
+    for (const QString &name : existing)
+    {
+        const QDate start = Q1Partition::RangePartitionStart(table, name);
+        if (start.isValid() && start < cutoff)
+            statements << QString("DROP TABLE IF EXISTS %1").arg(QuoteIdentifier(name));
+    }
+
+    return statements;
+}
+
+QStringList Q1MigrationQuery::CreateViewSQL(const Q1Table &view)
+{
+    if (!view.IsView())
+    {
+        m_lastError = "Not a view: " + view.table_name;
+        return {};
+    }
+
+    const Q1View &declared = view.view;
+    const QString name = QuoteIdentifier(view.table_name);
+    const Q1Index unique_index(view.table_name, declared.unique_columns, true);
+
+    QStringList keys;
+    for (const QString &column : declared.unique_columns)
+        keys << QuoteIdentifier(column);
+
+    QStringList statements;
+
+    switch (db_type)
+    {
+    case DatabaseType::SQLServer:
+        if (!declared.materialized)
+        {
+            statements << QString("CREATE VIEW %1 AS /* %2 */ %3").arg(name, declared.Marker(), declared.definition);
+            break;
+        }
+
+        // An indexed view is materialized by its unique clustered index and kept
+        // current on every write; the definition must use two-part table names
+        statements << QString("CREATE VIEW %1 WITH SCHEMABINDING AS /* %2 */ %3")
+                          .arg(name, declared.Marker(), declared.definition);
+        if (keys.isEmpty())
+            qWarning() << "CreateViewSQL:" << view.table_name << "has no unique columns and stays a plain view";
+        else
+            statements << QString("CREATE UNIQUE CLUSTERED INDEX %1 ON %2 (%3)")
+                              .arg(QuoteIdentifier(unique_index.GetName()), name, keys.join(", "));
+        break;
+    case DatabaseType::SQLite:
+        statements << QString("CREATE VIEW IF NOT EXISTS %1 AS /* %2 */ %3").arg(name, declared.Marker(), declared.definition);
+        break;
+    case DatabaseType::PostgreSQL:
+    case DatabaseType::MySQL:
+    default:
+        if (!declared.materialized)
+        {
+            statements << QString("CREATE OR REPLACE VIEW %1 AS %2").arg(name, declared.definition);
+            statements << QString("COMMENT ON VIEW %1 IS %2").arg(name, QuoteLiteral(declared.Marker()));
+            break;
+        }
+
+        statements << QString("CREATE MATERIALIZED VIEW IF NOT EXISTS %1 AS %2 WITH DATA").arg(name, declared.definition);
+        statements << QString("COMMENT ON MATERIALIZED VIEW %1 IS %2").arg(name, QuoteLiteral(declared.Marker()));
+        if (!keys.isEmpty())
+            statements << QString("CREATE UNIQUE INDEX IF NOT EXISTS %1 ON %2 (%3)")
+                              .arg(QuoteIdentifier(unique_index.GetName()), name, keys.join(", "));
+        break;
+    }
+
+    return statements;
+}
+
+QString Q1MigrationQuery::DropViewSQL(const Q1Table &view)
+{
+    switch (db_type)
+    {
+    case DatabaseType::SQLServer:
+        return QString("IF OBJECT_ID(N'%1', N'V') IS NOT NULL DROP VIEW %2")
+            .arg(EscapeSqlString(view.table_name), QuoteIdentifier(view.table_name));
+    case DatabaseType::SQLite:
+        return QString("DROP VIEW IF EXISTS %1").arg(QuoteIdentifier(view.table_name));
+    case DatabaseType::PostgreSQL:
+    case DatabaseType::MySQL:
+    default:
+    {
+        // The existing view may be of the other kind than the declaration
+        const QString name = QuoteIdentifier(view.table_name).replace('\'', "''");
+        return QString("DO $$ BEGIN "
+                       "IF EXISTS (SELECT 1 FROM pg_catalog.pg_matviews WHERE schemaname = current_schema() AND matviewname = '%1') "
+                       "THEN EXECUTE 'DROP MATERIALIZED VIEW %2'; "
+                       "ELSE EXECUTE 'DROP VIEW IF EXISTS %2'; END IF; END $$")
+            .arg(EscapeSqlString(view.table_name), name);
+    }
+    }
+}
+
+QString Q1MigrationQuery::RefreshViewSQL(const Q1Table &view)
+{
+    if (db_type != DatabaseType::PostgreSQL || !view.view.materialized)
+        return QString();
+
+    // CONCURRENTLY keeps the view readable during the refresh but needs a unique index
+    return QString("REFRESH MATERIALIZED VIEW %1%2")
+        .arg(view.view.unique_columns.isEmpty() ? "" : "CONCURRENTLY ", QuoteIdentifier(view.table_name));
+}
+
+QString Q1MigrationQuery::ViewDefinitionSQL(const QString &view_name)
+{
+    switch (db_type)
+    {
+    case DatabaseType::SQLServer:
+        return QString("SELECT OBJECT_DEFINITION(OBJECT_ID(N'%1', N'V')) AS definition "
+                       "WHERE OBJECT_ID(N'%1', N'V') IS NOT NULL")
+            .arg(EscapeSqlString(view_name));
+    case DatabaseType::SQLite:
+        return QString("SELECT sql AS definition FROM sqlite_master WHERE type = 'view' AND name = '%1'")
+            .arg(EscapeSqlString(view_name));
+    case DatabaseType::PostgreSQL:
+    case DatabaseType::MySQL:
+    default:
+        return QString("SELECT obj_description(c.oid, 'pg_class') AS definition FROM pg_catalog.pg_class c "
+                       "JOIN pg_catalog.pg_namespace n ON n.oid = c.relnamespace "
+                       "WHERE n.nspname = current_schema() AND c.relname = '%1' AND c.relkind IN ('v', 'm')")
+            .arg(EscapeSqlString(view_name));
+    }
+}
+
+void Q1MigrationQuery::SetOnline(bool online, int lock_timeout_ms, int batch_size)
+{
+    this->online = online;
+    this->lock_timeout_ms = qMax(1, lock_timeout_ms);
+    this->batch_size = qMax(1, batch_size);
+}
+
+QString Q1MigrationQuery::LockTimeoutSQL() const
+{
+    switch (db_type)
+    {
+    case DatabaseType::SQLServer:
+        return QString("SET LOCK_TIMEOUT %1").arg(lock_timeout_ms);
+    case DatabaseType::SQLite:
+        return QString();
+    case DatabaseType::PostgreSQL:
+    case DatabaseType::MySQL:
+    default:
+        // SET LOCAL ends with the step's transaction
+        return QString("SET LOCAL lock_timeout = '%1ms'").arg(lock_timeout_ms);
+    }
+}
+
+QString Q1MigrationQuery::ResetLockTimeoutSQL() const
+{
+    // SET LOCK_TIMEOUT lasts for the session, SET LOCAL only for the transaction
+    if (db_type == DatabaseType::SQLServer)
+        return "SET LOCK_TIMEOUT -1";
+
+    return QString();
+}
+
+bool Q1MigrationQuery::IsLockTimeout(const QString &native_error_code) const
+{
+    switch (db_type)
+    {
+    case DatabaseType::SQLServer:
+        return native_error_code == "1222";
+    case DatabaseType::SQLite:
+        return native_error_code == "5" || native_error_code == "6";    // SQLITE_BUSY, SQLITE_LOCKED
+    case DatabaseType::PostgreSQL:
+    case DatabaseType::MySQL:
+    default:
+        return native_error_code == "55P03";    // lock_not_available
+    }
+}
+
+QStringList Q1MigrationQuery::SetNotNullOnlineSQL(const QString &table_name, const QString &column_name)
+{
+    if (db_type != DatabaseType::PostgreSQL)
+        return {DropColumnNullableSQL(table_name, column_name)};
+
+    // SET NOT NULL scans the table under ACCESS EXCLUSIVE. A NOT VALID check is added
+    // instantly, VALIDATE scans under SHARE UPDATE EXCLUSIVE (reads and writes continue),
+    // and PostgreSQL 12+ then sets NOT NULL from the validated check without a scan.
+    const QString table = QuoteIdentifier(table_name);
+    const QString column = QuoteIdentifier(column_name);
+    const QString check = QuoteIdentifier(QString("ck_%1_%2_not_null").arg(table_name, column_name));
+
+    return {
+        QString("ALTER TABLE %1 ADD CONSTRAINT %2 CHECK (%3 IS NOT NULL) NOT VALID").arg(table, check, column),
+        QString("ALTER TABLE %1 VALIDATE CONSTRAINT %2").arg(table, check),
+        QString("ALTER TABLE %1 ALTER COLUMN %2 SET NOT NULL").arg(table, column),
+        QString("ALTER TABLE %1 DROP CONSTRAINT %2").arg(table, check)
+    };
+}
+
+QString Q1MigrationQuery::BackfillSQL(const QString &table_name, const Q1Column &column) const
+{
+    const QString table = QuoteIdentifier(table_name);
+    const QString name = QuoteIdentifier(column.name);
+    const QString value = NormalizeDefaultValue(column);
+
+    switch (db_type)
+    {
+    case DatabaseType::SQLServer:
+        return QString("UPDATE TOP (%1) %2 SET %3 = %4 WHERE %3 IS NULL")
+            .arg(QString::number(batch_size), table, name, value);
+    case DatabaseType::SQLite:
+        return QString("UPDATE %1 SET %2 = %3 WHERE rowid IN (SELECT rowid FROM %1 WHERE %2 IS NULL LIMIT %4)")
+            .arg(table, name, value, QString::number(batch_size));
+    case DatabaseType::PostgreSQL:
+    case DatabaseType::MySQL:
+    default:
+        return QString("UPDATE %1 SET %2 = %3 WHERE ctid IN (SELECT ctid FROM %1 WHERE %2 IS NULL LIMIT %4)")
+            .arg(table, name, value, QString::number(batch_size));
+    }
+}
+
+bool Q1MigrationQuery::NeedsBackfill(const Q1Column &column) const
+{
+    if (!online || db_type == DatabaseType::SQLite)
+        return false;
+
+    // Constants and stable functions such as now() or GETDATE() are evaluated once and
+    // stored as metadata (PostgreSQL 11+, SQL Server 2012+ Enterprise). Only volatile
+    // functions are evaluated per row, which rewrites the whole table.
+    static const QRegularExpression volatile_call(
+        "\\b(random|gen_random_uuid|uuid_generate_v[14]|clock_timestamp|timeofday|nextval|newid|newsequentialid)\\s*\\(",
+        QRegularExpression::CaseInsensitiveOption);
+
+    const QString value = NormalizeDefaultValue(column);
+    const bool literal = value.startsWith('\'') || value.startsWith("N'", Qt::CaseInsensitive);
+    return !literal && volatile_call.match(value).hasMatch();
+}
+
+QString Q1MigrationQuery::OnlineAlterClauseSQL() const
+{
+    if (!online)
+        return QString();
+
+    // 3 = Enterprise/Developer, 5 = Azure SQL Database, 8 = Azure SQL Managed Instance
+    return "DECLARE @online NVARCHAR(32) = CASE WHEN CAST(SERVERPROPERTY('EngineEdition') AS INT) IN (3, 5, 8) "
+           "THEN N' WITH (ONLINE = ON)' ELSE N'' END; ";
+}
+
 QString Q1MigrationQuery::ColumnProperty(const Q1Column &column) const
 {
     if (db_type == DatabaseType::SQLServer)
@@ -396,6 +1145,10 @@ QString Q1MigrationQuery::ColumnProperty(const Q1Column &column) const
 
     QString type = ColumnTypeSql(column);
 
+    // Only INTEGER PRIMARY KEY aliases the rowid; SQLite integers are 64-bit anyway
+    if (db_type == DatabaseType::SQLite && column.primary_key && Q1Column::IsIdentityDefault(column.default_value))
+        return QString("%1 INTEGER PRIMARY KEY AUTOINCREMENT").arg(QuoteIdentifier(column.name));
+
     if (column.primary_key && Q1Column::IsIdentityDefault(column.default_value))
     {
         QString serial_type = "SERIAL";
@@ -425,6 +1178,70 @@ QString Q1MigrationQuery::ColumnProperty(const Q1Column &column) const
     return parts.join(" ");
 }
 
+bool Q1MigrationQuery::ForeignKeyColumns(const Q1Relation &relation, QString &fk_base, QString &fk_top,
+                                         QString &fk_column, QString &fk_ref_col) const
+{
+    switch (relation.type)
+    {
+    case ONE_TO_ONE:
+    case MANY_TO_ONE:
+        fk_base = relation.base_table;
+        fk_top = relation.top_table;
+        break;
+    case ONE_TO_MANY:
+        fk_base = relation.top_table;
+        fk_top = relation.base_table;
+        break;
+    case MANY_TO_MANY:
+    default:
+        return false;
+    }
+
+    fk_column = relation.foreign_key;
+    fk_ref_col = relation.reference_key;
+    return true;
+}
+
+QStringList Q1MigrationQuery::InlineForeignKeys(const Q1Table &q1table) const
+{
+    QStringList constraints;
+
+    for (const Q1Relation &relation : q1table.relations)
+    {
+        QString fkBase, fkTop, fkColumn, fkRefCol;
+        if (!relation.IsValid() || !ForeignKeyColumns(relation, fkBase, fkTop, fkColumn, fkRefCol))
+            continue;
+
+        if (fkBase.compare(q1table.table_name, Qt::CaseInsensitive) != 0)
+            continue;
+
+        if (relation.type == ONE_TO_ONE)
+        {
+            constraints << QString("CONSTRAINT %1 UNIQUE (%2)")
+                               .arg(QuoteIdentifier(QString("uq_%1_%2").arg(fkBase, fkColumn).toLower()),
+                                    QuoteIdentifier(fkColumn));
+        }
+
+        constraints << QString("CONSTRAINT %1 FOREIGN KEY (%2) REFERENCES %3(%4) ON DELETE %5 ON UPDATE %6")
+                           .arg(QuoteIdentifier(relation.GetConstraintName()),
+                                QuoteIdentifier(fkColumn),
+                                QuoteIdentifier(fkTop),
+                                QuoteIdentifier(fkRefCol),
+                                relation.GetOnDeleteString(),
+                                relation.GetOnUpdateString());
+    }
+
+    constraints.removeDuplicates();
+    return constraints;
+}
+
+QString Q1MigrationQuery::UnsupportedAlterColumn(const QString &table_name, const QString &column_name)
+{
+    m_lastError = QString("SQLite cannot alter column %1.%2 in place; recreate the table to change it")
+                      .arg(table_name, column_name);
+    return "";
+}
+
 QString Q1MigrationQuery::QuoteIdentifier(const QString &identifier) const
 {
     if (db_type == DatabaseType::SQLServer)
@@ -511,13 +1328,16 @@ QString Q1MigrationQuery::AlterColumnNullabilitySQL(const QString &table_name, c
                "FROM sys.columns c "
                "JOIN sys.types t ON c.user_type_id = t.user_type_id "
                "WHERE c.object_id = OBJECT_ID(N'%1') AND c.name = N'%2'; "
+               "%6"
                "IF @column_type IS NOT NULL "
-               "EXEC(N'ALTER TABLE %3 ALTER COLUMN %4 ' + @column_type + N' %5');")
+               "EXEC(N'ALTER TABLE %3 ALTER COLUMN %4 ' + @column_type + N' %5'%7);")
         .arg(EscapeSqlString(table_name),
              EscapeSqlString(column_name),
              QuoteIdentifier(table_name),
              QuoteIdentifier(column_name),
-             nullable ? "NULL" : "NOT NULL");
+             nullable ? "NULL" : "NOT NULL",
+             OnlineAlterClauseSQL(),
+             online ? " + @online" : "");
 }
 
 QString Q1MigrationQuery::DropDefaultConstraintSQL(const QString &table_name, const QString &column_name) const
@@ -2,9 +2,11 @@
 #define Q1MIGRATIONQUERY_H
 
 #include <QList>
+#include <QStringList>
 #include <QDebug>
 
 #include "../../Q1Core/Q1Entity/Q1Column.h"
+#include "../../Q1Core/Q1Entity/Q1Index.h"
 #include "../../Q1Core/Q1Entity/Q1Table.h"
 #include "../../Q1Core/Q1Entity/Q1Relation.h"
 
@@ -16,6 +18,22 @@ enum class DatabaseType
     SQLite
 };
 
+// One generated DDL statement and the object it creates, so callers can skip
+// objects that already exist without parsing the SQL back
+struct Q1Statement
+{
+    enum Kind
+    {
+        CREATE_TABLE,
+        ADD_CONSTRAINT
+    };
+
+    Kind kind = CREATE_TABLE;
+    QString table;      // table the statement creates or alters
+    QString target;     // name of the created table or constraint
+    QString sql;
+};
+
 class Q1ORM_EXPORT Q1MigrationQuery
 {
 public:
@@ -25,9 +43,26 @@ public:
     QString GetColumnsSQL(QString table_name);
     QString ConstraintExistsSQL(const QString &constraint_name);
 
+    // Whole-schema catalog reads for Q1SchemaSnapshot: one row per column of every
+    // table (GetColumnsSQL() columns plus table_name) and one row per constraint
+    // or index (kind = 'constraint' / 'index'; PostgreSQL lists valid indexes only)
+    QString SchemaColumnsSQL();
+    QString SchemaConstraintsSQL();
+    QString IndexExistsSQL(const QString &index_name);
+
+    // __q1orm_model holds one row (id = 1) with the fingerprint of the last applied model
+    QString CreateModelTableSQL();
+    QString GetModelFingerprintSQL();
+    QString SetModelFingerprintSQL();
+
     QString AddDatabaseSQL(QString database_name);
     QString AddTableSQL(Q1Table &q1table);
     QString AddColumnSQL(QString table_name, const Q1Column &column);
+    // Statements that create the relation in execution order: the junction table of
+    // a MANY_TO_MANY, otherwise an optional UNIQUE (ONE_TO_ONE) and the foreign key.
+    // Empty with lastError() set when the dialect cannot add it (SQLite).
+    QList<Q1Statement> AddRelationStatements(const Q1Relation &relation);
+    // AddRelationStatements() joined with "; "
     QString AddRelationSQL(const Q1Relation &relation);
 
     QString DropTableSQL(QString table_name);
@@ -42,7 +77,62 @@ public:
 
     QString HasNullDataSQL(QString table_name, QString column_name);
 
+    // PostgreSQL builds indexes CONCURRENTLY, so neither statement may run inside a transaction
+    QString CreateIndexSQL(const Q1Index &index);
+    QString DropIndexSQL(const QString &table_name, const QString &index_name, bool concurrently = true);
+    // Index that keeps lookups and joins on the relation's foreign key from scanning
+    // the child table; invalid when the key is already unique (ONE_TO_ONE)
+    Q1Index ForeignKeyIndex(const Q1Relation &relation) const;
+
+    // Online mode keeps DDL from blocking traffic on large tables: every statement
+    // waits at most lock_timeout_ms for its lock, SQL Server ALTER COLUMN uses
+    // ONLINE = ON on editions that have it, NOT NULL is added through a validated
+    // CHECK on PostgreSQL and non-constant defaults are backfilled batch_size rows
+    // at a time. Q1MigrationPlan turns these into separate short transactions.
+    void SetOnline(bool online, int lock_timeout_ms = 5000, int batch_size = 10000);
+    bool IsOnline() const { return online; }
+    int LockTimeoutMs() const { return lock_timeout_ms; }
+    int BatchSize() const { return batch_size; }
+
+    QString LockTimeoutSQL() const;
+    QString ResetLockTimeoutSQL() const;
+    // True when error is the lock timeout set by LockTimeoutSQL()
+    bool IsLockTimeout(const QString &native_error_code) const;
+    QStringList SetNotNullOnlineSQL(const QString &table_name, const QString &column_name);
+    // One batch of UPDATE ... SET column = default WHERE column IS NULL; repeat until 0 rows
+    QString BackfillSQL(const QString &table_name, const Q1Column &column) const;
+    // True when adding column in online mode must go through a backfill
+    bool NeedsBackfill(const Q1Column &column) const;
+
+    // Declarative partitions of a Q1Table::partition: PostgreSQL supports RANGE, LIST
+    // and HASH; SQL Server RANGE through a partition function and scheme (pf_/ps_<table>)
+    // created with the table. Unsupported combinations create a plain table. RANGE
+    // partitions are time intervals, so their column must be a DATE or TIMESTAMP.
+    bool SupportsPartition(const Q1Partition &partition) const;
+    // RANGE boundaries are dates: false (and m_lastError) for a missing or non-date column
+    bool CheckRangeColumn(const Q1Table &q1table);
+    // Current and premade RANGE partitions (SPLIT RANGE on SQL Server), every LIST or
+    // HASH partition; each statement is a no-op when its partition exists
+    QStringList CreatePartitionsSQL(const Q1Table &q1table, const QDate &today);
+    // Child tables of a PostgreSQL partitioned table (partition_name)
+    QString PartitionListSQL(const QString &table_name);
+    // RANGE partitions older than the retention: DROP TABLE of each expired child on
+    // PostgreSQL (from existing), TRUNCATE + MERGE RANGE below the cutoff on SQL Server
+    QStringList DropExpiredPartitionsSQL(const Q1Table &q1table, const QStringList &existing, const QDate &today);
+
+    // Views of Q1Table::view. The Q1View::Marker() is stored with the view (a comment
+    // on PostgreSQL, inside the definition elsewhere) so a changed declaration is found.
+    // Materialized views are MATERIALIZED VIEWs on PostgreSQL and indexed views
+    // (SCHEMABINDING + unique clustered index) on SQL Server; SQLite gets a plain view.
+    QStringList CreateViewSQL(const Q1Table &view);
+    QString DropViewSQL(const Q1Table &view);
+    // Empty when the server keeps the view current by itself
+    QString RefreshViewSQL(const Q1Table &view);
+    // One row (definition) containing the marker when the view exists
+    QString ViewDefinitionSQL(const QString &view_name);
+
     QString lastError() const { return m_lastError; }
+    DatabaseType databaseType() const { return db_type; }
 
 private:
     QString ColumnProperty(const Q1Column &column) const;
@@ -54,8 +144,18 @@ private:
     QString DropDefaultConstraintSQL(const QString &table_name, const QString &column_name) const;
     QString NormalizeDefaultValue(const Q1Column &column) const;
     QString FormatDefaultExpression(const QString &default_value) const;
+    bool ForeignKeyColumns(const Q1Relation &relation, QString &fk_base, QString &fk_top,
+                           QString &fk_column, QString &fk_ref_col) const;
+    QStringList InlineForeignKeys(const Q1Table &q1table) const;
+    QString UnsupportedAlterColumn(const QString &table_name, const QString &column_name);
+    QString OnlineAlterClauseSQL() const;
+    QString PartitionFunctionName(const QString &table_name) const { return "pf_" + table_name; }
+    QString PartitionSchemeName(const QString &table_name) const { return "ps_" + table_name; }
     QString m_lastError;
     DatabaseType db_type;
+    bool online = false;
+    int lock_timeout_ms = 5000;
+    int batch_size = 10000;
 };
 
 #endif // Q1MIGRATIONQUERY_H
@@ -0,0 +1,124 @@
+#include "Q1SchemaSnapshot.h"
+
+void Q1SchemaSnapshot::Clear()
+{
+    loaded = false;
+    table_names.clear();
+    columns.clear();
+    constraints.clear();
+    definitions.clear();
+    indexes.clear();
+}
+
+bool Q1SchemaSnapshot::HasTable(const QString& table_name) const
+{
+    return columns.contains(table_name.toLower());
+}
+
+QList<Q1Column> Q1SchemaSnapshot::Columns(const QString& table_name) const
+{
+    return columns.value(table_name.toLower());
+}
+
+bool Q1SchemaSnapshot::HasConstraint(const QString& constraint_name) const
+{
+    const QString name = constraint_name.toLower();
+    if (constraints.contains(name))
+        return true;
+
+    const QString quoted = "\"" + name + "\"";
+    for (const QString& definition : definitions)
+    {
+        if (definition.contains(quoted))
+            return true;
+    }
+
+    return false;
+}
+
+void Q1SchemaSnapshot::AddConstraint(const QString& constraint_name)
+{
+    constraints.insert(constraint_name.toLower());
+}
+
+bool Q1SchemaSnapshot::HasIndex(const QString& index_name) const
+{
+    for (const QStringList& names : indexes)
+    {
+        if (names.contains(index_name, Qt::CaseInsensitive))
+            return true;
+    }
+
+    return false;
+}
+
+QStringList Q1SchemaSnapshot::Indexes(const QString& table_name) const
+{
+    return indexes.value(table_name.toLower());
+}
+
+void Q1SchemaSnapshot::AddIndex(const QString& table_name, const QString& index_name)
+{
+    QStringList& names = indexes[table_name.toLower()];
+    if (!names.contains(index_name, Qt::CaseInsensitive))
+        names.append(index_name);
+}
+
+void Q1SchemaSnapshot::RemoveIndex(const QString& table_name, const QString& index_name)
+{
+    indexes[table_name.toLower()].removeAll(index_name);
+}
+
+void Q1SchemaSnapshot::ReadColumns(QSqlQuery& sql)
+{
+    while (sql.next())
+    {
+        const QString table_name = sql.value("table_name").toString();
+        const QString key = table_name.toLower();
+
+        if (!columns.contains(key))
+            table_names.append(table_name);
+
+        columns[key].append(ColumnFromRow(sql));
+    }
+}
+
+void Q1SchemaSnapshot::ReadConstraints(QSqlQuery& sql)
+{
+    while (sql.next())
+    {
+        const QString name = sql.value("constraint_name").toString();
+        if (sql.value("kind").toString() == "index")
+        {
+            AddIndex(sql.value("table_name").toString(), name);
+            continue;
+        }
+
+        if (!name.isEmpty())
+            constraints.insert(name.toLower());
+
+        const QString definition = sql.value("definition").toString();
+        if (!definition.isEmpty())
+            definitions.append(definition.toLower());
+    }
+}
+
+Q1Column Q1SchemaSnapshot::ColumnFromRow(const QSqlQuery& sql)
+{
+    Q1Column column;
+    column.name = sql.value("column_name").toString();
+    column.type = Q1Column::GetColumnType(sql.value("data_type").toString());
+    column.size = sql.value("character_maximum_length").toInt();
+    column.nullable = (sql.value("is_nullable").toString() == "YES");
+    const QVariant identityValue = sql.value("is_identity");
+    const QString identityText = identityValue.toString();
+    const bool isIdentity = identityValue.toBool() ||
+                            identityValue.toInt() != 0 ||
+                            identityText.compare("YES", Qt::CaseInsensitive) == 0 ||
+                            identityText.compare("true", Qt::CaseInsensitive) == 0;
+    column.is_identity = isIdentity;
+    column.default_value = isIdentity
+                               ? QStringLiteral("GENERATED ALWAYS AS IDENTITY")
+                               : Q1Column::NormalizeDefaultValue(sql.value("column_default").toString());
+    return column;
+}
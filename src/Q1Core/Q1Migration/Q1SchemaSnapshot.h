@@ -0,0 +1,55 @@
+#ifndef Q1SCHEMASNAPSHOT_H
+#define Q1SCHEMASNAPSHOT_H
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QSqlQuery>
+#include <QStringList>
+
+#include "../../Q1Core/Q1Entity/Q1Column.h"
+
+#include "../../Q1ORM_global.h"
+
+// In-memory copy of the schema's tables, columns, constraints and indexes, read by
+// Q1Migration::LoadSchemaSnapshot() in two catalog queries. Q1Context diffs the
+// declared model against it instead of querying the catalog once per table and
+// relation. Table, constraint and index lookups are case-insensitive.
+class Q1ORM_EXPORT Q1SchemaSnapshot
+{
+public:
+    bool IsLoaded() const { return loaded; }
+    void Clear();
+
+    QStringList Tables() const { return table_names; }
+    bool HasTable(const QString& table_name) const;
+    QList<Q1Column> Columns(const QString& table_name) const;
+
+    bool HasConstraint(const QString& constraint_name) const;
+
+    bool HasIndex(const QString& index_name) const;
+    QStringList Indexes(const QString& table_name) const;
+
+    // Keep the snapshot current after DDL that Q1Context ran itself
+    void AddConstraint(const QString& constraint_name);
+    void AddIndex(const QString& table_name, const QString& index_name);
+    void RemoveIndex(const QString& table_name, const QString& index_name);
+
+    // Fill from the results of SchemaColumnsSQL() and SchemaConstraintsSQL()
+    void ReadColumns(QSqlQuery& sql);
+    void ReadConstraints(QSqlQuery& sql);
+    void SetLoaded(bool loaded) { this->loaded = loaded; }
+
+    // One row of GetColumnsSQL() / SchemaColumnsSQL()
+    static Q1Column ColumnFromRow(const QSqlQuery& sql);
+
+private:
+    bool loaded = false;
+    QStringList table_names;
+    QHash<QString, QList<Q1Column>> columns;    // lower-case table name
+    QSet<QString> constraints;                  // lower-case constraint names
+    QStringList definitions;                    // lower-case CREATE TABLE text (SQLite)
+    QHash<QString, QStringList> indexes;        // lower-case table name -> index names
+};
+
+#endif // Q1SCHEMASNAPSHOT_H
@@ -0,0 +1,302 @@
+#include "Q1MockDriver.h"
+
+#include <QMutexLocker>
+#include <QtSql/QSqlError>
+#include <QtSql/QSqlField>
+
+/* ********************************* Result set ********************************** */
+
+Q1MockResultSet Q1MockResultSet::Rows(const QStringList& columns, const QList<QVariantList>& rows)
+{
+    Q1MockResultSet result;
+    result.columns = columns;
+    result.rows = rows;
+    return result;
+}
+
+Q1MockResultSet Q1MockResultSet::Generated(const QStringList& columns, int row_count,
+                                           const std::function<QVariant(int row, int column)>& generator)
+{
+    Q1MockResultSet result;
+    result.columns = columns;
+    result.row_count = row_count;
+    result.generator = generator;
+    return result;
+}
+
+Q1MockResultSet Q1MockResultSet::Affected(int rows_affected)
+{
+    Q1MockResultSet result;
+    result.rows_affected = rows_affected;
+    return result;
+}
+
+Q1MockResultSet Q1MockResultSet::Error(const QString& message)
+{
+    Q1MockResultSet result;
+    result.error = message;
+    return result;
+}
+
+int Q1MockResultSet::RowCount() const
+{
+    return generator ? row_count : rows.size();
+}
+
+QVariant Q1MockResultSet::Value(int row, int column) const
+{
+    if (row < 0 || row >= RowCount())
+        return QVariant();
+
+    if (generator)
+        return generator(row, column);
+
+    return rows[row].value(column);
+}
+
+/* ********************************* Server ************************************** */
+
+void Q1MockServer::When(const QString& pattern, const Q1MockResultSet& result)
+{
+    QMutexLocker locker(&mutex);
+    rules.append(qMakePair(QRegularExpression(pattern, QRegularExpression::CaseInsensitiveOption), result));
+}
+
+Q1MockResultSet Q1MockServer::Execute(const QString& sql, const QVariantList& binds)
+{
+    QMutexLocker locker(&mutex);
+
+    ++executed_count;
+    if (log_limit != 0)
+    {
+        log.append(Q1MockStatement{sql, binds});
+        if (log_limit > 0 && log.size() > log_limit)
+            log.removeFirst();
+    }
+
+    for (int i = rules.size() - 1; i >= 0; --i)
+    {
+        if (rules[i].first.match(sql).hasMatch())
+            return rules[i].second;
+    }
+
+    return Q1MockResultSet();
+}
+
+QList<Q1MockStatement> Q1MockServer::Executed() const
+{
+    QMutexLocker locker(&mutex);
+    return log;
+}
+
+QStringList Q1MockServer::ExecutedSql() const
+{
+    QMutexLocker locker(&mutex);
+
+    QStringList sql;
+    for (const Q1MockStatement& statement : log)
+        sql.append(statement.sql);
+
+    return sql;
+}
+
+int Q1MockServer::ExecutedCount() const
+{
+    QMutexLocker locker(&mutex);
+    return executed_count;
+}
+
+void Q1MockServer::SetLogLimit(int max_statements)
+{
+    QMutexLocker locker(&mutex);
+    log_limit = max_statements;
+
+    if (log_limit == 0)
+        log.clear();
+    while (log_limit > 0 && log.size() > log_limit)
+        log.removeFirst();
+}
+
+void Q1MockServer::ClearLog()
+{
+    QMutexLocker locker(&mutex);
+    log.clear();
+    executed_count = 0;
+}
+
+void Q1MockServer::Reset()
+{
+    QMutexLocker locker(&mutex);
+    rules.clear();
+    log.clear();
+    executed_count = 0;
+}
+
+/* ********************************* Driver ************************************** */
+
+Q1MockDriver::Q1MockDriver(const QSharedPointer<Q1MockServer>& server, QObject* parent)
+    : QSqlDriver(parent),
+    server(server)
+{
+}
+
+std::function<QSqlDriver*()> Q1MockDriver::Factory(const QSharedPointer<Q1MockServer>& server)
+{
+    return [server]() -> QSqlDriver* { return new Q1MockDriver(server); };
+}
+
+QSharedPointer<Q1MockServer> Q1MockDriver::GetServer() const
+{
+    return server;
+}
+
+bool Q1MockDriver::hasFeature(DriverFeature feature) const
+{
+    switch (feature)
+    {
+    case Transactions:
+    case QuerySize:
+    case PreparedQueries:
+    case PositionalPlaceholders:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool Q1MockDriver::open(const QString&, const QString&, const QString&, const QString&, int, const QString&)
+{
+    setOpen(true);
+    setOpenError(false);
+    return true;
+}
+
+void Q1MockDriver::close()
+{
+    setOpen(false);
+    setOpenError(false);
+}
+
+QSqlResult* Q1MockDriver::createResult() const
+{
+    return new Q1MockResult(this);
+}
+
+bool Q1MockDriver::beginTransaction()
+{
+    return server->Execute("BEGIN").error.isEmpty();
+}
+
+bool Q1MockDriver::commitTransaction()
+{
+    return server->Execute("COMMIT").error.isEmpty();
+}
+
+bool Q1MockDriver::rollbackTransaction()
+{
+    return server->Execute("ROLLBACK").error.isEmpty();
+}
+
+/* ********************************* Result ************************************** */
+
+Q1MockResult::Q1MockResult(const Q1MockDriver* driver)
+    : QSqlResult(driver),
+    server(driver->GetServer())
+{
+}
+
+QVariant Q1MockResult::data(int index)
+{
+    return result.Value(at(), index);
+}
+
+bool Q1MockResult::isNull(int index)
+{
+    return data(index).isNull();
+}
+
+bool Q1MockResult::reset(const QString& query)
+{
+    setQuery(query);
+    return Run(query, QVariantList());
+}
+
+bool Q1MockResult::prepare(const QString& query)
+{
+    setQuery(query);
+    return true;
+}
+
+bool Q1MockResult::exec()
+{
+    QVariantList binds;
+    for (const QVariant& value : boundValues())
+        binds.append(value);
+
+    return Run(lastQuery(), binds);
+}
+
+bool Q1MockResult::fetch(int index)
+{
+    if (index < 0 || index >= result.RowCount())
+        return false;
+
+    setAt(index);
+    return true;
+}
+
+bool Q1MockResult::fetchFirst()
+{
+    return fetch(0);
+}
+
+bool Q1MockResult::fetchLast()
+{
+    return fetch(result.RowCount() - 1);
+}
+
+int Q1MockResult::size()
+{
+    return isSelect() ? result.RowCount() : -1;
+}
+
+int Q1MockResult::numRowsAffected()
+{
+    return result.rows_affected >= 0 ? result.rows_affected : result.RowCount();
+}
+
+QSqlRecord Q1MockResult::record() const
+{
+    QSqlRecord rec;
+    if (!isActive() || !isSelect())
+        return rec;
+
+    for (int i = 0; i < result.columns.size(); ++i)
+    {
+        const QVariant sample = result.RowCount() > 0 ? result.Value(0, i) : QVariant(QString());
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+        rec.append(QSqlField(result.columns[i], sample.metaType()));
+#else
+        rec.append(QSqlField(result.columns[i], sample.type()));
+#endif
+    }
+
+    return rec;
+}
+
+bool Q1MockResult::Run(const QString& sql, const QVariantList& binds)
+{
+    result = server->Execute(sql, binds);
+    setAt(QSql::BeforeFirstRow);
+
+    if (!result.error.isEmpty())
+    {
+        setLastError(QSqlError(QStringLiteral("Q1MockDriver"), result.error, QSqlError::StatementError));
+        setActive(false);
+        return false;
+    }
+
+    setSelect(!result.columns.isEmpty());
+    setActive(true);
+    return true;
+}
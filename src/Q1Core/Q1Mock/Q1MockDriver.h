@@ -0,0 +1,133 @@
+#ifndef Q1MOCKDRIVER_H
+#define Q1MOCKDRIVER_H
+
+#include <functional>
+#include <QList>
+#include <QMutex>
+#include <QPair>
+#include <QRegularExpression>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QtSql/QSqlDriver>
+#include <QtSql/QSqlRecord>
+#include <QtSql/QSqlResult>
+
+#include "../../Q1ORM_global.h"
+
+// Result served for a statement by Q1MockServer
+struct Q1ORM_EXPORT Q1MockResultSet
+{
+    QStringList columns;
+    QList<QVariantList> rows;
+
+    // Generated result sets: row_count rows produced on demand by generator(row, column)
+    int row_count = 0;
+    std::function<QVariant(int row, int column)> generator;
+
+    int rows_affected = -1;     // -1: number of rows
+    QString error;              // non-empty: the statement fails with this message
+
+    static Q1MockResultSet Rows(const QStringList& columns, const QList<QVariantList>& rows);
+    static Q1MockResultSet Generated(const QStringList& columns, int row_count,
+                                     const std::function<QVariant(int row, int column)>& generator);
+    static Q1MockResultSet Affected(int rows_affected);
+    static Q1MockResultSet Error(const QString& message);
+
+    int RowCount() const;
+    QVariant Value(int row, int column) const;
+};
+
+struct Q1ORM_EXPORT Q1MockStatement
+{
+    QString sql;
+    QVariantList binds;
+};
+
+// In-process stand-in for a database server, shared by every Q1MockDriver created
+// from it (including Q1Executor's per-thread clones). Statements are matched against
+// the registered patterns and recorded with their bind values. Thread-safe.
+class Q1ORM_EXPORT Q1MockServer
+{
+public:
+    // pattern is a case-insensitive regular expression searched in the SQL text;
+    // when several patterns match, the one registered last wins.
+    // Statements without a match succeed with an empty result.
+    void When(const QString& pattern, const Q1MockResultSet& result);
+
+    Q1MockResultSet Execute(const QString& sql, const QVariantList& binds = QVariantList());
+
+    QList<Q1MockStatement> Executed() const;
+    QStringList ExecutedSql() const;
+    int ExecutedCount() const;
+
+    // Keep only the last max_statements statements (0: keep none, -1: unlimited)
+    void SetLogLimit(int max_statements);
+    void ClearLog();
+    void Reset();
+
+private:
+    mutable QMutex mutex;
+    QList<QPair<QRegularExpression, Q1MockResultSet>> rules;
+    QList<Q1MockStatement> log;
+    int log_limit = -1;
+    int executed_count = 0;
+};
+
+// QSqlDriver that answers from a Q1MockServer instead of a network connection:
+//
+//   auto server = QSharedPointer<Q1MockServer>::create();
+//   server->When("^SELECT", Q1MockResultSet::Rows({"id", "name"}, {{1, "Paris"}}));
+//   Q1Connection connection(POSTGRE_SQL, Q1MockDriver::Factory(server));
+//
+// The Q1Driver passed to Q1Connection selects the SQL dialect that is generated.
+class Q1ORM_EXPORT Q1MockDriver : public QSqlDriver
+{
+public:
+    explicit Q1MockDriver(const QSharedPointer<Q1MockServer>& server, QObject* parent = nullptr);
+
+    static std::function<QSqlDriver*()> Factory(const QSharedPointer<Q1MockServer>& server);
+
+    QSharedPointer<Q1MockServer> GetServer() const;
+
+    bool hasFeature(DriverFeature feature) const override;
+    bool open(const QString& db, const QString& user, const QString& password,
+              const QString& host, int port, const QString& options) override;
+    void close() override;
+    QSqlResult* createResult() const override;
+
+    bool beginTransaction() override;
+    bool commitTransaction() override;
+    bool rollbackTransaction() override;
+
+private:
+    QSharedPointer<Q1MockServer> server;
+};
+
+class Q1ORM_EXPORT Q1MockResult : public QSqlResult
+{
+public:
+    explicit Q1MockResult(const Q1MockDriver* driver);
+
+protected:
+    QVariant data(int index) override;
+    bool isNull(int index) override;
+    bool reset(const QString& query) override;
+    bool prepare(const QString& query) override;
+    bool exec() override;
+    bool fetch(int index) override;
+    bool fetchFirst() override;
+    bool fetchLast() override;
+    int size() override;
+    int numRowsAffected() override;
+    QSqlRecord record() const override;
+
+private:
+    bool Run(const QString& sql, const QVariantList& binds);
+
+    QSharedPointer<Q1MockServer> server;
+    Q1MockResultSet result;
+};
+
+#endif // Q1MOCKDRIVER_H
@@ -0,0 +1,418 @@
+#ifndef Q1BATCH_H
+#define Q1BATCH_H
+
+#include <functional>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QDebug>
+#include <QVariant>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSharedPointer>
+#include <QtSql/QSqlQuery>
+#include <QtSql/QSqlError>
+
+#include "../../Q1Core/Q1Context/Q1Connection.h"
+#include "../../Q1Core/Q1Diagnostics/Q1StatementTimer.h"
+#include "../../Q1Core/Q1Entity/Q1Entity.h"
+#include "../../Q1Core/Q1Query/Q1Query.h"
+
+// Handle to one statement of a Q1Batch; filled in by Q1Batch::Execute().
+// A statement that failed leaves IsReady() false and sets Failed().
+template<typename T>
+class Q1BatchResult
+{
+public:
+    Q1BatchResult() : state(new State()) {}
+
+    bool IsReady() const
+    {
+        return state->ready;
+    }
+
+    bool Failed() const
+    {
+        return state->failed;
+    }
+
+    const T& Value() const
+    {
+        return state->value;
+    }
+
+    operator const T&() const
+    {
+        return state->value;
+    }
+
+private:
+    friend class Q1Batch;
+
+    struct State
+    {
+        T value = T();
+        bool ready = false;
+        bool failed = false;
+    };
+
+    QSharedPointer<State> state;
+};
+
+// Sends several independent queries in one round trip.
+//
+//   Q1Batch batch(connection);
+//   auto cities    = batch.Add(context.cities.Select().Where("country_id = 1"));
+//   auto countries = batch.Count(context.countries.Select());
+//   batch.Execute();
+//   qDebug() << cities.Value().size() << countries.Value();
+//
+// PostgreSQL: all statements become scalar subqueries of a single SELECT, lists are
+// returned as json_agg arrays. SQL Server: statements are sent as one multi-statement
+// batch and read with nextResult(). Other drivers run the statements one after
+// another on a single open connection.
+// Queries must belong to the batch's connection and outlive Execute(). A batch of
+// reads runs on one of the connection's replicas when it has any. A failed statement
+// does not stop the others that can still run; see Q1BatchResult::Failed().
+class Q1Batch
+{
+public:
+    explicit Q1Batch(Q1Connection* connection)
+        : connection(connection) {}
+
+    template<typename Entity>
+    Q1BatchResult<QList<Entity>> Add(const Q1Query<Entity>& query)
+    {
+        Q1BatchResult<QList<Entity>> result;
+        auto state = result.state;
+        Q1Entity<Entity>* repository = query.GetRepository();
+
+        if (!repository)
+        {
+            state->ready = true;
+            return result;
+        }
+        Q_ASSERT_X(repository->GetConnection() == connection, "Q1Batch::Add",
+                   "the query's entity set uses another connection than the batch");
+
+        Item item;
+        item.fail = [state]() {
+            state->failed = true;
+        };
+
+        if (query.HasIncludes())
+        {
+            // Includes need their own relation queries, so the query runs on its own
+            item.run = [state, query, repository]() mutable {
+                state->value = query.ToList();
+                const QString error = repository->GetLastError();
+                state->failed = !error.isEmpty();
+                state->ready = !state->failed;
+                return error;
+            };
+            items.append(item);
+            return result;
+        }
+
+        item.sql = query.ToSql();
+        item.column = "(" + query.ToJsonArraySql() + ")";
+
+        item.read_value = [state, repository](const QVariant& value) {
+            const QJsonArray rows = QJsonDocument::fromJson(value.toString().toUtf8()).array();
+            state->value.clear();
+            state->value.reserve(rows.size());
+
+            for (const QJsonValue& row : rows)
+            {
+                state->value.append(repository->JsonToEntity(row.toObject()));
+            }
+            state->ready = true;
+        };
+
+        item.read_result = [state, repository](QSqlQuery& sql_query) {
+            state->value = repository->ReadResult(sql_query);
+            state->ready = true;
+        };
+
+        items.append(item);
+        return result;
+    }
+
+    // Aggregate functions
+    template<typename T = double, typename Entity>
+    Q1BatchResult<T> Max(const Q1Query<Entity>& query, const QString& column)
+    {
+        return Aggregate<T>(query, QString("MAX(%1)").arg(column));
+    }
+
+    template<typename T = double, typename Entity>
+    Q1BatchResult<T> Min(const Q1Query<Entity>& query, const QString& column)
+    {
+        return Aggregate<T>(query, QString("MIN(%1)").arg(column));
+    }
+
+    template<typename T = int, typename Entity>
+    Q1BatchResult<T> Count(const Q1Query<Entity>& query, const QString& column = "*")
+    {
+        return Aggregate<T>(query, QString("COUNT(%1)").arg(column));
+    }
+
+    template<typename T = double, typename Entity>
+    Q1BatchResult<T> Sum(const Q1Query<Entity>& query, const QString& column)
+    {
+        return Aggregate<T>(query, QString("SUM(%1)").arg(column));
+    }
+
+    template<typename T = double, typename Entity>
+    Q1BatchResult<T> Avg(const Q1Query<Entity>& query, const QString& column)
+    {
+        return Aggregate<T>(query, QString("AVG(%1)").arg(column));
+    }
+
+    template<typename T, typename Entity>
+    Q1BatchResult<T> Aggregate(const Q1Query<Entity>& query, const QString& function)
+    {
+        Q1BatchResult<T> result;
+        auto state = result.state;
+
+        if (!query.GetRepository())
+        {
+            state->ready = true;
+            return result;
+        }
+        Q_ASSERT_X(query.GetRepository()->GetConnection() == connection, "Q1Batch::Aggregate",
+                   "the query's entity set uses another connection than the batch");
+
+        Item item;
+        item.fail = [state]() {
+            state->failed = true;
+        };
+        item.sql = query.ToAggregateSql(function);
+        item.column = QString("(SELECT __agg FROM (%1) AS q1_batch LIMIT 1)").arg(item.sql);
+
+        item.read_value = [state](const QVariant& value) {
+            state->value = Q1Query<Entity>::template ConvertAggregate<T>(value);
+            state->ready = true;
+        };
+
+        item.read_result = [state](QSqlQuery& sql_query) {
+            state->value = Q1Query<Entity>::template ConvertAggregate<T>(sql_query.next() ? sql_query.value(0) : QVariant());
+            state->ready = true;
+        };
+
+        items.append(item);
+        return result;
+    }
+
+    // Runs every queued statement and empties the batch
+    bool Execute()
+    {
+        last_error.clear();
+
+        QList<Item> batched;
+        QList<Item> separate;
+        for (const Item& item : items)
+        {
+            (item.run ? separate : batched).append(item);
+        }
+        items.clear();
+
+        bool success = batched.isEmpty() || ExecuteBatched(batched);
+
+        // Queries that run on their own still run when the batch failed
+        for (Item& item : separate)
+        {
+            const QString error = item.run();
+            if (!error.isEmpty())
+            {
+                if (success)
+                    last_error = error;
+                success = false;
+            }
+        }
+
+        return success;
+    }
+
+    int Size() const
+    {
+        return items.size();
+    }
+
+    void Clear()
+    {
+        items.clear();
+    }
+
+    QString GetLastError() const
+    {
+        return last_error;
+    }
+
+private:
+    struct Item
+    {
+        QString sql;                                   // standalone statement
+        QString column;                                // scalar subquery form (PostgreSQL)
+        std::function<void(const QVariant&)> read_value;
+        std::function<void(QSqlQuery&)> read_result;
+        std::function<void()> fail;
+        std::function<QString()> run;                  // queries that cannot be batched; returns the error
+    };
+
+    bool ExecuteBatched(const QList<Item>& batched)
+    {
+        Q1StatementTimer timer(connection, "batch");
+        Q1Connection* target = Target(batched);
+        timer.SetConnection(target);
+
+        if (!target || !target->Connect())
+        {
+            last_error = "Database connection failed";
+            Fail(batched, 0);
+            return false;
+        }
+        timer.Lap(Q1StatementPhase::Connect);
+
+        bool success = false;
+        if (target->IsPostgreSql())
+            success = ExecuteSingleSelect(target->database, batched);
+        else if (target->IsSqlServer())
+            success = ExecuteMultiStatement(target->database, batched);
+        else
+            success = ExecuteSequential(target->database, batched);
+
+        // Statements of a batch are timed as a whole; rows counts the statements
+        timer.Lap(Q1StatementPhase::Execute);
+        timer.AddRows(batched.size());
+        timer.Finish(success);
+
+        target->Disconnect();
+        return success;
+    }
+
+    // Marks batched[from..] failed
+    static void Fail(const QList<Item>& batched, int from)
+    {
+        for (int i = from; i < batched.size(); ++i)
+        {
+            batched[i].fail();
+        }
+    }
+
+    // A replica when every statement only reads, else the primary (pinning the
+    // session to it under ReadYourWrites); see Q1Connection::ReadConnection()
+    Q1Connection* Target(const QList<Item>& batched) const
+    {
+        if (!connection)
+            return nullptr;
+
+        for (const Item& item : batched)
+        {
+            if (!Q1Connection::IsReadOnlyStatement(item.sql))
+            {
+                connection->MarkWrite();
+                return connection;
+            }
+        }
+
+        return connection->ReadConnection();
+    }
+
+    bool ExecuteSingleSelect(QSqlDatabase& database, const QList<Item>& batched)
+    {
+        QStringList columns;
+        for (int i = 0; i < batched.size(); ++i)
+        {
+            columns << QString("%1 AS r%2").arg(batched[i].column).arg(i);
+        }
+
+        const QString sql = "SELECT " + columns.join(", ");
+        qDebug() << "Executing batch:" << sql;
+
+        QSqlQuery sql_query(database);
+        sql_query.setForwardOnly(true);
+        if (!sql_query.exec(sql) || !sql_query.next())
+        {
+            last_error = sql_query.lastError().text();
+            qDebug() << "Batch failed:" << last_error;
+            Fail(batched, 0);
+            return false;
+        }
+
+        for (int i = 0; i < batched.size(); ++i)
+        {
+            batched[i].read_value(sql_query.value(i));
+        }
+
+        return true;
+    }
+
+    bool ExecuteMultiStatement(QSqlDatabase& database, const QList<Item>& batched)
+    {
+        QStringList statements;
+        for (const Item& item : batched)
+        {
+            statements << item.sql;
+        }
+
+        const QString sql = statements.join(";\n");
+        qDebug() << "Executing batch:" << sql;
+
+        QSqlQuery sql_query(database);
+        sql_query.setForwardOnly(true);
+        if (!sql_query.exec(sql))
+        {
+            last_error = sql_query.lastError().text();
+            qDebug() << "Batch failed:" << last_error;
+            Fail(batched, 0);
+            return false;
+        }
+
+        for (int i = 0; i < batched.size(); ++i)
+        {
+            if (i > 0 && !sql_query.nextResult())
+            {
+                last_error = QString("Batch returned %1 of %2 result sets").arg(i).arg(batched.size());
+                qDebug() << "Batch failed:" << last_error;
+                Fail(batched, i);
+                return false;
+            }
+
+            batched[i].read_result(sql_query);
+        }
+
+        return true;
+    }
+
+    bool ExecuteSequential(QSqlDatabase& database, const QList<Item>& batched)
+    {
+        bool success = true;
+        for (const Item& item : batched)
+        {
+            QSqlQuery sql_query(database);
+            sql_query.setForwardOnly(true);
+            if (!sql_query.exec(item.sql))
+            {
+                // The statements are independent, so the rest still run
+                if (success)
+                    last_error = sql_query.lastError().text();
+                qDebug() << "Batch statement failed:" << sql_query.lastError().text();
+                item.fail();
+                success = false;
+                continue;
+            }
+
+            item.read_result(sql_query);
+        }
+
+        return success;
+    }
+
+    Q1Connection* connection;
+    QList<Item> items;
+    QString last_error;
+};
+
+#endif // Q1BATCH_H
@@ -0,0 +1,186 @@
+#ifndef Q1JSONWRITER_H
+#define Q1JSONWRITER_H
+
+#include <algorithm>
+#include <QByteArray>
+#include <QDate>
+#include <QDateTime>
+#include <QIODevice>
+#include <QList>
+#include <QLocale>
+#include <QPair>
+#include <QString>
+#include <QtNumeric>
+#include <QVariant>
+#include <QtSql/QSqlQuery>
+#include <QtSql/QSqlRecord>
+
+// Writes query rows as a compact JSON array straight to a QIODevice.
+// Output matches Q1Query::ToJson(): keys sorted, first column wins on name clashes
+// and values mapped like Q1Entity::ToJsonValue().
+class Q1JsonWriter
+{
+public:
+    explicit Q1JsonWriter(QIODevice* device)
+        : device(device) {}
+
+    void BeginArray()
+    {
+        Write("[");
+    }
+
+    void EndArray()
+    {
+        Write("]");
+    }
+
+    void WriteRow(const QSqlQuery& sql_query)
+    {
+        if (keys.isEmpty())
+        {
+            PrepareKeys(sql_query.record());
+        }
+
+        buffer.clear();
+        buffer.append(row_count++ > 0 ? ",{" : "{");
+
+        for (int i = 0; i < keys.size(); ++i)
+        {
+            if (i > 0)
+            {
+                buffer.append(',');
+            }
+            buffer.append(keys[i].second);
+            AppendValue(buffer, sql_query.value(keys[i].first));
+        }
+
+        buffer.append('}');
+        Write(buffer);
+    }
+
+    bool IsOk() const
+    {
+        return ok;
+    }
+
+    static void AppendString(QByteArray& out, const QString& value)
+    {
+        static const char hex[] = "0123456789abcdef";
+
+        out.append('"');
+        for (int i = 0; i < value.size(); ++i)
+        {
+            const ushort code = value.at(i).unicode();
+            switch (code)
+            {
+            case '"':  out.append("\\\""); break;
+            case '\\': out.append("\\\\"); break;
+            case '\b': out.append("\\b"); break;
+            case '\f': out.append("\\f"); break;
+            case '\n': out.append("\\n"); break;
+            case '\r': out.append("\\r"); break;
+            case '\t': out.append("\\t"); break;
+            default:
+                if (code < 0x20)
+                {
+                    out.append("\\u00");
+                    out.append(hex[code >> 4]);
+                    out.append(hex[code & 0xf]);
+                }
+                else if (code < 0x80)
+                {
+                    out.append(static_cast<char>(code));
+                }
+                else
+                {
+                    // Convert the whole non-ASCII run so surrogate pairs stay together
+                    int end = i + 1;
+                    while (end < value.size() && value.at(end).unicode() >= 0x80)
+                    {
+                        ++end;
+                    }
+                    out.append(value.mid(i, end - i).toUtf8());
+                    i = end - 1;
+                }
+            }
+        }
+        out.append('"');
+    }
+
+private:
+    // Escaped '"key":' prefixes, computed once per result set
+    void PrepareKeys(const QSqlRecord& rec)
+    {
+        QList<QPair<QString, int>> columns;
+        for (int i = 0; i < rec.count(); ++i)
+        {
+            const QString name = rec.fieldName(i);
+            const bool seen = std::any_of(columns.cbegin(), columns.cend(),
+                                          [&name](const QPair<QString, int>& column) { return column.first == name; });
+            if (!seen)
+            {
+                columns.append(qMakePair(name, i));
+            }
+        }
+
+        std::sort(columns.begin(), columns.end());
+
+        for (const auto& column : columns)
+        {
+            QByteArray key;
+            AppendString(key, column.first);
+            key.append(':');
+            keys.append(qMakePair(column.second, key));
+        }
+    }
+
+    static void AppendValue(QByteArray& out, const QVariant& val)
+    {
+        if (val.isNull())
+        {
+            out.append("null");
+        }
+        else if (val.type() == QVariant::Int)
+        {
+            out.append(QByteArray::number(val.toInt()));
+        }
+        else if (val.type() == QVariant::Double)
+        {
+            const double number = val.toDouble();
+            out.append(qIsFinite(number) ? QByteArray::number(number, 'g', QLocale::FloatingPointShortest)
+                                         : QByteArray("null"));
+        }
+        else if (val.type() == QVariant::Bool)
+        {
+            out.append(val.toBool() ? "true" : "false");
+        }
+        else if (val.type() == QVariant::Date)
+        {
+            AppendString(out, val.toDate().toString(Qt::ISODate));
+        }
+        else if (val.type() == QVariant::DateTime)
+        {
+            AppendString(out, val.toDateTime().toString(Qt::ISODate));
+        }
+        else
+        {
+            AppendString(out, val.toString());
+        }
+    }
+
+    void Write(const QByteArray& data)
+    {
+        if (ok && device->write(data) != data.size())
+        {
+            ok = false;
+        }
+    }
+
+    QIODevice* device;
+    QList<QPair<int, QByteArray>> keys;
+    QByteArray buffer;
+    int row_count = 0;
+    bool ok = true;
+};
+
+#endif // Q1JSONWRITER_H
@@ -0,0 +1,83 @@
+#ifndef Q1PROJECTION_H
+#define Q1PROJECTION_H
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QVariant>
+#include <QtSql/QSqlQuery>
+
+template <typename> class Q1Projection;
+
+// --- Trait to detect a static ConfigureProjection(Q1Projection<Dto>&) ---
+template <typename T, typename = void>
+struct has_configureprojection_method : std::false_type {};
+
+template <typename T>
+struct has_configureprojection_method<T, std::void_t<
+                                             decltype(T::ConfigureProjection(std::declval<Q1Projection<T>&>()))
+                                             >> : std::true_type {};
+
+// Column list of a DTO read by Q1Query::Project<Dto>(). The DTO declares it the
+// same way entities declare their properties:
+//
+//   struct CityName
+//   {
+//       int id = 0;
+//       QString name;
+//
+//       static void ConfigureProjection(Q1Projection<CityName>& projection)
+//       {
+//           projection.Property(&CityName::id, "id");
+//           projection.Property(&CityName::name, "name");
+//       }
+//   };
+template <typename Dto>
+class Q1Projection
+{
+public:
+    // column is a column of the queried table or any select expression
+    template<typename Member>
+    void Property(Member Dto::* member, const QString& column)
+    {
+        columns.append(column);
+        setters.append([member](Dto& dto, const QVariant& value) {
+            dto.*member = FromVariant<Member>(value);
+        });
+    }
+
+    const QStringList& GetColumns() const
+    {
+        return columns;
+    }
+
+    // Reads the current row; values are expected in GetColumns() order
+    Dto Read(const QSqlQuery& sql_query) const
+    {
+        Dto dto{};
+        for (int i = 0; i < setters.size(); ++i)
+        {
+            setters[i](dto, sql_query.value(i));
+        }
+        return dto;
+    }
+
+    template<typename T>
+    static T FromVariant(const QVariant& value)
+    {
+        if (value.isNull())
+        {
+            return T();
+        }
+        return value.value<T>();
+    }
+
+private:
+    QStringList columns;
+    QList<std::function<void(Dto&, const QVariant&)>> setters;
+};
+
+#endif // Q1PROJECTION_H
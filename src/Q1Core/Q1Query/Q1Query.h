@@ -2,15 +2,27 @@
 #include "Q1Core/Q1Entity/Q1Relation.h"
 #include "Q1Core/Q1Entity/Q1Table.h"
 #include <algorithm>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 #include <QString>
 #include <QList>
 #include <QDebug>
 #include <QMap>
+#include <QHash>
+#include <QIODevice>
+#include <QVariantMap>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QFuture>
+#include <QSharedPointer>
+#include <QtConcurrent/QtConcurrentRun>
 #include <Q1Core/Q1Entity/Q1Column.h>
+#include <Q1Core/Q1Query/Q1Projection.h>
+#include <Q1Core/Q1Query/Q1JsonWriter.h>
+#include <Q1Core/Q1Async/Q1Executor.h>
+#include <Q1Core/Q1Diagnostics/Q1QueryCounter.h>
 
 template<typename Entity> class Q1Entity; // forward declaration
 
@@ -121,7 +133,7 @@ class Q1Query
 {
 public:
     explicit Q1Query(Q1Entity<Entity>* repo = nullptr)
-        : repository(repo), limit_val(-1), distinct_flag(false) {}
+        : repository(repo), limit_val(-1), distinct_flag(false), server_json(false) {}
 
     // Aggregate functions
     template<typename T = double>
@@ -255,6 +267,15 @@ public:
         return *this;
     }
 
+    // ToJson() / WriteJson() let the database build the document, Include() relations
+    // included (json_agg on PostgreSQL, FOR JSON PATH on SQL Server). The result is
+    // compact and keeps the database's key order. Other drivers use the client path.
+    Q1Query& ServerJson(bool enabled = true)
+    {
+        server_json = enabled;
+        return *this;
+    }
+
     Q1Query& SetColumns(const QStringList& columns)
     {
         selected_columns = columns;
@@ -379,13 +400,477 @@ public:
 
     QByteArray ToJson()
     {
-        if (results.isEmpty())
+        if (!repository)
+        {
+            return QByteArray();
+        }
+
+        if (UsesServerJson())
+        {
+            return FetchServerJson();
+        }
+
+        QJsonDocument doc(BuildJsonArray());
+        return doc.toJson(QJsonDocument::Indented);
+    }
+
+    // Streams the result as compact JSON, row by row, without building QJsonObjects.
+    // Queries with Include() fall back to ToJson()'s in-memory path.
+    bool WriteJson(QIODevice* device)
+    {
+        if (!repository || !device)
+        {
+            return false;
+        }
+
+        if (UsesServerJson())
+        {
+            const QByteArray json = FetchServerJson();
+            return !json.isEmpty() && device->write(json) == json.size();
+        }
+
+        if (!included_relations.isEmpty())
+        {
+            const QByteArray json = QJsonDocument(BuildJsonArray()).toJson(QJsonDocument::Compact);
+            return device->write(json) == json.size();
+        }
+
+        Q1JsonWriter writer(device);
+        writer.BeginArray();
+        const bool success = repository->ForEachRow(ToSql(), [&writer](const QSqlQuery& sql_query) {
+            writer.WriteRow(sql_query);
+        }, true);
+        writer.EndArray();
+
+        return success && writer.IsOk();
+    }
+
+    // Projections read only the requested columns into a compact type instead of
+    // hydrating full entities:
+    //   query.Project<std::tuple<int, QString>>(&City::id, &City::name)
+    //   query.Project<CityName>(&City::id, &City::name)   // CityName{id, name}
+    //   query.Project<CityName>()                         // CityName::ConfigureProjection
+    template<typename Result, typename... Fields>
+    QList<Result> Project(Fields Entity::*... members)
+    {
+        QList<Result> rows;
+        if (!repository)
+        {
+            return rows;
+        }
+
+        if constexpr (sizeof...(Fields) == 0)
+        {
+            static_assert(has_configureprojection_method<Result>::value,
+                          "Project<Dto>() needs a static Dto::ConfigureProjection(Q1Projection<Dto>&)");
+
+            Q1Projection<Result> projection;
+            Result::ConfigureProjection(projection);
+
+            repository->ForEachRow(ProjectionSql(projection.GetColumns()), [&](const QSqlQuery& sql_query) {
+                rows.append(projection.Read(sql_query));
+            }, true);
+        }
+        else
+        {
+            const QStringList columns = {repository->ColumnName(members)...};
+            if (columns.contains(QString()))
+            {
+                qWarning() << "Project(): every member must be mapped with Property() on" << repository->GetTable().table_name;
+                return rows;
+            }
+
+            repository->ForEachRow(ProjectionSql(columns), [&](const QSqlQuery& sql_query) {
+                rows.append(std::make_from_tuple<Result>(
+                    ReadTuple<std::tuple<Fields...>>(sql_query, std::index_sequence_for<Fields...>())));
+            }, true);
+        }
+
+        return rows;
+    }
+
+    // Set-based terminals: one UPDATE / DELETE for every row this query matches,
+    // without loading entities. Return the affected row count, or -1 on error.
+    int ExecuteUpdate(const QVariantMap& values)
+    {
+        if (!repository)
+        {
+            return -1;
+        }
+
+        results.clear();
+        return repository->UpdateWhere(values, TargetWhereClause());
+    }
+
+    int ExecuteDelete()
+    {
+        if (!repository)
+        {
+            return -1;
+        }
+
+        results.clear();
+        return repository->DeleteWhere(TargetWhereClause());
+    }
+
+    // SQL text of this query, as ToList() would run it (without Includes)
+    QString ToSql() const
+    {
+        if (!repository)
+        {
+            return QString();
+        }
+
+        return repository->BuildSelectSql(where_clause,
+                                          order_by,
+                                          limit_val,
+                                          joins,
+                                          selected_columns,
+                                          group_by,
+                                          having_clause);
+    }
+
+    // SQL text of an aggregate over this query; the value is selected as __agg
+    QString ToAggregateSql(const QString& function) const
+    {
+        if (!repository)
+        {
+            return QString();
+        }
+
+        QString selectExpr = function;
+        if (distinct_flag)
+        {
+            int paren = selectExpr.indexOf('(');
+            if (paren >= 0)
+            {
+                selectExpr.insert(paren + 1, "DISTINCT ");
+            }
+            else
+            {
+                selectExpr = "DISTINCT " + selectExpr;
+            }
+        }
+
+        QString sql = QString("SELECT %1 AS __agg FROM %2")
+                          .arg(selectExpr, repository->QuoteIdentifier(repository->GetTable().table_name));
+
+        if (!joins.isEmpty())
+        {
+            sql += " " + joins;
+        }
+        if (!where_clause.isEmpty())
         {
-            if (!repository)
+            sql += " WHERE " + where_clause;
+        }
+        if (!group_by.isEmpty())
+        {
+            sql += " GROUP BY " + group_by;
+        }
+        if (!having_clause.isEmpty())
+        {
+            sql += " HAVING " + having_clause;
+        }
+
+        return sql;
+    }
+
+    // SQL text of one PostgreSQL JSON array of this query's rows, in OrderBy() order.
+    // BIGINT columns are text in it: a JSON number is read back as a double, which
+    // drops digits past 2^53.
+    QString ToJsonArraySql() const
+    {
+        if (!repository)
+        {
+            return QString();
+        }
+
+        const Q1Table table = repository->GetTable();
+        const QString alias = repository->QuoteIdentifier(table.table_name);
+        const QString base = repository->BuildSelectSql(where_clause,
+                                                        order_by,
+                                                        limit_val,
+                                                        joins,
+                                                        selected_columns.isEmpty() ? QStringList{alias + ".*"}
+                                                                                   : selected_columns,
+                                                        group_by,
+                                                        having_clause);
+
+        QStringList exact;
+        for (const Q1Column& col : table.columns)
+        {
+            const QString column = repository->QuoteIdentifier(col.name);
+            const bool selected = selected_columns.isEmpty()
+                                  || selected_columns.contains(col.name)
+                                  || selected_columns.contains(column)
+                                  || selected_columns.contains(alias + "." + column);
+            if (col.type == BIGINT && selected)
             {
-                return QByteArray();
+                exact << QString("'%1', %2.%3::text").arg(col.name, alias, column);
             }
+        }
+
+        QString row = QString("to_jsonb(%1.*)").arg(alias);
+        if (!exact.isEmpty())
+        {
+            row += " || jsonb_build_object(" + exact.join(", ") + ")";
+        }
+
+        // The aggregate sorts its rows itself; the subquery's ORDER BY does not survive it
+        return QString("SELECT COALESCE(jsonb_agg(%1%2), '[]'::jsonb) FROM (%3) AS %4")
+            .arg(row, order_by.isEmpty() ? QString() : " ORDER BY " + order_by, base, alias);
+    }
+
+    // Scalar result of an aggregate query as T (T() for NULL)
+    template<typename T>
+    static T ConvertAggregate(const QVariant& result)
+    {
+        if (!result.isValid() || result.isNull())
+        {
+            return T();
+        }
 
+        if constexpr (std::is_same_v<T, int>)
+        {
+            return static_cast<T>(result.toInt());
+        }
+        else if constexpr (std::is_same_v<T, qint64>)
+        {
+            return static_cast<T>(result.toLongLong());
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            return static_cast<T>(result.toDouble());
+        }
+        else
+        {
+            return result.value<T>();
+        }
+    }
+
+    Q1Entity<Entity>* GetRepository() const
+    {
+        return repository;
+    }
+
+    bool HasIncludes() const
+    {
+        return !included_relations.isEmpty();
+    }
+
+    // Returns rows with an array named relationName added to each, holding the
+    // related rows whose relatedColumn equals the row's localColumn. Used by Include().
+    // Related rows are grouped by key first, so the cost is linear in rows + related rows.
+    static QJsonArray StitchRelation(const QJsonArray& rows,
+                                     const QString& relationName,
+                                     const QString& localColumn,
+                                     const QString& relatedColumn,
+                                     const QList<QJsonObject>& relatedData)
+    {
+        QHash<QString, QJsonArray> groups;
+        for (const QJsonObject& related : relatedData)
+        {
+            groups[related[relatedColumn].toVariant().toString()].append(related);
+        }
+
+        QJsonArray result;
+        for (const QJsonValue& row : rows)
+        {
+            QJsonObject obj = row.toObject();
+            obj.insert(relationName, groups.value(obj[localColumn].toVariant().toString()));
+            result.append(obj);
+        }
+
+        return result;
+    }
+
+    // Async terminals: the query and its entity set are copied on the calling
+    // thread and executed on Q1Executor's pool. Continue on the caller's thread
+    // with a QFutureWatcher (or QFuture::then with a context object on Qt 6).
+    // The result carries the pool thread's error next to the value.
+    QFuture<Q1AsyncResult<QList<Entity>>> ToListAsync() const
+    {
+        return RunAsync([](Q1Query<Entity>& query) { return query.ToList(); });
+    }
+
+    QFuture<Q1AsyncResult<QByteArray>> ToJsonAsync() const
+    {
+        return RunAsync([](Q1Query<Entity>& query) { return query.ToJson(); });
+    }
+
+    template<typename T = double>
+    QFuture<Q1AsyncResult<T>> MaxAsync(const QString& column) const
+    {
+        return RunAsync([column](Q1Query<Entity>& query) { return query.template Max<T>(column); });
+    }
+
+    template<typename T = double>
+    QFuture<Q1AsyncResult<T>> MinAsync(const QString& column) const
+    {
+        return RunAsync([column](Q1Query<Entity>& query) { return query.template Min<T>(column); });
+    }
+
+    template<typename T = int>
+    QFuture<Q1AsyncResult<T>> CountAsync(const QString& column = "*") const
+    {
+        return RunAsync([column](Q1Query<Entity>& query) { return query.template Count<T>(column); });
+    }
+
+    template<typename T = double>
+    QFuture<Q1AsyncResult<T>> SumAsync(const QString& column) const
+    {
+        return RunAsync([column](Q1Query<Entity>& query) { return query.template Sum<T>(column); });
+    }
+
+    template<typename T = double>
+    QFuture<Q1AsyncResult<T>> AvgAsync(const QString& column) const
+    {
+        return RunAsync([column](Q1Query<Entity>& query) { return query.template Avg<T>(column); });
+    }
+
+private:
+    template<typename Function>
+    auto RunAsync(Function function) const -> QFuture<Q1AsyncResult<decltype(function(std::declval<Q1Query<Entity>&>()))>>
+    {
+        using Result = Q1AsyncResult<decltype(function(std::declval<Q1Query<Entity>&>()))>;
+
+        if (!repository)
+        {
+            return QtConcurrent::run(Q1Executor::Pool(), []() {
+                Result result;
+                result.error = "Query has no entity set";
+                return result;
+            });
+        }
+
+        const Q1Query<Entity> snapshot = *this;
+        const QSharedPointer<Q1Entity<Entity>> repositorySnapshot(new Q1Entity<Entity>(*repository));
+        const Qt::HANDLE scopeThread = Q1QueryCounter::ScopeThread();
+
+        return QtConcurrent::run(Q1Executor::Pool(), [snapshot, repositorySnapshot, function, scopeThread]() {
+            const Q1QueryScopeHandoff handoff(scopeThread);
+            repositorySnapshot->BindToCurrentThread();
+
+            Q1Query<Entity> query = snapshot;
+            query.repository = repositorySnapshot.data();
+
+            Result result;
+            result.value = function(query);
+            result.error = repositorySnapshot->GetLastError();
+            return result;
+        });
+    }
+
+    bool UsesServerJson() const
+    {
+        return server_json && (repository->UsesPostgreSql() || repository->UsesSqlServer());
+    }
+
+    // SQL Server splits FOR JSON output over several rows
+    QByteArray FetchServerJson()
+    {
+        QByteArray json;
+        const bool success = repository->ForEachRow(ServerJsonSql(), [&json](const QSqlQuery& sql_query) {
+            json += sql_query.value(0).toString().toUtf8();
+        }, true);
+
+        if (!success)
+        {
+            return QByteArray();
+        }
+
+        return json.isEmpty() ? QByteArray("[]") : json;
+    }
+
+    // The query becomes a derived table aliased as the queried table; each Include()
+    // adds a correlated subquery that aggregates the related rows into an array.
+    QString ServerJsonSql() const
+    {
+        const Q1Table table = repository->GetTable();
+        const bool sqlServer = repository->UsesSqlServer();
+        const QString alias = repository->QuoteIdentifier(table.table_name);
+
+        QStringList columns;
+        columns << alias + ".*";
+
+        for (const QString& relationName : included_relations)
+        {
+            const Q1Relation* relation = nullptr;
+            for (const Q1Relation& rel : table.relations)
+            {
+                if (rel.top_table == relationName)
+                {
+                    relation = &rel;
+                    break;
+                }
+            }
+
+            if (!relation)
+            {
+                continue;
+            }
+
+            const bool relationUsesLocalForeignKey = table.HasColumn(relation->foreign_key);
+            const QString localColumn = relationUsesLocalForeignKey ? relation->foreign_key : relation->reference_key;
+            const QString relatedColumn = relationUsesLocalForeignKey ? relation->reference_key : relation->foreign_key;
+
+            const QString related = QString("FROM %1 AS q1_rel WHERE q1_rel.%2 = %3.%4")
+                                        .arg(repository->QuoteIdentifier(relation->top_table),
+                                             repository->QuoteIdentifier(relatedColumn),
+                                             alias,
+                                             repository->QuoteIdentifier(localColumn));
+
+            if (sqlServer)
+            {
+                columns << QString("JSON_QUERY(ISNULL((SELECT q1_rel.* %1 FOR JSON PATH, INCLUDE_NULL_VALUES), '[]')) AS %2")
+                               .arg(related, repository->QuoteIdentifier(relationName));
+            }
+            else
+            {
+                columns << QString("(SELECT COALESCE(json_agg(q1_rel), '[]'::json) %1) AS %2")
+                               .arg(related, repository->QuoteIdentifier(relationName));
+            }
+        }
+
+        // A derived table must not repeat a column name, so with Join() only the queried
+        // table's columns are read; otherwise the relation subqueries become ambiguous
+        const QStringList baseColumns = selected_columns.isEmpty() ? QStringList{alias + ".*"} : selected_columns;
+
+        if (sqlServer)
+        {
+            // A derived table may only be ordered together with TOP
+            const bool orderInside = limit_val > 0;
+            const QString base = repository->BuildSelectSql(where_clause,
+                                                            orderInside ? order_by : QString(),
+                                                            limit_val,
+                                                            joins,
+                                                            baseColumns,
+                                                            group_by,
+                                                            having_clause);
+
+            QString sql = QString("SELECT %1 FROM (%2) AS %3").arg(columns.join(", "), base, alias);
+            if (!orderInside && !order_by.isEmpty())
+            {
+                sql += " ORDER BY " + order_by;
+            }
+            return sql + " FOR JSON PATH, INCLUDE_NULL_VALUES";
+        }
+
+        // An aggregate does not keep the order of its input rows, so it sorts them itself.
+        // The outer row set carries the table's name, so qualified order terms still resolve.
+        return QString("SELECT COALESCE(json_agg(%1.*%2), '[]'::json) FROM (SELECT %3 FROM (%4) AS %1) AS %1")
+            .arg(alias,
+                 order_by.isEmpty() ? QString() : " ORDER BY " + order_by,
+                 columns.join(", "),
+                 repository->BuildSelectSql(where_clause, order_by, limit_val, joins,
+                                            baseColumns, group_by, having_clause));
+    }
+
+    // Result rows (with included relations) as sorted-key JSON objects
+    QJsonArray BuildJsonArray()
+    {
+        if (results.isEmpty())
+        {
             results = repository->SelectExec(where_clause,
                                              order_by,
                                              limit_val,
@@ -407,12 +892,90 @@ public:
             array = AppendRelatedDataToJson(array);
         }
 
-        QJsonArray sortedArray = SortJsonKeys(array);
-        QJsonDocument doc(sortedArray);
-        return doc.toJson(QJsonDocument::Indented);
+        return SortJsonKeys(array);
+    }
+
+    // Columns of the queried table are qualified so they stay unambiguous with joins
+    QString ProjectionSql(const QStringList& columns) const
+    {
+        const Q1Table table = repository->GetTable();
+        QStringList select;
+        for (const QString& column : columns)
+        {
+            if (table.HasColumn(column))
+            {
+                select.append(repository->QuoteIdentifier(table.table_name) + "." + repository->QuoteIdentifier(column));
+            }
+            else
+            {
+                select.append(column);
+            }
+        }
+
+        return repository->BuildSelectSql(where_clause,
+                                          order_by,
+                                          limit_val,
+                                          joins,
+                                          select,
+                                          group_by,
+                                          having_clause);
+    }
+
+    template<typename Tuple, std::size_t... I>
+    static Tuple ReadTuple(const QSqlQuery& sql_query, std::index_sequence<I...>)
+    {
+        return Tuple(Q1Projection<Entity>::template FromVariant<std::tuple_element_t<I, Tuple>>(
+            sql_query.value(static_cast<int>(I)))...);
+    }
+
+    // UPDATE / DELETE only address one table, so joins and limits are applied
+    // through a primary key subquery.
+    QString TargetWhereClause() const
+    {
+        if (where_clause.isEmpty() || (joins.isEmpty() && limit_val <= 0))
+        {
+            return where_clause;
+        }
+
+        const Q1Table table = repository->GetTable();
+        const QList<Q1Column> keys = table.GetPrimaryKeys();
+        if (keys.isEmpty())
+        {
+            qWarning() << "Joins and Limit() in a set-based update/delete need a primary key on" << table.table_name;
+            return QString();
+        }
+
+        const QString target = repository->QuoteIdentifier(table.table_name);
+        QStringList key_columns;
+        for (const Q1Column& key : keys)
+        {
+            key_columns << target + "." + repository->QuoteIdentifier(key.name);
+        }
+
+        // SQL Server only orders a subquery together with TOP
+        const QString subquery = repository->BuildSelectSql(where_clause,
+                                                            limit_val > 0 ? order_by : QString(),
+                                                            limit_val,
+                                                            joins,
+                                                            key_columns);
+
+        if (keys.size() == 1)
+        {
+            return QString("%1 IN (%2)").arg(repository->QuoteIdentifier(keys.first().name), subquery);
+        }
+
+        // A composite key must match on every column, or rows that share the first one
+        // are hit too. SQL Server has no row-value IN, so the key set is correlated instead.
+        QStringList matches;
+        for (const Q1Column& key : keys)
+        {
+            const QString column = repository->QuoteIdentifier(key.name);
+            matches << QString("q1_target.%1 = %2.%1").arg(column, target);
+        }
+
+        return QString("EXISTS (SELECT 1 FROM (%1) AS q1_target WHERE %2)").arg(subquery, matches.join(" AND "));
     }
 
-private:
     // Helper methods
     QJsonArray AutoPrefixJoinedColumns(const QJsonArray& array)
     {
@@ -639,62 +1202,8 @@ private:
             return T();
         }
 
-        QString selectExpr = function;
-        if (distinct_flag)
-        {
-            int paren = selectExpr.indexOf('(');
-            if (paren >= 0)
-            {
-                selectExpr.insert(paren + 1, "DISTINCT ");
-            }
-            else
-            {
-                selectExpr = "DISTINCT " + selectExpr;
-            }
-        }
-
-        QString sql = QString("SELECT %1 AS __agg FROM %2")
-                          .arg(selectExpr, repository->QuoteIdentifier(repository->GetTable().table_name));
-
-        if (!joins.isEmpty())
-        {
-            sql += " " + joins;
-        }
-        if (!where_clause.isEmpty())
-        {
-            sql += " WHERE " + where_clause;
-        }
-        if (!group_by.isEmpty())
-        {
-            sql += " GROUP BY " + group_by;
-        }
-        if (!having_clause.isEmpty())
-        {
-            sql += " HAVING " + having_clause;
-        }
-
-        QVariant result = repository->ExecuteScalar(sql);
-        if (!result.isValid() || result.isNull())
-        {
-            return T();
-        }
-
-        if constexpr (std::is_same_v<T, int>)
-        {
-            return static_cast<T>(result.toInt());
-        }
-        else if constexpr (std::is_same_v<T, qint64>)
-        {
-            return static_cast<T>(result.toLongLong());
-        }
-        else if constexpr (std::is_floating_point_v<T>)
-        {
-            return static_cast<T>(result.toDouble());
-        }
-        else
-        {
-            return result.value<T>();
-        }
+        QVariant result = repository->ExecuteScalar(ToAggregateSql(function), true);
+        return ConvertAggregate<T>(result);
     }
 
     void LoadRelatedData(QList<Entity>& entities)
@@ -811,59 +1320,39 @@ private:
     QJsonArray AppendRelatedDataToJson(const QJsonArray& originalArray)
     {
         QJsonArray result = originalArray;
+        const Q1Table& table = repository->GetTable();
 
-        for (int i = 0; i < result.size(); ++i)
+        for (const auto& relationName : included_relations)
         {
-            QJsonObject obj = result[i].toObject();
+            if (!relation_cache.contains(relationName))
+            {
+                continue;
+            }
 
-            for (const auto& relationName : included_relations)
+            const Q1Relation* matchingRelation = nullptr;
+            for (const Q1Relation& rel : table.relations)
             {
-                if (relation_cache.contains(relationName))
+                if (rel.top_table == relationName)
                 {
-                    QList<QJsonObject> relatedData = relation_cache[relationName];
-
-                    const Q1Table& table = repository->GetTable();
-                    const Q1Relation* matchingRelation = nullptr;
-
-                    for (const Q1Relation& rel : table.relations)
-                    {
-                        if (rel.top_table == relationName)
-                        {
-                            matchingRelation = &rel;
-                            break;
-                        }
-                    }
-
-                    if (!matchingRelation)
-                    {
-                        continue;
-                    }
-
-                    const bool relationUsesLocalForeignKey = repository->GetTable().HasColumn(matchingRelation->foreign_key);
-                    const QString localColumn = relationUsesLocalForeignKey
-                                                    ? matchingRelation->foreign_key
-                                                    : matchingRelation->reference_key;
-                    const QString relatedColumn = relationUsesLocalForeignKey
-                                                      ? matchingRelation->reference_key
-                                                      : matchingRelation->foreign_key;
-                    const QString localValue = obj[localColumn].toVariant().toString();
-
-                    QJsonArray relatedArray;
-                    for (const QJsonObject& related : relatedData)
-                    {
-                        QString relatedValue = related[relatedColumn].toVariant().toString();
-
-                        if (localValue == relatedValue)
-                        {
-                            relatedArray.append(related);
-                        }
-                    }
-
-                    obj.insert(relationName, relatedArray);
+                    matchingRelation = &rel;
+                    break;
                 }
             }
 
-            result[i] = obj;
+            if (!matchingRelation)
+            {
+                continue;
+            }
+
+            const bool relationUsesLocalForeignKey = table.HasColumn(matchingRelation->foreign_key);
+            const QString localColumn = relationUsesLocalForeignKey
+                                            ? matchingRelation->foreign_key
+                                            : matchingRelation->reference_key;
+            const QString relatedColumn = relationUsesLocalForeignKey
+                                              ? matchingRelation->reference_key
+                                              : matchingRelation->foreign_key;
+
+            result = StitchRelation(result, relationName, localColumn, relatedColumn, relation_cache[relationName]);
         }
 
         return result;
@@ -880,6 +1369,7 @@ private:
     int limit_val;
     QList<Entity> results;
     bool distinct_flag;
+    bool server_json;
     QStringList included_relations;
     QMap<QString, QList<QJsonObject>> relation_cache;
 };
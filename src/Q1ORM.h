@@ -8,6 +8,11 @@
 #include "Q1Core/Q1Context/Q1Context.h"
 #include "Q1Core/Q1Entity/Q1Entity.h"
 #include "Q1Core/Q1Query/Q1Query.h"
+#include "Q1Core/Q1Query/Q1Batch.h"
+#include "Q1Core/Q1Async/Q1Task.h"
+#include "Q1Core/Q1Mock/Q1MockDriver.h"
+#include "Q1Core/Q1Diagnostics/Q1Metrics.h"
+#include "Q1Core/Q1Diagnostics/Q1QueryCounter.h"
 #include "Q1DatabaseInstall/Q1DatabaseInstall.h"
 
 template<typename Entity>